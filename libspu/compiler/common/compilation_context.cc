@@ -37,11 +37,36 @@ CompilationContext::CompilationContext(CompilerOptions options)
         options_.pretty_print_dump_dir());
   }
 
+  setupThreading();
+
+  if (options_.enable_pass_timing()) {
+    timing_manager_.setEnabled(true);
+    timing_manager_.setDisplayMode(
+        mlir::DefaultTimingManager::DisplayMode::List);
+    timing_scope_ = timing_manager_.getRootScope();
+  }
+
   // Set an error handler
   llvm::remove_fatal_error_handler();
   llvm::install_fatal_error_handler(SPUErrorHandler);
 }
 
+void CompilationContext::setupThreading() {
+  const auto num_threads = options_.compiler_threads();
+  SPU_ENFORCE(num_threads >= 0, "invalid compiler_threads = {}", num_threads);
+
+  if (num_threads == 1) {
+    context_.disableMultithreading();
+  } else if (num_threads > 1) {
+    thread_pool_ = std::make_unique<llvm::DefaultThreadPool>(
+        llvm::hardware_concurrency(num_threads));
+    // An external thread pool could only be set on a single-threaded context.
+    context_.disableMultithreading();
+    context_.setThreadPool(*thread_pool_);
+  }
+  // Otherwise the context owns a pool with one thread per hardware thread.
+}
+
 CompilationContext::~CompilationContext() {
   llvm::remove_fatal_error_handler();
 }
@@ -62,6 +87,12 @@ void CompilationContext::setupPrettyPrintConfigurations(mlir::PassManager *pm) {
   }
 }
 
+void CompilationContext::setupTimingConfigurations(mlir::PassManager *pm) {
+  if (options_.enable_pass_timing()) {
+    pm->enableTiming(timing_scope_);
+  }
+}
+
 std::filesystem::path CompilationContext::getPrettyPrintDir() const {
   SPU_ENFORCE(hasPrettyPrintEnabled());
   return static_cast<const mlir::pphlo::IRPrinterConfig *>(pp_config_.get())
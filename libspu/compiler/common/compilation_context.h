@@ -17,8 +17,10 @@
 #include <filesystem>
 #include <memory>
 
+#include "llvm/Support/ThreadPool.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Support/Timing.h"
 
 #include "libspu/spu.pb.h"
 
@@ -39,6 +41,10 @@ class CompilationContext {
   /// Setup pretty print for a pass manager
   void setupPrettyPrintConfigurations(mlir::PassManager *pm);
 
+  /// Setup per-pass timing for a pass manager, the report of all pass managers
+  /// is printed when this context is destroyed
+  void setupTimingConfigurations(mlir::PassManager *pm);
+
   const CompilerOptions &getCompilerOptions() const { return options_; }
 
   bool hasPrettyPrintEnabled() const { return options_.enable_pretty_print(); }
@@ -53,7 +59,14 @@ class CompilationContext {
   std::unique_ptr<mlir::PassManager::IRPrinterConfig>
   getIRPrinterConfig() const;
 
+  void setupThreading();
+
+  // Declared before context_, the pool must outlive the context using it.
+  std::unique_ptr<llvm::ThreadPoolInterface> thread_pool_;
   mlir::MLIRContext context_;
+
+  mlir::DefaultTimingManager timing_manager_;
+  mlir::TimingScope timing_scope_;
   std::unique_ptr<mlir::PassManager::IRPrinterConfig> pp_config_;
 
   const CompilerOptions options_;
@@ -14,6 +14,7 @@
 
 #include "libspu/compiler/common/ir_printer_config.h"
 
+#include <atomic>
 #include <chrono>
 
 #include "fmt/chrono.h" // IWYU pragma: keep, format chrono needs this header
@@ -25,7 +26,7 @@
 namespace mlir::pphlo {
 
 /// PP counter, this is a session persistent
-static std::int64_t pp_cnt = 0;
+static std::atomic<std::int64_t> pp_cnt = 0;
 
 IRPrinterConfig::IRPrinterConfig(std::string_view pp_dir)
     : PassManager::IRPrinterConfig(/*printModuleScope*/ true,
@@ -32,6 +32,7 @@ void Core::doit(mlir::ModuleOp module) {
   buildPipeline(&pm);
 
   ctx_->setupPrettyPrintConfigurations(&pm);
+  ctx_->setupTimingConfigurations(&pm);
 
   auto ret = pm.run(module);
 
@@ -50,6 +51,10 @@ void Core::buildPipeline(mlir::PassManager *pm) {
     optPM.addPass(mlir::createCSEPass());
     optPM.addPass(mlir::spu::pphlo::createOptimizeMaxPoolingPass());
   }
+  // Must run before decompose-ops rewrites subtract and max
+  if (!options.disable_softmax_optimization()) {
+    optPM.addPass(mlir::spu::pphlo::createOptimizeSoftmax());
+  }
   optPM.addPass(mlir::spu::pphlo::createDecomposeOps());
   optPM.addPass(mlir::spu::pphlo::createSortLowering());
 
@@ -97,6 +102,10 @@ void Core::buildPipeline(mlir::PassManager *pm) {
   optPM.addPass(mlir::spu::pphlo::createRegionAccessFixture());
   optPM.addPass(mlir::createCSEPass());
 
+  if (options.enable_bitwidth_inference()) {
+    optPM.addPass(mlir::spu::pphlo::createInferBitwidthPass());
+  }
+
   if (!options.disable_deallocation_insertion()) {
     optPM.addPass(mlir::spu::pphlo::createInsertDeallocationOp());
   }
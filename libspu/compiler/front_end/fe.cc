@@ -92,6 +92,7 @@ mlir::OwningOpRef<mlir::ModuleOp> FE::doit(const CompilationSource &source) {
   buildFrontEndPipeline(&pm, input_vis_str);
 
   ctx_->setupPrettyPrintConfigurations(&pm);
+  ctx_->setupTimingConfigurations(&pm);
 
   auto ret = pm.run(module.get());
 
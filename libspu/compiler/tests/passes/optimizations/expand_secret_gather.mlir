@@ -7,8 +7,30 @@ func.func @main(%arg0: tensor<2xi32>, %arg1: tensor<1x!pphlo.secret<i32>>) -> (t
 }
 // -----
 func.func @main(%arg0: tensor<3x3xi32>, %arg1: tensor<2x!pphlo.secret<i32>>) -> (tensor<2x3x!pphlo.secret<i32>>) {
-     //CHECK-NOT: spu.gather
-    //CHECK : pphlo.while
+    //CHECK-NOT: spu.gather
+    //CHECK: pphlo.custom_call @spu.row_gather(%arg0, %{{.*}}) : (tensor<3x3xi32>, tensor<2x!pphlo.secret<i32>>) -> tensor<2x3x!pphlo.secret<i32>>
    %0 = pphlo.custom_call @spu.gather(%arg0, %arg1) {pphlo.attributes = {offset_dims = array<i64: 1>, collapsed_slice_dims = array<i64: 0>, start_index_map = array<i64: 0>, index_vector_dim = 1 : i64, slice_sizes = array<i64: 1, 3>}} : (tensor<3x3xi32>, tensor<2x!pphlo.secret<i32>>) -> tensor<2x3x!pphlo.secret<i32>>
     return %0 : tensor<2x3x!pphlo.secret<i32>>
-}
\ No newline at end of file
+}
+// -----
+func.func @main(%arg0: tensor<100x4xf32>, %arg1: tensor<2x3x1x!pphlo.secret<i32>>) -> (tensor<2x3x4x!pphlo.secret<f32>>) {
+    //CHECK: %[[IDX:.*]] = pphlo.reshape %arg1 : (tensor<2x3x1x!pphlo.secret<i32>>) -> tensor<6x!pphlo.secret<i32>>
+    //CHECK: %[[ROWS:.*]] = pphlo.custom_call @spu.row_gather(%arg0, %[[IDX]]) : (tensor<100x4xf32>, tensor<6x!pphlo.secret<i32>>) -> tensor<6x4x!pphlo.secret<f32>>
+    //CHECK: pphlo.reshape %[[ROWS]] : (tensor<6x4x!pphlo.secret<f32>>) -> tensor<2x3x4x!pphlo.secret<f32>>
+   %0 = pphlo.custom_call @spu.gather(%arg0, %arg1) {pphlo.attributes = {offset_dims = array<i64: 2>, collapsed_slice_dims = array<i64: 0>, start_index_map = array<i64: 0>, index_vector_dim = 2 : i64, slice_sizes = array<i64: 1, 4>}} : (tensor<100x4xf32>, tensor<2x3x1x!pphlo.secret<i32>>) -> tensor<2x3x4x!pphlo.secret<f32>>
+    return %0 : tensor<2x3x4x!pphlo.secret<f32>>
+}
+// -----
+func.func @main(%arg0: tensor<3x3xi32>, %arg1: tensor<2x!pphlo.secret<i32>>) -> (tensor<2x2x!pphlo.secret<i32>>) {
+    //CHECK-NOT: spu.row_gather
+    //CHECK: pphlo.while
+   %0 = pphlo.custom_call @spu.gather(%arg0, %arg1) {pphlo.attributes = {offset_dims = array<i64: 1>, collapsed_slice_dims = array<i64: 0>, start_index_map = array<i64: 0>, index_vector_dim = 1 : i64, slice_sizes = array<i64: 1, 2>}} : (tensor<3x3xi32>, tensor<2x!pphlo.secret<i32>>) -> tensor<2x2x!pphlo.secret<i32>>
+    return %0 : tensor<2x2x!pphlo.secret<i32>>
+}
+// -----
+func.func @main(%arg0: tensor<3x2xcomplex<f32>>, %arg1: tensor<2x!pphlo.secret<i32>>) -> (tensor<2x2x!pphlo.secret<complex<f32>>>) {
+    //CHECK-NOT: spu.row_gather
+    //CHECK: pphlo.while
+   %0 = pphlo.custom_call @spu.gather(%arg0, %arg1) {pphlo.attributes = {offset_dims = array<i64: 1>, collapsed_slice_dims = array<i64: 0>, start_index_map = array<i64: 0>, index_vector_dim = 1 : i64, slice_sizes = array<i64: 1, 2>}} : (tensor<3x2xcomplex<f32>>, tensor<2x!pphlo.secret<i32>>) -> tensor<2x2x!pphlo.secret<complex<f32>>>
+    return %0 : tensor<2x2x!pphlo.secret<complex<f32>>>
+}
@@ -0,0 +1,37 @@
+// RUN: spu-opt --infer-bitwidth --split-input-file %s | FileCheck %s
+// RUN: spu-opt --infer-bitwidth --mlir-pass-statistics --split-input-file %s 2>&1 | FileCheck %s --check-prefix=STATS
+
+// STATS: InferBitwidth
+// STATS-DAG: 1 num-narrowed
+// STATS-DAG: 16 numel-narrowed
+// STATS-DAG: 64 bytes-saved-fm64
+// STATS-DAG: 192 bytes-saved-fm128
+
+func.func @main(%arg0: tensor<16x!pphlo.secret<i1>>) -> (tensor<16x!pphlo.secret<i1>>) {
+    %0 = pphlo.iota dim = 0 : tensor<16xi32>
+    %1 = pphlo.constant dense<8> : tensor<16xi32>
+    %2 = pphlo.convert %0 : (tensor<16xi32>) -> tensor<16x!pphlo.secret<i32>>
+    %3 = pphlo.convert %arg0 : (tensor<16x!pphlo.secret<i1>>) -> tensor<16x!pphlo.secret<i32>>
+    %4 = pphlo.add %2, %3 : tensor<16x!pphlo.secret<i32>>
+    // CHECK: pphlo.less %{{.*}}, %{{.*}} {pphlo.bitwidth = 5 : i64}
+    %5 = pphlo.less %4, %1 : (tensor<16x!pphlo.secret<i32>>, tensor<16xi32>) -> tensor<16x!pphlo.secret<i1>>
+    return %5 : tensor<16x!pphlo.secret<i1>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<16x!pphlo.secret<i32>>) -> (tensor<16x!pphlo.secret<i1>>) {
+    %0 = pphlo.constant dense<8> : tensor<16xi32>
+    // CHECK-NOT: pphlo.bitwidth
+    %1 = pphlo.less %arg0, %0 : (tensor<16x!pphlo.secret<i32>>, tensor<16xi32>) -> tensor<16x!pphlo.secret<i1>>
+    return %1 : tensor<16x!pphlo.secret<i1>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<16x!pphlo.secret<f32>>) -> (tensor<16x!pphlo.secret<i1>>) {
+    %0 = pphlo.constant dense<8.0> : tensor<16xf32>
+    // CHECK-NOT: pphlo.bitwidth
+    %1 = pphlo.greater %arg0, %0 : (tensor<16x!pphlo.secret<f32>>, tensor<16xf32>) -> tensor<16x!pphlo.secret<i1>>
+    return %1 : tensor<16x!pphlo.secret<i1>>
+}
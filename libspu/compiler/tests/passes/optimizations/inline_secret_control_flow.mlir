@@ -0,0 +1,50 @@
+// RUN: spu-opt --inline-secret-control-flow --split-input-file %s | FileCheck %s
+
+func.func @main(%arg0: tensor<!pphlo.secret<i1>>, %arg1: tensor<2x!pphlo.secret<f32>>, %arg2: tensor<3xi32>) -> (tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<i32>>) {
+    // CHECK-NOT: pphlo.if
+    // CHECK: %[[SEL:.*]]:2 = pphlo.custom_call @spu.select_n(%arg0, %{{.*}}, %{{.*}}, %arg1, %{{.*}})
+    %0:2 = "pphlo.if"(%arg0) ({
+        %1 = pphlo.add %arg1, %arg1 : tensor<2x!pphlo.secret<f32>>
+        %2 = pphlo.convert %arg2 : (tensor<3xi32>) -> tensor<3x!pphlo.secret<i32>>
+        pphlo.return %1, %2 : tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<i32>>
+    }, {
+        %3 = pphlo.convert %arg2 : (tensor<3xi32>) -> tensor<3x!pphlo.secret<i32>>
+        pphlo.return %arg1, %3 : tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<i32>>
+    }) : (tensor<!pphlo.secret<i1>>) -> (tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<i32>>)
+    // CHECK: return %[[SEL]]#0, %[[SEL]]#1
+    return %0#0, %0#1 : tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<i32>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<!pphlo.secret<i1>>, %arg1: tensor<2x!pphlo.secret<f32>>) -> tensor<2x!pphlo.secret<f32>> {
+    // CHECK: pphlo.select %arg0
+    // CHECK-NOT: pphlo.custom_call
+    %0 = "pphlo.if"(%arg0) ({
+        %1 = pphlo.add %arg1, %arg1 : tensor<2x!pphlo.secret<f32>>
+        pphlo.return %1 : tensor<2x!pphlo.secret<f32>>
+    }, {
+        pphlo.return %arg1 : tensor<2x!pphlo.secret<f32>>
+    }) : (tensor<!pphlo.secret<i1>>) -> tensor<2x!pphlo.secret<f32>>
+    return %0 : tensor<2x!pphlo.secret<f32>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<!pphlo.secret<i32>>, %arg1: tensor<2x!pphlo.secret<f32>>, %arg2: tensor<!pphlo.secret<i32>>) -> (tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>) {
+    // CHECK-NOT: pphlo.case
+    // CHECK: %[[MASK:.*]] = pphlo.equal
+    // CHECK-NOT: pphlo.multiply
+    // CHECK: %[[MUX:.*]]:2 = pphlo.custom_call @spu.multiplex(%[[MASK]], %arg1, %arg2, %{{.*}}, %arg2, %arg1, %{{.*}})
+    %0:2 = "pphlo.case"(%arg0) ({
+        pphlo.return %arg1, %arg2 : tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>
+    }, {
+        %1 = pphlo.add %arg1, %arg1 : tensor<2x!pphlo.secret<f32>>
+        pphlo.return %1, %arg2 : tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>
+    }, {
+        %2 = pphlo.add %arg2, %arg2 : tensor<!pphlo.secret<i32>>
+        pphlo.return %arg1, %2 : tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>
+    }) : (tensor<!pphlo.secret<i32>>) -> (tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>)
+    // CHECK: return %[[MUX]]#0, %[[MUX]]#1
+    return %0#0, %0#1 : tensor<2x!pphlo.secret<f32>>, tensor<!pphlo.secret<i32>>
+}
@@ -0,0 +1,59 @@
+// RUN: spu-opt --optimize-softmax --split-input-file %s | FileCheck %s
+
+func.func @main(%arg0: tensor<2x3x!pphlo.secret<f32>>) -> (tensor<2x3x!pphlo.secret<f32>>) {
+    // CHECK: %[[RET:.*]] = pphlo.custom_call @spu.softmax(%arg0) {pphlo.attributes = {axis = 1 : i64}} : (tensor<2x3x!pphlo.secret<f32>>) -> tensor<2x3x!pphlo.secret<f32>>
+    // CHECK-NOT: pphlo.divide
+    // CHECK: return %[[RET]]
+    %0 = pphlo.constant dense<0xFF800000> : tensor<f32>
+    %1 = pphlo.constant dense<0.000000e+00> : tensor<f32>
+    %2 = pphlo.convert %0 : (tensor<f32>) -> tensor<!pphlo.secret<f32>>
+    %3 = pphlo.reduce(%arg0 init: %2) applies pphlo.maximum across dimensions = [1] : (tensor<2x3x!pphlo.secret<f32>>, tensor<!pphlo.secret<f32>>) -> tensor<2x!pphlo.secret<f32>>
+    %4 = pphlo.broadcast %3, dims = [0] : (tensor<2x!pphlo.secret<f32>>) -> tensor<2x1x!pphlo.secret<f32>>
+    %5 = pphlo.broadcast %4, dims = [0, 1] : (tensor<2x1x!pphlo.secret<f32>>) -> tensor<2x3x!pphlo.secret<f32>>
+    %6 = pphlo.subtract %arg0, %5 : tensor<2x3x!pphlo.secret<f32>>
+    %7 = pphlo.exponential %6 : tensor<2x3x!pphlo.secret<f32>>
+    %8 = pphlo.convert %1 : (tensor<f32>) -> tensor<!pphlo.secret<f32>>
+    %9 = pphlo.reduce(%7 init: %8) applies pphlo.add across dimensions = [1] : (tensor<2x3x!pphlo.secret<f32>>, tensor<!pphlo.secret<f32>>) -> tensor<2x!pphlo.secret<f32>>
+    %10 = pphlo.reshape %9 : (tensor<2x!pphlo.secret<f32>>) -> tensor<2x1x!pphlo.secret<f32>>
+    %11 = pphlo.broadcast %10, dims = [0, 1] : (tensor<2x1x!pphlo.secret<f32>>) -> tensor<2x3x!pphlo.secret<f32>>
+    %12 = pphlo.divide %7, %11 : tensor<2x3x!pphlo.secret<f32>>
+    return %12 : tensor<2x3x!pphlo.secret<f32>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<3x3x!pphlo.secret<f32>>) -> (tensor<3x3x!pphlo.secret<f32>>) {
+    // Row max broadcast along the wrong axis
+    // CHECK-NOT: spu.softmax
+    // CHECK: pphlo.divide
+    %0 = pphlo.constant dense<0xFF800000> : tensor<f32>
+    %1 = pphlo.constant dense<0.000000e+00> : tensor<f32>
+    %2 = pphlo.convert %0 : (tensor<f32>) -> tensor<!pphlo.secret<f32>>
+    %3 = pphlo.reduce(%arg0 init: %2) applies pphlo.maximum across dimensions = [1] : (tensor<3x3x!pphlo.secret<f32>>, tensor<!pphlo.secret<f32>>) -> tensor<3x!pphlo.secret<f32>>
+    %4 = pphlo.broadcast %3, dims = [1] : (tensor<3x!pphlo.secret<f32>>) -> tensor<3x3x!pphlo.secret<f32>>
+    %5 = pphlo.subtract %arg0, %4 : tensor<3x3x!pphlo.secret<f32>>
+    %6 = pphlo.exponential %5 : tensor<3x3x!pphlo.secret<f32>>
+    %7 = pphlo.convert %1 : (tensor<f32>) -> tensor<!pphlo.secret<f32>>
+    %8 = pphlo.reduce(%6 init: %7) applies pphlo.add across dimensions = [1] : (tensor<3x3x!pphlo.secret<f32>>, tensor<!pphlo.secret<f32>>) -> tensor<3x!pphlo.secret<f32>>
+    %9 = pphlo.broadcast %8, dims = [0] : (tensor<3x!pphlo.secret<f32>>) -> tensor<3x3x!pphlo.secret<f32>>
+    %10 = pphlo.divide %6, %9 : tensor<3x3x!pphlo.secret<f32>>
+    return %10 : tensor<3x3x!pphlo.secret<f32>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<3x2xf32>) -> (tensor<3x2xf32>) {
+    // Public softmax is local, nothing to fuse
+    // CHECK-NOT: spu.softmax
+    // CHECK: pphlo.divide
+    %0 = pphlo.constant dense<0xFF800000> : tensor<f32>
+    %1 = pphlo.constant dense<0.000000e+00> : tensor<f32>
+    %2 = pphlo.reduce(%arg0 init: %0) applies pphlo.maximum across dimensions = [0] : (tensor<3x2xf32>, tensor<f32>) -> tensor<2xf32>
+    %3 = pphlo.broadcast %2, dims = [1] : (tensor<2xf32>) -> tensor<3x2xf32>
+    %4 = pphlo.subtract %arg0, %3 : tensor<3x2xf32>
+    %5 = pphlo.exponential %4 : tensor<3x2xf32>
+    %6 = pphlo.reduce(%5 init: %1) applies pphlo.add across dimensions = [0] : (tensor<3x2xf32>, tensor<f32>) -> tensor<2xf32>
+    %7 = pphlo.broadcast %6, dims = [1] : (tensor<2xf32>) -> tensor<3x2xf32>
+    %8 = pphlo.divide %5, %7 : tensor<3x2xf32>
+    return %8 : tensor<3x2xf32>
+}
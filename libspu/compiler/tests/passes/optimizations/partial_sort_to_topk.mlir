@@ -89,3 +89,14 @@ func.func @main(%arg0: tensor<14x!pphlo.secret<i32>>) -> tensor<!pphlo.secret<f3
     %15 = pphlo.reshape %14 : (tensor<1x!pphlo.secret<f32>>) -> tensor<!pphlo.secret<f32>>
     return %15 : tensor<!pphlo.secret<f32>>
 }
+
+// -----
+
+func.func @main(%arg0: tensor<256x!pphlo.secret<f32>>) -> tensor<1x!pphlo.secret<f32>> {
+    //CHECK: pphlo.custom_call @mhlo.topk(%arg0) {mhlo.attributes = {k = 3 : i64, k_hi = 5 : i64, largest = true, value_only = true}} : (tensor<256x!pphlo.secret<f32>>) -> tensor<5x!pphlo.secret<f32>>
+    %0 = pphlo.simple_sort %arg0  DES, dim = 0, num_keys = 1 : (tensor<256x!pphlo.secret<f32>>) -> tensor<256x!pphlo.secret<f32>>
+    %1 = pphlo.slice %0 [3:1:4] : (tensor<256x!pphlo.secret<f32>>) -> tensor<1x!pphlo.secret<f32>>
+    %2 = pphlo.slice %0 [4:1:5] : (tensor<256x!pphlo.secret<f32>>) -> tensor<1x!pphlo.secret<f32>>
+    %3 = pphlo.add %1, %2 : tensor<1x!pphlo.secret<f32>>
+    return %3 : tensor<1x!pphlo.secret<f32>>
+}
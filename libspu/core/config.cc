@@ -115,6 +115,10 @@ void populateRuntimeConfig(RuntimeConfig& cfg) {
     cfg.set_sigmoid_mode(RuntimeConfig::SIGMOID_REAL);
   }
 
+  if (cfg.mmul_pipeline_edge() == 0) {
+    cfg.set_mmul_pipeline_edge(512);
+  }
+
   // MPC related configurations
   // trunc_allow_msb_error           // by pass.
 }
@@ -32,8 +32,25 @@ std::string genRootObjectId(const std::shared_ptr<yacl::link::Context>& lctx) {
   return "root";
 }
 
+thread_local const std::string* tls_kernel_name = nullptr;
+
 }  // namespace
 
+std::string_view getCurrentKernelName() {
+  return tls_kernel_name == nullptr ? std::string_view() : *tls_kernel_name;
+}
+
+namespace detail {
+
+KernelNameGuard::KernelNameGuard(const std::string& name)
+    : prev_(tls_kernel_name) {
+  tls_kernel_name = &name;
+}
+
+KernelNameGuard::~KernelNameGuard() { tls_kernel_name = prev_; }
+
+}  // namespace detail
+
 SPUContext::SPUContext(const RuntimeConfig& config,
                        const std::shared_ptr<yacl::link::Context>& lctx)
     : config_(config),
@@ -16,6 +16,8 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <variant>
 
 #include "yacl/link/context.h"
@@ -192,12 +194,32 @@ void bindParams(KernelEvalContext* ectx, First&& head, Args&&... tail) {
 
 }  // namespace detail
 
+// Name of the innermost kernel dispatched on the calling thread, empty outside
+// of kernels. States use it to attribute their costs to kernels.
+std::string_view getCurrentKernelName();
+
+namespace detail {
+
+class KernelNameGuard {
+  const std::string* prev_;
+
+ public:
+  explicit KernelNameGuard(const std::string& name);
+  ~KernelNameGuard();
+
+  KernelNameGuard(const KernelNameGuard&) = delete;
+  KernelNameGuard& operator=(const KernelNameGuard&) = delete;
+};
+
+}  // namespace detail
+
 // Dynamic dispatch to a kernel according to a symbol name.
 template <typename Ret = Value, typename... Args>
 Ret dynDispatch(SPUContext* sctx, const std::string& name, Args&&... args) {
   /// Steps of dynamic dispatch.
   // 1. find a prop kernel.
   Kernel* kernel = sctx->prot()->getKernel(name);
+  detail::KernelNameGuard name_guard(name);
 
   // 2. prep parameters (flatten it into an evaluation context).
   KernelEvalContext ectx(sctx);
@@ -205,7 +227,16 @@ Ret dynDispatch(SPUContext* sctx, const std::string& name, Args&&... args) {
 
   // 3. call a visitor, visit a kernel with params.
   // TODO: use a visitor to call different stage of a kernel
-  kernel->evaluate(&ectx);
+  // States are told around the kernel, see State::beginKernel. endKernel may
+  // communicate, so it is not left to a destructor.
+  sctx->prot()->beginKernel();
+  try {
+    kernel->evaluate(&ectx);
+  } catch (...) {
+    sctx->prot()->endKernel();
+    throw;
+  }
+  sctx->prot()->endKernel();
 
   // 4. steal the result and return it.
   if (ectx.numOutputs() > 0) {
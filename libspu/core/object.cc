@@ -39,6 +39,18 @@ bool Object::hasLowCostFork() const {
   return true;
 }
 
+void Object::beginKernel() {
+  for (const auto& [key, val] : states_) {
+    val->beginKernel();
+  }
+}
+
+void Object::endKernel() {
+  for (const auto& [key, val] : states_) {
+    val->endKernel();
+  }
+}
+
 void Object::regKernel(const std::string& name,
                        std::unique_ptr<Kernel> kernel) {
   const auto itr = kernels_.find(name);
@@ -80,6 +80,11 @@ class State {
 
   // TODO: this is a const method.
   virtual std::unique_ptr<State> fork();
+
+  // Called around every kernel dispatched on the owning object, kernels may
+  // nest.
+  virtual void beginKernel() {}
+  virtual void endKernel() {}
 };
 
 // A dynamic object contains a set of kernels and a set of states.
@@ -108,6 +113,10 @@ class Object final {
 
   bool hasLowCostFork() const;
 
+  // Notifies all states, see State::beginKernel.
+  void beginKernel();
+  void endKernel();
+
   void regKernel(const std::string& name, std::unique_ptr<Kernel> kernel);
 
   template <typename KernelT>
@@ -141,6 +150,11 @@ class Object final {
              std::make_unique<StateT>(std::forward<Args>(args)...));
   }
 
+  template <typename StateT>
+  bool hasState() const {
+    return states_.find(StateT::kBindName()) != states_.end();
+  }
+
   template <typename StateT>
   StateT* getState() {
     const auto& itr = states_.find(StateT::kBindName());
@@ -29,6 +29,7 @@
 #include "libspu/device/utils/debug_dump_constant.h"
 #include "libspu/dialect/pphlo/IR/dialect.h"
 #include "libspu/dialect/utils/utils.h"
+#include "libspu/mpc/common/communicator.h"
 #include "libspu/version.h"
 
 namespace spu::device {
@@ -73,7 +74,14 @@ struct CommunicationStats {
   size_t send_actions = 0;
   size_t recv_actions = 0;
 
-  void reset(const std::shared_ptr<yacl::link::Context> &lctx) {
+  // Breakdown by tag and kernel, including forked contexts.
+  mpc::CommProfile profile;
+
+  void reset(spu::SPUContext *sctx) {
+    if (sctx->prot()->hasState<mpc::Communicator>()) {
+      profile = sctx->prot()->getState<mpc::Communicator>()->getProfile();
+    }
+    const auto &lctx = sctx->lctx();
     if (!lctx) {
       return;
     }
@@ -83,7 +91,12 @@ struct CommunicationStats {
     recv_bytes = lctx->GetStats()->recv_bytes;
   }
 
-  void diff(const std::shared_ptr<yacl::link::Context> &lctx) {
+  void diff(spu::SPUContext *sctx) {
+    if (sctx->prot()->hasState<mpc::Communicator>()) {
+      profile =
+          sctx->prot()->getState<mpc::Communicator>()->getProfile() - profile;
+    }
+    const auto &lctx = sctx->lctx();
     if (!lctx) {
       return;
     }
@@ -235,6 +248,18 @@ void printProfilingData(spu::SPUContext *sctx, const std::string &name,
       "actions {}",
       comm_stats.send_bytes, comm_stats.recv_bytes, comm_stats.send_actions,
       comm_stats.recv_actions);
+
+  // print communicator breakdown
+  if (!comm_stats.profile.by_tag.empty()) {
+    SPDLOG_INFO("{}", comm_stats.profile.toString());
+  }
+  for (const auto &tag : comm_stats.profile.getTinyMessageHotSpots()) {
+    const auto &counter = comm_stats.profile.by_tag.find(tag)->second;
+    SPDLOG_WARN(
+        "Tiny messages: tag {} sent {} messages of {} bytes on average, "
+        "consider batching them or enabling comm coalescing",
+        tag, counter.msgs, counter.bytes / counter.msgs);
+  }
 }
 
 void SPUErrorHandler(void *use_data, const char *reason, bool gen_crash_diag) {
@@ -263,7 +288,7 @@ void executeImpl(OpExecutor *executor, spu::SPUContext *sctx,
   installLLVMErrorHandler();
 
   CommunicationStats comm_stats;
-  comm_stats.reset(sctx->lctx());
+  comm_stats.reset(sctx);
   ExecutionStats exec_stats;
 
   // prepare inputs from environment.
@@ -346,7 +371,7 @@ void executeImpl(OpExecutor *executor, spu::SPUContext *sctx,
     }
   }
 
-  comm_stats.diff(sctx->lctx());
+  comm_stats.diff(sctx);
   if ((getGlobalTraceFlag(sctx->id()) & TR_REC) != 0) {
     printProfilingData(sctx, executable.name(), exec_stats, comm_stats);
   }
@@ -22,6 +22,10 @@
 #define    PREFER_A         "spu.prefer_a"
 #define    DBG_PRINT        "spu.dbg_print"
 #define    GATHER           "spu.gather"
+#define    ROW_GATHER       "spu.row_gather"
+#define    SELECT_N         "spu.select_n"
+#define    MULTIPLEX        "spu.multiplex"
+#define    SOFTMAX          "spu.softmax"
 // should be consistent with python level
 #define    MAKE_CACHED_VAR  "spu.make_cached_var"
 #define    DROP_CACHED_VAR  "spu.drop_cached_var"
@@ -14,6 +14,9 @@
 
 #include "libspu/device/pphlo/pphlo_executor.h"
 
+#include <optional>
+
+#include "llvm/ADT/STLExtras.h"
 #include "mlir/IR/BuiltinAttributes.h"
 
 #include "libspu/core/encoding.h"
@@ -157,6 +160,35 @@ int64_t findTwoK(double in) {
   return --count;
 }
 
+// Returns true for a `max(arg0, arg1)` reduce body, false for `min`, nullopt
+// otherwise.
+std::optional<bool> getMaxMinReducer(mlir::Region &body) {
+  auto &block = body.front();
+  if (block.getNumArguments() != 2 || !llvm::hasNItems(block, 2)) {
+    return std::nullopt;
+  }
+  auto &op = block.front();
+  auto ret = mlir::dyn_cast<mlir::spu::pphlo::ReturnOp>(block.back());
+  if (!ret || ret->getNumOperands() != 1 ||
+      ret->getOperand(0) != op.getResult(0) || op.getNumOperands() != 2) {
+    return std::nullopt;
+  }
+  auto lhs = op.getOperand(0);
+  auto rhs = op.getOperand(1);
+  auto arg0 = block.getArgument(0);
+  auto arg1 = block.getArgument(1);
+  if (!((lhs == arg0 && rhs == arg1) || (lhs == arg1 && rhs == arg0))) {
+    return std::nullopt;
+  }
+  if (mlir::isa<mlir::spu::pphlo::MaxOp>(op)) {
+    return true;
+  }
+  if (mlir::isa<mlir::spu::pphlo::MinOp>(op)) {
+    return false;
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
 namespace spu::device::pphlo {
@@ -278,11 +310,7 @@ STANDARD_BINARY_OP_EXEC_IMPL(AddOp, Add)
 STANDARD_BINARY_OP_EXEC_IMPL(Atan2Op, Atan2)
 STANDARD_BINARY_OP_EXEC_IMPL(EqualOp, Equal)
 STANDARD_BINARY_OP_EXEC_IMPL(NotEqualOp, NotEqual)
-STANDARD_BINARY_OP_EXEC_IMPL(LessEqualOp, LessEqual)
-STANDARD_BINARY_OP_EXEC_IMPL(GreaterEqualOp, GreaterEqual)
 STANDARD_BINARY_OP_EXEC_IMPL(SubtractOp, Sub)
-STANDARD_BINARY_OP_EXEC_IMPL(LessOp, Less)
-STANDARD_BINARY_OP_EXEC_IMPL(GreaterOp, Greater)
 STANDARD_BINARY_OP_EXEC_IMPL(PowOp, Power)
 STANDARD_BINARY_OP_EXEC_IMPL(MaxOp, Max)
 STANDARD_BINARY_OP_EXEC_IMPL(MinOp, Min)
@@ -296,6 +324,29 @@ STANDARD_BINARY_OP_EXEC_IMPL(ShiftRightLogicalOp, Rshift)
 
 #undef STANDARD_BINARY_OP_EXEC_IMPL
 
+// Ordering comparisons annotated by the infer-bitwidth pass evaluate their msb
+// on a narrower ring.
+#define COMPARISON_OP_EXEC_IMPL(OpName, KernelName)                           \
+  void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,           \
+               mlir::spu::pphlo::OpName &op, const ExecutionOptions &opts) {  \
+    auto lhs = lookupValue(sscope, op.getLhs(), opts);                        \
+    auto rhs = lookupValue(sscope, op.getRhs(), opts);                        \
+    if (auto bits = op->getAttrOfType<mlir::IntegerAttr>("pphlo.bitwidth")) { \
+      addValue(sscope, op.getResult(),                                        \
+               kernel::hlo::KernelName(sctx, lhs, rhs, bits.getInt()), opts); \
+    } else {                                                                  \
+      addValue(sscope, op.getResult(),                                        \
+               kernel::hlo::KernelName(sctx, lhs, rhs), opts);                \
+    }                                                                         \
+  }
+
+COMPARISON_OP_EXEC_IMPL(LessOp, Less)
+COMPARISON_OP_EXEC_IMPL(GreaterOp, Greater)
+COMPARISON_OP_EXEC_IMPL(LessEqualOp, LessEqual)
+COMPARISON_OP_EXEC_IMPL(GreaterEqualOp, GreaterEqual)
+
+#undef COMPARISON_OP_EXEC_IMPL
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::MulOp &op, const ExecutionOptions &opts) {
   auto smallConst = op.getRhs().getDefiningOp<mlir::spu::pphlo::ConstantOp>();
@@ -847,6 +898,27 @@ void execute(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
       std::none_of(dimensions_to_reduce.begin(), dimensions_to_reduce.end(),
                    [](int64_t d) { return d == 0; });
 
+  const auto &output_shape =
+      mlir::dyn_cast<mlir::RankedTensorType>(op->getResultTypes()[0])
+          .getShape();
+
+  if (auto is_max = getMaxMinReducer(op.getBody());
+      is_max.has_value() && num_args == 1 &&
+      input_args[0].numel() > 0) {
+    auto ret = kernel::hlo::ArgReduce(sctx, input_args[0],
+                                      dimensions_to_reduce, *is_max,
+                                      /*with_index*/ false)
+                   .first;
+    if (!canIgnoreInitialValue) {
+      auto init = kernel::hlo::Broadcast(sctx, init_values[0], ret.shape(), {});
+      ret = *is_max ? kernel::hlo::Max(sctx, ret, init)
+                    : kernel::hlo::Min(sctx, ret, init);
+    }
+    addValue(sscope, op->getResult(0),
+             kernel::hlo::Reshape(sctx, ret, output_shape), opts);
+    return;
+  }
+
   std::vector<spu::Value> ret = kernel::hlo::Reduce(
       sctx, input_args, init_values, dimensions_to_reduce,
       [&](absl::Span<const spu::Value> lhs, absl::Span<const spu::Value> rhs) {
@@ -858,9 +930,6 @@ void execute(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
       },
       canIgnoreInitialValue);
 
-  const auto &output_shape =
-      mlir::dyn_cast<mlir::RankedTensorType>(op->getResultTypes()[0])
-          .getShape();
   for (size_t idx = 0; idx < op->getNumResults(); ++idx) {
     addValue(sscope, op->getResult(idx),
              kernel::hlo::Reshape(sctx, ret[idx], output_shape), opts);
@@ -908,6 +977,22 @@ void execute(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
   config.window_padding = window_padding;
   config.base_dilations = base_dilation;
 
+  const bool canIgnoreInitialValue = std::none_of(
+      window_shape.begin(), window_shape.end(),
+      [](int64_t ws) { return ws == 0; });
+
+  if (auto is_max = getMaxMinReducer(op.getBody());
+      is_max.has_value() && num_args == 1 && canIgnoreInitialValue &&
+      std::all_of(window_dilations.begin(), window_dilations.end(),
+                  [](int64_t d) { return d == 1; })) {
+    auto ret = kernel::hlo::ArgReduceWindow(sctx, input_args[0], ret_shape,
+                                            config, *is_max,
+                                            /*with_index*/ false)
+                   .first;
+    addValue(sscope, op->getResults()[0], std::move(ret), opts);
+    return;
+  }
+
   auto rets = kernel::hlo::ReduceWindow(
       sctx, input_args, init_values, ret_shape, config,
       [&](absl::Span<const spu::Value> lhs, absl::Span<const spu::Value> rhs) {
@@ -917,8 +1002,7 @@ void execute(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
         operands.insert(operands.end(), rhs.begin(), rhs.end());
         return runRegion(executor, sctx, sscope, op.getBody(), operands);
       },
-      std::none_of(window_shape.begin(), window_shape.end(),
-                   [](int64_t ws) { return ws == 0; }));
+      canIgnoreInitialValue);
 
   for (int64_t idx = 0; idx < op->getNumResults(); ++idx) {
     addValue(sscope, op->getResults()[idx], std::move(rets[idx]), opts);
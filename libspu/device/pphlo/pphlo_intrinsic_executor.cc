@@ -20,10 +20,13 @@
 #include "libspu/kernel/hal/debug.h"
 #include "libspu/kernel/hal/fxp_approx.h"
 #include "libspu/kernel/hlo/basic_binary.h"
+#include "libspu/kernel/hlo/basic_ternary.h"
 #include "libspu/kernel/hlo/casting.h"
 #include "libspu/kernel/hlo/const.h"
+#include "libspu/kernel/hlo/control_flow.h"
 #include "libspu/kernel/hlo/indexing.h"
 #include "libspu/kernel/hlo/rank.h"
+#include "libspu/kernel/hlo/softmax.h"
 
 namespace spu::device::pphlo {
 
@@ -99,12 +102,25 @@ std::vector<Value> intrinsic_dispatcher(SPUContext* ctx,
       value_only = mlir::dyn_cast<mlir::BoolAttr>(value_only_attr).getValue();
     }
 
+    auto method = kernel::hal::TopKMethod::Auto;
+    if (auto method_attr = attr.get("method")) {
+      auto method_name = mlir::dyn_cast<mlir::StringAttr>(method_attr).str();
+      if (method_name == "tournament") {
+        method = kernel::hal::TopKMethod::Tournament;
+      } else if (method_name == "quick_select") {
+        method = kernel::hal::TopKMethod::QuickSelect;
+      } else {
+        SPU_THROW("unknown topk method {}", method_name);
+      }
+    }
+
+    int64_t k_hi = -1;
     if (auto k_hi_attr = attr.get("k_hi")) {
-      auto k_hi = mlir::dyn_cast<mlir::IntegerAttr>(k_hi_attr).getInt();
-      return kernel::hlo::TopK(ctx, inputs[0], k, k_hi, largest, value_only);
+      k_hi = mlir::dyn_cast<mlir::IntegerAttr>(k_hi_attr).getInt();
     }
 
-    return kernel::hlo::TopK(ctx, inputs[0], k, -1, largest, value_only);
+    return kernel::hlo::TopK(ctx, inputs[0], k, k_hi, largest, value_only,
+                             method);
   }
 
   if (name == GATHER) {
@@ -135,6 +151,39 @@ std::vector<Value> intrinsic_dispatcher(SPUContext* ctx,
         kernel::hlo::Gather(ctx, inputs[0], inputs[1], config, output_shape)};
   }
 
+  if (name == ROW_GATHER) {
+    return {kernel::hlo::SecretRowGather(ctx, inputs[0], inputs[1])};
+  }
+
+  if (name == SELECT_N) {
+    // inputs = [pred, on_true..., on_false...]
+    const size_t num_results = call->getNumResults();
+    SPU_ENFORCE_EQ(inputs.size(), 2 * num_results + 1);
+    return kernel::hlo::Select(ctx, inputs[0],
+                               inputs.subspan(1, num_results),
+                               inputs.subspan(1 + num_results, num_results));
+  }
+
+  if (name == MULTIPLEX) {
+    // inputs = [mask, branch0 results..., branch1 results..., ...]
+    const size_t num_results = call->getNumResults();
+    SPU_ENFORCE(num_results > 0 && (inputs.size() - 1) % num_results == 0);
+    std::vector<std::vector<Value>> branches;
+    for (size_t offset = 1; offset < inputs.size(); offset += num_results) {
+      auto results = inputs.subspan(offset, num_results);
+      branches.emplace_back(results.begin(), results.end());
+    }
+    return kernel::hlo::Multiplex(ctx, inputs[0], branches);
+  }
+
+  if (name == SOFTMAX) {
+    SPU_ENFORCE(inputs.size() == 1);
+    auto attr = mlir::dyn_cast<mlir::DictionaryAttr>(
+        call->getAttr("pphlo.attributes"));
+    auto axis = mlir::dyn_cast<mlir::IntegerAttr>(attr.get("axis")).getInt();
+    return {kernel::hlo::Softmax(ctx, inputs[0], axis)};
+  }
+
   if (name == PREFER_A) {
     if (ctx->config().protocol() == ProtocolKind::CHEETAH) {
       // NOTE(juhou): For 2PC, MulAB uses COT which is efficient and accurate
@@ -550,13 +550,10 @@ class MarkValueOnlyTopK : public OpRewritePattern<CustomCallOp> {
         op->getLoc(), TypeRange{op->getResultTypes()[0]}, op->getOperands(),
         op.getCallTargetName());
 
-    auto new_attr = DictionaryAttr::get(
-        op->getContext(),
-        {NamedAttribute(rewriter.getStringAttr("k"), attr.get("k")),
-         NamedAttribute(rewriter.getStringAttr("largest"), attr.get("largest")),
-         NamedAttribute(rewriter.getStringAttr("value_only"),
-                        rewriter.getBoolAttr(true))});
-    new_op->setAttr("mhlo.attributes", new_attr);
+    NamedAttrList new_attr(attr);
+    new_attr.set("value_only", rewriter.getBoolAttr(true));
+    new_op->setAttr("mhlo.attributes",
+                    new_attr.getDictionary(op->getContext()));
 
     rewriter.replaceAllUsesWith(op->getResult(0), new_op->getResult(0));
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <numeric>
+#include <optional>
 #include <unordered_set>
 
 #include "mlir/IR/PatternMatch.h"
@@ -41,6 +42,72 @@ bool GatherIsBroadcast(CustomCallOp &op) {
                      op_shape.begin()));
 }
 
+// A row gather takes whole rows of the operand, like an embedding or table
+// lookup:
+//   result[b..., :] = operand[indices[b...], :]
+// On success returns the number of gathered rows.
+std::optional<int64_t> GatherIsRowGather(CustomCallOp &op) {
+  auto operand_type =
+      mlir::dyn_cast<RankedTensorType>(op->getOperands()[0].getType());
+  auto indices_type =
+      mlir::dyn_cast<RankedTensorType>(op->getOperands()[1].getType());
+  if (!operand_type || !indices_type || operand_type.getRank() == 0) {
+    return std::nullopt;
+  }
+  // The runtime row gather works on real-valued tables only.
+  TypeTools type_tools(op->getContext());
+  if (mlir::isa<mlir::ComplexType>(
+          type_tools.getExpressedType(operand_type.getElementType()))) {
+    return std::nullopt;
+  }
+  auto attr =
+      mlir::dyn_cast<mlir::DictionaryAttr>(op->getAttr("pphlo.attributes"));
+  auto as_array = [&](llvm::StringRef name) {
+    return mlir::dyn_cast<mlir::DenseI64ArrayAttr>(attr.get(name))
+        .asArrayRef();
+  };
+
+  if (as_array("start_index_map") != llvm::ArrayRef<int64_t>{0} ||
+      as_array("collapsed_slice_dims") != llvm::ArrayRef<int64_t>{0}) {
+    return std::nullopt;
+  }
+
+  const auto operand_shape = operand_type.getShape();
+  const auto slice_sizes = as_array("slice_sizes");
+  if (slice_sizes.size() != operand_shape.size() || slice_sizes[0] != 1 ||
+      !std::equal(slice_sizes.begin() + 1, slice_sizes.end(),
+                  operand_shape.begin() + 1)) {
+    return std::nullopt;
+  }
+
+  const auto indices_shape = indices_type.getShape();
+  const auto index_vector_dim =
+      mlir::dyn_cast<mlir::IntegerAttr>(attr.get("index_vector_dim")).getInt();
+  int64_t num_batch_dims = indices_shape.size();
+  if (index_vector_dim < static_cast<int64_t>(indices_shape.size())) {
+    if (indices_shape[index_vector_dim] != 1) {
+      return std::nullopt;
+    }
+    --num_batch_dims;
+  }
+
+  // Slice dims must be the trailing output dims.
+  const auto offset_dims = as_array("offset_dims");
+  if (offset_dims.size() != operand_shape.size() - 1) {
+    return std::nullopt;
+  }
+  for (size_t idx = 0; idx < offset_dims.size(); ++idx) {
+    if (offset_dims[idx] != num_batch_dims + static_cast<int64_t>(idx)) {
+      return std::nullopt;
+    }
+  }
+
+  if (operand_shape[0] == 0 || indices_type.getNumElements() == 0) {
+    return std::nullopt;
+  }
+  return indices_type.getNumElements();
+}
+
 std::vector<int64_t> DeleteDimensions(llvm::ArrayRef<int64_t> dims_to_delete,
                                       llvm::ArrayRef<int64_t> shape) {
   std::unordered_set<int64_t> ordered_dims_to_delete(dims_to_delete.begin(),
@@ -581,10 +648,37 @@ struct GatherConverter : public OpRewritePattern<CustomCallOp> {
       return success();
     }
 
+    auto output_type = mlir::dyn_cast<ShapedType>(op->getResultTypes()[0]);
+
+    if (auto num_rows = GatherIsRowGather(op)) {
+      // Gather all rows with one batched lookup, which runtime maps onto ORAM
+      // reads when the protocol provides them.
+      auto operand_shape =
+          mlir::dyn_cast<ShapedType>(operand.getType()).getShape();
+      llvm::SmallVector<int64_t> rows_shape(operand_shape.begin(),
+                                            operand_shape.end());
+      rows_shape[0] = *num_rows;
+
+      auto flat_indices = rewriter.create<ReshapeOp>(
+          op->getLoc(),
+          RankedTensorType::get(
+              {*num_rows},
+              mlir::dyn_cast<RankedTensorType>(start_indices.getType())
+                  .getElementType()),
+          start_indices);
+      auto call = rewriter.create<CustomCallOp>(
+          op->getLoc(),
+          TypeRange{RankedTensorType::get(rows_shape,
+                                          output_type.getElementType())},
+          ValueRange{operand, flat_indices}, ROW_GATHER);
+      rewriter.replaceOpWithNewOp<ReshapeOp>(op, output_type,
+                                             call.getResult(0));
+      return success();
+    }
+
     auto index_type = type_tool.getExpressedType(
         mlir::dyn_cast<RankedTensorType>(start_indices.getType())
             .getElementType());
-    auto output_type = mlir::dyn_cast<ShapedType>(op->getResultTypes()[0]);
     auto output_shape = output_type.getShape();
     int64_t output_rank = output_shape.size();
 
@@ -0,0 +1,312 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/CheckedArithmetic.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Pass/Pass.h"
+
+#include "libspu/dialect/pphlo/IR/ops.h"
+#include "libspu/dialect/pphlo/transforms/pass_details.h"
+#include "libspu/dialect/pphlo/transforms/passes.h"
+
+#define DEBUG_TYPE "infer-bitwidth"
+
+namespace mlir::spu::pphlo {
+
+namespace {
+
+// Comparisons whose operand difference fits in this many signed bits are
+// annotated. The runtime picks the narrowest ring that holds the annotated
+// width, so a width that does not fit FM32 may still save FM128 programs.
+constexpr int64_t kMaxAnnotateBits = 64;
+
+// Bytes of one msb operand element saved when a comparison of `bits` runs on
+// the narrowest runtime ring instead of a `field_bits` working ring. The msb
+// circuit communicates a multiple of its operand, so this is a lower bound.
+int64_t bytesSaved(int64_t bits, int64_t field_bits) {
+  for (int64_t narrow : {32, 64}) {
+    if (bits <= narrow && narrow < field_bits) {
+      return (field_bits - narrow) / 8;
+    }
+  }
+  return 0;
+}
+
+// Closed integer interval [lo, hi].
+struct Range {
+  int64_t lo;
+  int64_t hi;
+
+  Range unite(const Range &other) const {
+    return {std::min(lo, other.lo), std::max(hi, other.hi)};
+  }
+
+  // Number of bits of the two's complement representation of [lo, hi].
+  int64_t signedBits() const {
+    auto bits = [](int64_t v) -> int64_t {
+      return llvm::bit_width(static_cast<uint64_t>(v >= 0 ? v : ~v)) + 1;
+    };
+    return std::max(bits(lo), bits(hi));
+  }
+};
+
+using OptRange = std::optional<Range>;
+
+OptRange add(const OptRange &x, const OptRange &y) {
+  if (!x || !y) {
+    return std::nullopt;
+  }
+  auto lo = llvm::checkedAdd(x->lo, y->lo);
+  auto hi = llvm::checkedAdd(x->hi, y->hi);
+  if (!lo || !hi) {
+    return std::nullopt;
+  }
+  return Range{*lo, *hi};
+}
+
+OptRange negate(const OptRange &x) {
+  if (!x || x->lo == std::numeric_limits<int64_t>::min()) {
+    return std::nullopt;
+  }
+  return Range{-x->hi, -x->lo};
+}
+
+OptRange sub(const OptRange &x, const OptRange &y) {
+  return add(x, negate(y));
+}
+
+OptRange mul(const OptRange &x, const OptRange &y) {
+  if (!x || !y) {
+    return std::nullopt;
+  }
+  OptRange ret;
+  for (auto a : {x->lo, x->hi}) {
+    for (auto b : {y->lo, y->hi}) {
+      auto c = llvm::checkedMul(a, b);
+      if (!c) {
+        return std::nullopt;
+      }
+      ret = ret ? ret->unite({*c, *c}) : Range{*c, *c};
+    }
+  }
+  return ret;
+}
+
+OptRange unite(const OptRange &x, const OptRange &y) {
+  if (!x || !y) {
+    return std::nullopt;
+  }
+  return x->unite(*y);
+}
+
+// Value range and bit-width inference.
+//
+// SPU stores every integer in the working ring regardless of its declared
+// width, and integer converts are no-ops on the ring, so the declared element
+// type says nothing about the runtime value. Only ranges that are provable from
+// the dataflow are tracked: booleans, constants, iota and everything computed
+// from them without overflow.
+//
+// Ordering comparisons on secret operands lower to msb(lhs - rhs), whose cost
+// is linear in the ring width. When the difference provably fits in fewer bits
+// than the ring, the comparison is annotated with `pphlo.bitwidth` and the
+// runtime evaluates the msb on a narrower ring, with a local down-cast of the
+// difference and a local up-cast of the resulting bit.
+class RangeAnalysis {
+ public:
+  explicit RangeAnalysis(MLIRContext *ctx) : tools_(ctx) {}
+
+  OptRange lookup(Value v) const {
+    auto iter = ranges_.find(v);
+    if (iter != ranges_.end()) {
+      return iter->second;
+    }
+    return typeRange(v.getType());
+  }
+
+  void visit(Operation *op) {
+    if (op->getNumResults() != 1) {
+      return;
+    }
+    auto result = op->getResult(0);
+    auto range =
+        llvm::TypeSwitch<Operation *, OptRange>(op)
+            .Case<ConstantOp>([&](ConstantOp c) { return constRange(c); })
+            .Case<IotaOp>([&](IotaOp iota) -> OptRange {
+              auto type = mlir::dyn_cast<RankedTensorType>(iota.getType());
+              auto n = type.getShape()[iota.getIotaDimension()];
+              return Range{0, std::max<int64_t>(n - 1, 0)};
+            })
+            .Case<AddOp>([&](AddOp o) {
+              return add(lookup(o.getLhs()), lookup(o.getRhs()));
+            })
+            .Case<SubtractOp>([&](SubtractOp o) {
+              return sub(lookup(o.getLhs()), lookup(o.getRhs()));
+            })
+            .Case<MulOp>([&](MulOp o) {
+              return mul(lookup(o.getLhs()), lookup(o.getRhs()));
+            })
+            .Case<MaxOp, MinOp>([&](auto o) {
+              return unite(lookup(o.getLhs()), lookup(o.getRhs()));
+            })
+            .Case<NegOp>([&](NegOp o) { return negate(lookup(o.getOperand())); })
+            .Case<AbsOp>([&](AbsOp o) -> OptRange {
+              auto r = lookup(o.getOperand());
+              auto n = negate(r);
+              if (!r || !n) {
+                return std::nullopt;
+              }
+              return Range{std::max<int64_t>(0, r->lo), std::max(r->hi, n->hi)};
+            })
+            .Case<SignOp>([](SignOp) { return Range{-1, 1}; })
+            .Case<SelectOp>([&](SelectOp o) {
+              return unite(lookup(o.getOnTrue()), lookup(o.getOnFalse()));
+            })
+            .Case<ClampOp>([&](ClampOp o) -> OptRange {
+              auto minv = lookup(o.getMin());
+              auto maxv = lookup(o.getMax());
+              if (!minv || !maxv) {
+                return std::nullopt;
+              }
+              return Range{std::min(minv->lo, maxv->lo), maxv->hi};
+            })
+            .Case<ConvertOp>([&](ConvertOp o) -> OptRange {
+              // int -> int convert is a no-op on ring.
+              if (tools_.isIntType(o.getOperand().getType()) &&
+                  tools_.isIntType(o.getType())) {
+                return lookup(o.getOperand());
+              }
+              return typeRange(o.getType());
+            })
+            .Case<BroadcastOp, ReshapeOp, TransposeOp, SliceOp, ReverseOp,
+                  DynamicSliceOp>(
+                [&](auto o) { return lookup(o->getOperand(0)); })
+            .Case<ConcatenateOp>([&](ConcatenateOp o) -> OptRange {
+              OptRange ret = lookup(o->getOperand(0));
+              for (auto operand : o->getOperands()) {
+                ret = unite(ret, lookup(operand));
+              }
+              return ret;
+            })
+            .Case<PadOp>([&](PadOp o) {
+              return unite(lookup(o.getOperand()), lookup(o.getPaddingValue()));
+            })
+            .Default([&](Operation *) { return typeRange(result.getType()); });
+
+    if (range.has_value()) {
+      ranges_[result] = *range;
+    }
+  }
+
+ private:
+  TypeTools tools_;
+  llvm::DenseMap<Value, Range> ranges_;
+
+  // Booleans are the only values whose range is implied by their type.
+  OptRange typeRange(Type type) const {
+    auto tensor_type =
+        mlir::dyn_cast<RankedTensorType>(tools_.getExpressedType(type));
+    if (tensor_type && tensor_type.getElementType().isInteger(1)) {
+      return Range{0, 1};
+    }
+    return std::nullopt;
+  }
+
+  OptRange constRange(ConstantOp op) const {
+    auto attr = mlir::dyn_cast<DenseIntElementsAttr>(op.getValue());
+    if (!attr || attr.empty()) {
+      return std::nullopt;
+    }
+    auto el_type = mlir::dyn_cast<IntegerType>(attr.getElementType());
+    bool zext = el_type.isUnsigned() || el_type.getWidth() == 1;
+
+    OptRange ret;
+    for (const auto &v : attr.getValues<APInt>()) {
+      if ((zext ? v.getActiveBits() : v.getSignificantBits()) > 63) {
+        return std::nullopt;
+      }
+      int64_t i = zext ? static_cast<int64_t>(v.getZExtValue()) : v.getSExtValue();
+      ret = ret ? ret->unite({i, i}) : Range{i, i};
+    }
+    return ret;
+  }
+};
+
+struct InferBitwidth : public InferBitwidthBase<InferBitwidth> {
+  void runOnOperation() override {
+    auto func = getOperation();
+    RangeAnalysis analysis(&getContext());
+    TypeTools tools(&getContext());
+
+    func.walk([&](Operation *op) {
+      analysis.visit(op);
+
+      if (!mlir::isa<LessOp, LessEqualOp, GreaterOp, GreaterEqualOp>(op)) {
+        return;
+      }
+      auto lhs = op->getOperand(0);
+      auto rhs = op->getOperand(1);
+      if (!tools.isIntType(lhs.getType()) || !tools.isIntType(rhs.getType())) {
+        return;
+      }
+      if (!tools.isSecretType(lhs.getType()) &&
+          !tools.isSecretType(rhs.getType())) {
+        return;
+      }
+
+      auto diff = sub(analysis.lookup(lhs), analysis.lookup(rhs));
+      if (!diff.has_value()) {
+        return;
+      }
+      auto bits = diff->signedBits();
+      if (bits > kMaxAnnotateBits) {
+        return;
+      }
+
+      op->setAttr("pphlo.bitwidth",
+                  IntegerAttr::get(IntegerType::get(&getContext(), 64), bits));
+
+      auto numel =
+          mlir::dyn_cast<RankedTensorType>(op->getResult(0).getType())
+              .getNumElements();
+      const int64_t saved_fm64 = numel * bytesSaved(bits, 64);
+      const int64_t saved_fm128 = numel * bytesSaved(bits, 128);
+      LLVM_DEBUG(llvm::dbgs()
+                 << DEBUG_TYPE << ": " << op->getName() << " at "
+                 << op->getLoc() << " narrowed to " << bits << " bits over "
+                 << numel << " elements, saves ~" << saved_fm64
+                 << " bytes on FM64, ~" << saved_fm128 << " on FM128\n");
+
+      ++numNarrowed;
+      numelNarrowed += numel;
+      bytesSavedFM64 += saved_fm64;
+      bytesSavedFM128 += saved_fm128;
+    });
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>> createInferBitwidthPass() {
+  return std::make_unique<InferBitwidth>();
+}
+
+}  // namespace mlir::spu::pphlo
@@ -17,6 +17,7 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
+#include "libspu/device/intrinsic_table.h"
 #include "libspu/dialect/pphlo/IR/ops.h"
 #include "libspu/dialect/pphlo/transforms/pass_details.h"
 
@@ -28,19 +29,6 @@ class CaseConverter : public OpRewritePattern<CaseOp> {
  private:
   TypeTools tools_;
 
-  Value reshapeOrBroadcast(PatternRewriter &rewriter, Location loc, Value in,
-                           RankedTensorType target_type) const {
-    auto in_type = mlir::dyn_cast<RankedTensorType>(in.getType());
-    auto broadcasted_mask_type =
-        RankedTensorType::get(target_type.getShape(), in_type.getElementType());
-    if (target_type.getNumElements() == in_type.getNumElements()) {
-      return rewriter.create<ReshapeOp>(loc, broadcasted_mask_type, in);
-    } else {
-      return rewriter.create<BroadcastOp>(loc, broadcasted_mask_type, in,
-                                          llvm::SmallVector<int64_t>{0});
-    }
-  }
-
   // Basic algorithm here:
   // %out = case(%idx) {
   //  b0^ { yield r0 }
@@ -55,6 +43,8 @@ class CaseConverter : public OpRewritePattern<CaseOp> {
   // should be one
   // 3. Compute mr0 = m[0]*r0, mr1 = m[1]*r1, ..., mrn = m[n]*rn
   // 4. Accumulate mrs, %out = sum(mr0, mr1, ..., mrn)
+  // Steps 3 and 4 of all results are emitted as one spu.multiplex call, so
+  // the runtime does all the products in a single multiplication.
   void inlineRegionIntoParent(CaseOp &op, PatternRewriter &rewriter) const {
     auto *blockBeforeCase = rewriter.getInsertionBlock();
     auto initPosition = rewriter.getInsertionPoint();
@@ -96,49 +86,24 @@ class CaseConverter : public OpRewritePattern<CaseOp> {
         index_reshaped, llvm::ArrayRef<int64_t>{0});
     auto masks = rewriter.create<EqualOp>(op->getLoc(), iota, index_brocasted);
 
-    llvm::SmallVector<Value> result_masks;
-    auto mask_slice_type =
-        RankedTensorType::get({1}, getElementTypeOrSelf(masks));
-    for (int64_t region_id = 0; region_id < op.getNumRegions(); ++region_id) {
-      auto m = rewriter.create<SliceOp>(op->getLoc(), mask_slice_type, masks,
-                                        llvm::ArrayRef<int64_t>{region_id},
-                                        llvm::ArrayRef<int64_t>{region_id + 1},
-                                        llvm::ArrayRef<int64_t>{1});
-      result_masks.emplace_back(m);
-    }
-
-    std::vector<Value> rets(op->getNumResults());
-
-    // First case
-    auto &first_return = blocks_to_work[0]->back();
-    for (int64_t idx = 0; idx < op->getNumResults(); ++idx) {
-      auto m = reshapeOrBroadcast(
-          rewriter, op->getLoc(), result_masks[0],
-          mlir::dyn_cast<RankedTensorType>(op.getResultTypes()[idx]));
-      rets[idx] =
-          rewriter.create<MulOp>(op->getLoc(), op->getResultTypes()[idx],
-                                 first_return.getOperand(idx), m);
-    }
+    if (op->getNumResults() > 0) {
+      // operands = [masks, r0..., r1..., ..., rn...]
+      llvm::SmallVector<Value> operands{masks.getResult()};
+      for (auto *b : blocks_to_work) {
+        auto &branch_return = b->back();
+        operands.append(branch_return.operand_begin(),
+                        branch_return.operand_end());
+      }
+      auto call = rewriter.create<CustomCallOp>(
+          op->getLoc(), op->getResultTypes(), operands, MULTIPLEX);
 
-    // Other cases
-    for (int64_t branch_idx = 1; branch_idx < num_cases; ++branch_idx) {
-      auto &branch_return = blocks_to_work[branch_idx]->back();
+      // Replace results
       for (int64_t idx = 0; idx < op->getNumResults(); ++idx) {
-        auto m = reshapeOrBroadcast(
-            rewriter, op->getLoc(), result_masks[branch_idx],
-            mlir::dyn_cast<RankedTensorType>(op.getResultTypes()[idx]));
-        m = rewriter.create<MulOp>(op->getLoc(), op->getResultTypes()[idx],
-                                   branch_return.getOperand(idx), m);
-        rets[idx] = rewriter.create<AddOp>(
-            op->getLoc(), op->getResultTypes()[idx], rets[idx], m);
+        rewriter.replaceAllUsesWith(op->getResults()[idx],
+                                    call->getResult(idx));
       }
     }
 
-    // Replace results
-    for (int64_t idx = 0; idx < op->getNumResults(); ++idx) {
-      rewriter.replaceAllUsesWith(op->getResults()[idx], rets[idx]);
-    }
-
     // Erase all returns
     for (auto *b : blocks_to_work) {
       rewriter.eraseOp(&b->back());
@@ -177,6 +142,8 @@ class IfConverter : public OpRewritePattern<IfOp> {
   // }
   // With oblivious execution:
   // %out = select(%pred, r0, r1)
+  // Multiple results share the predicate and are selected by one
+  // spu.select_n call, which takes a single multiplication at runtime.
   void inlineRegionIntoParent(IfOp &op, PatternRewriter &rewriter) const {
     auto *blockBeforeIf = rewriter.getInsertionBlock();
     auto &trueBlock = op.getTrueBranch().front();
@@ -189,11 +156,22 @@ class IfConverter : public OpRewritePattern<IfOp> {
     auto &falseReturnOp = falseBlock.back();
     rewriter.inlineRegionBefore(op.getTrueBranch(), blockAfterIf);
     rewriter.inlineRegionBefore(op.getFalseBranch(), blockAfterIf);
-    for (const auto &[idx, ret] : llvm::enumerate(op->getResults())) {
+    if (op->getNumResults() == 1) {
       auto s = rewriter.create<SelectOp>(
-          op->getLoc(), op.getResultTypes()[idx], op.getCondition(),
-          trueReturnOp.getOperands()[idx], falseReturnOp.getOperands()[idx]);
-      rewriter.replaceAllUsesWith(op->getResult(idx), s);
+          op->getLoc(), op.getResultTypes()[0], op.getCondition(),
+          trueReturnOp.getOperands()[0], falseReturnOp.getOperands()[0]);
+      rewriter.replaceAllUsesWith(op->getResult(0), s);
+    } else if (op->getNumResults() > 1) {
+      // operands = [pred, r0..., r1...]
+      llvm::SmallVector<Value> operands{op.getCondition()};
+      operands.append(trueReturnOp.operand_begin(), trueReturnOp.operand_end());
+      operands.append(falseReturnOp.operand_begin(),
+                      falseReturnOp.operand_end());
+      auto s = rewriter.create<CustomCallOp>(
+          op->getLoc(), op->getResultTypes(), operands, SELECT_N);
+      for (int64_t idx = 0; idx < op->getNumResults(); ++idx) {
+        rewriter.replaceAllUsesWith(op->getResult(idx), s->getResult(idx));
+      }
     }
     rewriter.eraseOp(&trueReturnOp);
     rewriter.eraseOp(&falseReturnOp);
@@ -0,0 +1,271 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <optional>
+
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#include "libspu/device/intrinsic_table.h"
+#include "libspu/dialect/pphlo/IR/ops.h"
+#include "libspu/dialect/pphlo/transforms/pass_details.h"
+#include "libspu/dialect/pphlo/transforms/passes.h"
+
+namespace mlir::spu::pphlo {
+
+namespace {
+
+std::optional<APFloat> getSplatFloat(Value v) {
+  while (auto convert = v.getDefiningOp<ConvertOp>()) {
+    v = convert.getOperand();
+  }
+  auto constant = v.getDefiningOp<ConstantOp>();
+  if (!constant) {
+    return std::nullopt;
+  }
+  auto attr = mlir::dyn_cast<DenseFPElementsAttr>(constant.getValue());
+  if (!attr || !attr.isSplat()) {
+    return std::nullopt;
+  }
+  return attr.getSplatValue<APFloat>();
+}
+
+bool isLowestFloat(Value v) {
+  auto splat = getSplatFloat(v);
+  return splat.has_value() && splat->isNegative() &&
+         (splat->isInfinity() ||
+          splat->compare(APFloat::getLargest(splat->getSemantics(), true)) ==
+              APFloat::cmpEqual);
+}
+
+bool isZeroFloat(Value v) {
+  auto splat = getSplatFloat(v);
+  return splat.has_value() && splat->isZero();
+}
+
+// Reduce body that returns OpT(arg0, arg1).
+template <typename OpT>
+bool isPlainBody(Region &body) {
+  auto &block = body.front();
+  if (block.getNumArguments() != 2 || !llvm::hasNItems(block, 2)) {
+    return false;
+  }
+  auto inner = mlir::dyn_cast<OpT>(block.front());
+  auto ret = mlir::dyn_cast<ReturnOp>(block.back());
+  if (!inner || !ret || ret->getNumOperands() != 1 ||
+      ret->getOperand(0) != inner->getResult(0)) {
+    return false;
+  }
+  auto lhs = inner->getOperand(0);
+  auto rhs = inner->getOperand(1);
+  auto arg0 = block.getArgument(0);
+  auto arg1 = block.getArgument(1);
+  return (lhs == arg0 && rhs == arg1) || (lhs == arg1 && rhs == arg0);
+}
+
+// Matches `v = broadcast(reduce(input))`, where the reduce runs over a single
+// axis and any chain of broadcasts, unit-dim reshapes and `max(_, -inf)` brings
+// the row result back to every element of its row in input.
+// Returns the reduce op and the reduced axis.
+std::optional<std::pair<ReduceOp, int64_t>> matchRowReduce(Value v,
+                                                           Value input) {
+  auto out_shape = mlir::dyn_cast<RankedTensorType>(v.getType()).getShape();
+  SmallVector<Operation *> chain;
+  ReduceOp reduce;
+  while (true) {
+    auto *def = v.getDefiningOp();
+    if (def == nullptr) {
+      return std::nullopt;
+    }
+    if ((reduce = mlir::dyn_cast<ReduceOp>(def))) {
+      break;
+    }
+    if (mlir::isa<BroadcastOp, ReshapeOp>(def)) {
+      chain.emplace_back(def);
+      v = def->getOperand(0);
+    } else if (auto max = mlir::dyn_cast<MaxOp>(def)) {
+      // jnp.max(..., initial=-inf)
+      if (isLowestFloat(max.getRhs())) {
+        v = max.getLhs();
+      } else if (isLowestFloat(max.getLhs())) {
+        v = max.getRhs();
+      } else {
+        return std::nullopt;
+      }
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  if (reduce->getNumResults() != 1 || reduce.getInputs().size() != 1 ||
+      reduce.getInputs()[0] != input || reduce.getDimensions().size() != 1) {
+    return std::nullopt;
+  }
+
+  auto in_shape = mlir::dyn_cast<RankedTensorType>(input.getType()).getShape();
+  const int64_t rank = in_shape.size();
+  const int64_t axis = reduce.getDimensions()[0];
+
+  // origin[i] is the input dim carried by dim i of the current value, -1 for a
+  // dim that was broadcast or inserted.
+  SmallVector<int64_t> origin;
+  for (int64_t d = 0; d < rank; ++d) {
+    if (d != axis) {
+      origin.emplace_back(d);
+    }
+  }
+
+  for (auto *op : llvm::reverse(chain)) {
+    auto operand_shape =
+        mlir::dyn_cast<RankedTensorType>(op->getOperand(0).getType())
+            .getShape();
+    auto result_shape =
+        mlir::dyn_cast<RankedTensorType>(op->getResult(0).getType())
+            .getShape();
+    SmallVector<int64_t> next(result_shape.size(), -1);
+
+    if (auto broadcast = mlir::dyn_cast<BroadcastOp>(op)) {
+      for (const auto &[idx, dim] :
+           llvm::enumerate(broadcast.getBroadcastDimensions())) {
+        if (operand_shape[idx] == result_shape[dim]) {
+          next[dim] = origin[idx];
+        }
+      }
+    } else {
+      // Only reshapes that insert or drop unit dims.
+      SmallVector<int64_t> carried;
+      for (const auto &[idx, size] : llvm::enumerate(operand_shape)) {
+        if (size != 1) {
+          carried.emplace_back(idx);
+        }
+      }
+      size_t pos = 0;
+      for (const auto &[idx, size] : llvm::enumerate(result_shape)) {
+        if (size == 1) {
+          continue;
+        }
+        if (pos == carried.size() || operand_shape[carried[pos]] != size) {
+          return std::nullopt;
+        }
+        next[idx] = origin[carried[pos++]];
+      }
+      if (pos != carried.size()) {
+        return std::nullopt;
+      }
+    }
+    origin = std::move(next);
+  }
+
+  if (out_shape != in_shape) {
+    return std::nullopt;
+  }
+  for (int64_t d = 0; d < rank; ++d) {
+    bool ok = d == axis ? origin[d] == -1 : origin[d] == d;
+    if (!ok && in_shape[d] != 1) {
+      return std::nullopt;
+    }
+  }
+
+  return std::make_pair(reduce, axis);
+}
+
+// Rewrites the jax softmax idiom
+//   m = broadcast(reduce_max(x, axis))
+//   e = exp(x - m)
+//   s = broadcast(reduce_sum(e, axis))
+//   y = e / s
+// on a secret x into one `spu.softmax` call, so the runtime shares the row max,
+// evaluates exp on inputs known to be non-positive and takes a single
+// reciprocal per row.
+struct SoftmaxRewriter : public OpRewritePattern<DivOp> {
+ private:
+  TypeTools tools_;
+
+ public:
+  explicit SoftmaxRewriter(MLIRContext *context)
+      : OpRewritePattern<DivOp>(context), tools_(context) {}
+
+  LogicalResult matchAndRewrite(DivOp op,
+                                PatternRewriter &rewriter) const override {
+    auto exp = op.getLhs().getDefiningOp<ExpOp>();
+    if (!exp) {
+      return failure();
+    }
+    auto sub = exp.getOperand().getDefiningOp<SubtractOp>();
+    if (!sub) {
+      return failure();
+    }
+    auto x = sub.getLhs();
+    if (x.getType() != op.getType() || !tools_.isFloatType(x.getType()) ||
+        !tools_.isSecretType(x.getType())) {
+      return failure();
+    }
+
+    auto row_max = matchRowReduce(sub.getRhs(), x);
+    if (!row_max.has_value() ||
+        !isPlainBody<MaxOp>(row_max->first.getBody()) ||
+        !isLowestFloat(row_max->first.getInitValues()[0])) {
+      return failure();
+    }
+    auto row_sum = matchRowReduce(op.getRhs(), exp.getResult());
+    if (!row_sum.has_value() || row_sum->second != row_max->second ||
+        !isPlainBody<AddOp>(row_sum->first.getBody()) ||
+        !isZeroFloat(row_sum->first.getInitValues()[0])) {
+      return failure();
+    }
+
+    // Fusing would evaluate exp twice when it has other users.
+    if (!llvm::all_of(exp->getUsers(), [&](Operation *user) {
+          return user == op.getOperation() ||
+                 user == row_sum->first.getOperation();
+        })) {
+      return failure();
+    }
+
+    auto call = rewriter.create<CustomCallOp>(
+        op->getLoc(), TypeRange{op.getType()}, ValueRange{x}, SOFTMAX);
+    auto attr = DictionaryAttr::get(
+        op->getContext(),
+        {NamedAttribute(rewriter.getStringAttr("axis"),
+                        rewriter.getI64IntegerAttr(row_max->second))});
+    call->setAttr("pphlo.attributes", attr);
+
+    rewriter.replaceOp(op, call->getResults());
+    return success();
+  }
+};
+
+struct OptimizeSoftmax : public OptimizeSoftmaxBase<OptimizeSoftmax> {
+  void runOnOperation() override {
+    RewritePatternSet patterns(&getContext());
+    populateOwningPatterns(&patterns, &getContext());
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+
+ private:
+  static void populateOwningPatterns(RewritePatternSet *patterns,
+                                     MLIRContext *ctx) {
+    patterns->insert<SoftmaxRewriter>(ctx);
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>> createOptimizeSoftmax() {
+  return std::make_unique<OptimizeSoftmax>();
+}
+
+}  // namespace mlir::spu::pphlo
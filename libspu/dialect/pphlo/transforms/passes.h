@@ -85,6 +85,12 @@ std::unique_ptr<OperationPass<func::FuncOp>> createRewriteSignbitPatterns();
 // Fix region access shape mismatch
 std::unique_ptr<OperationPass<func::FuncOp>> createRegionAccessFixture();
 
+// Annotate secret comparisons whose operands provably fit in a narrower ring
+std::unique_ptr<OperationPass<func::FuncOp>> createInferBitwidthPass();
+
+// Fuse exp(x - max(x)) / sum(exp(x - max(x))) into spu.softmax
+std::unique_ptr<OperationPass<func::FuncOp>> createOptimizeSoftmax();
+
 }  // namespace spu::pphlo
 
 }  // namespace mlir
@@ -0,0 +1,68 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+
+#include "libspu/core/context.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/common/communicator.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::kernel::bench {
+
+// Runs `fn(SPUContext*)` on every party of a simulated world once per
+// iteration, and reports the cost of rank 0 in `fn` as counters:
+//  - sent_bytes: bytes charged to the Communicator.
+//  - rounds: Communicator latency.
+// Forked contexts count their own stats and are not included.
+template <typename Fn>
+void runKernelBench(benchmark::State& state, const RuntimeConfig& conf,
+                    Fn&& fn, size_t npc = 3) {
+  std::atomic<size_t> sent_bytes = 0;
+  std::atomic<size_t> rounds = 0;
+  for (auto _ : state) {
+    mpc::utils::simulate(
+        npc, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+          SPUContext sctx = test::makeSPUContext(conf, lctx);
+          const auto* comm = sctx.getState<mpc::Communicator>();
+
+          const auto before = comm->getStats();
+          fn(&sctx);
+          if (lctx->Rank() == 0) {
+            const auto cost = comm->getStats() - before;
+            sent_bytes = cost.comm;
+            rounds = cost.latency;
+          }
+        });
+  }
+
+  state.counters["sent_bytes"] = static_cast<double>(sent_bytes);
+  state.counters["rounds"] = static_cast<double>(rounds);
+}
+
+// Same as above, with `prot` on FM64 and the default config otherwise.
+template <typename Fn>
+void runKernelBench(benchmark::State& state, ProtocolKind prot, Fn&& fn) {
+  RuntimeConfig conf;
+  conf.set_protocol(prot);
+  conf.set_field(FieldType::FM64);
+  runKernelBench(state, conf, std::forward<Fn>(fn));
+}
+
+}  // namespace spu::kernel::bench
@@ -20,6 +20,7 @@
 #include <future>
 
 #include "libspu/core/trace.h"
+#include "libspu/core/vectorize.h"
 #include "libspu/kernel/hal/constants.h"
 #include "libspu/kernel/hal/fxp_base.h"
 #include "libspu/kernel/hal/fxp_cleartext.h"
@@ -348,32 +349,54 @@ Value tanh_pade(SPUContext* ctx, const Value& x) {
 
 // Reference:
 // https://github.com/facebookresearch/CrypTen/blob/6ef151101668591bcfb2bbf7e7ebd39ab6db0413/crypten/common/functions/approximations.py#L365
+//
+// Returns the odd Chebyshev polynomials T_1(x), T_3(x), ..., T_{2*terms-1}(x).
 Value compute_chebyshev_polynomials(SPUContext* ctx, const Value& x,
                                     int64_t terms) {
   // Ref:
-  // https://en.wikipedia.org/wiki/Chebyshev_polynomials#Recurrence_definition
-  // Chebyshev Polynomials of the first kind are defined as
+  // https://en.wikipedia.org/wiki/Chebyshev_polynomials#Properties
+  // Chebyshev Polynomials of the first kind satisfy
+  //.. math::
+  //    T_{m+n}(x) = 2T_{m}(x)T_{n}(x) - T_{|m-n|}(x)
+  // Let P_i = T_{2i+1} and E_s = T_{2s}, when P_0, ..., P_{s-1} and E_s are
+  // known, one batched multiplication gives
   //.. math::
-  //    P_0(x) = 1
-  //    P_1(x) = x
-  //    P_{n+1}(x) = 2xP_{n}(x) - P_{n-1}(x)
+  //    P_{s+i} = 2P_{i}E_{s} - P_{s-1-i}, 0 <= i < s
+  //    E_{2s}  = 2E_{s}E_{s} - 1
+  // so all terms take 1 + log(terms) rounds, instead of the `terms` rounds of
+  // the recurrence P_{i+1} = (4x^2 - 2)P_{i} - P_{i-1}.
   std::vector<Value> poly = {x};
 
-  // y = 4*x^2 - 2
-  auto four = constant(ctx, 4, DT_I32, x.shape());
-  auto two = constant(ctx, 2.0F, x.dtype(), x.shape());
-  auto y =
-      f_sub(ctx, _mul(ctx, four, f_square(ctx, x)).setDtype(x.dtype()), two);
-  // z = y - 1
+  auto two = constant(ctx, 2, DT_I32, x.shape());
   auto one = constant(ctx, 1.0F, x.dtype(), x.shape());
-  auto z = f_sub(ctx, y, one);
+  // E_1 = 2*x^2 - 1
+  auto even =
+      f_sub(ctx, _mul(ctx, two, f_square(ctx, x)).setDtype(x.dtype()), one);
+
+  for (int64_t s = 1; static_cast<int64_t>(poly.size()) < terms; s *= 2) {
+    const int64_t n = std::min(s, terms - s);
+    const bool next_even = 2 * s < terms;
+
+    std::vector<Value> lhs(poly.begin(), poly.begin() + n);
+    std::vector<Value> rhs(n, even);
+    if (next_even) {
+      lhs.push_back(even);
+      rhs.push_back(even);
+    }
 
-  poly.emplace_back(f_mul(ctx, x, z));
+    std::vector<Value> prods;
+    vmap(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+         std::back_inserter(prods),
+         [ctx](const Value& a, const Value& b) { return f_mul(ctx, a, b); });
 
-  for (int64_t idx = 2; idx < terms; ++idx) {
-    // next_polynomial = y * polynomials[k - 1] - polynomials[k - 2]
-    auto next = f_sub(ctx, f_mul(ctx, y, poly[idx - 1]), poly[idx - 2]);
-    poly.emplace_back(std::move(next));
+    for (int64_t i = 0; i < n; ++i) {
+      auto next = f_sub(ctx, _mul(ctx, two, prods[i]).setDtype(x.dtype()),
+                        poly[s - 1 - i]);
+      poly.emplace_back(std::move(next));
+    }
+    if (next_even) {
+      even = f_sub(ctx, _mul(ctx, two, prods[n]).setDtype(x.dtype()), one);
+    }
   }
 
   return concatenate(ctx, poly, 0);
@@ -486,6 +509,40 @@ Value f_exp(SPUContext* ctx, const Value& x) {
   }
 }
 
+Value f_exp_nonpositive(SPUContext* ctx, const Value& x) {
+  SPU_TRACE_HAL_LEAF(ctx, x);
+
+  SPU_ENFORCE(x.isFxp());
+
+  if (x.isPublic()) {
+    return f_exp_p(ctx, x);
+  }
+
+  switch (ctx->config().fxp_exp_mode()) {
+    case RuntimeConfig::EXP_DEFAULT:
+    case RuntimeConfig::EXP_TAYLOR: {
+      // (1 + x/2^n)^(2^n) stays in [0, 1] as long as x >= -2^n, below that the
+      // base turns negative and the repeated squaring blows up.
+      const double lower_bound =
+          -std::ldexp(1.0, static_cast<int>(ctx->config().fxp_exp_iters()));
+      const auto clamped_x =
+          _clamp_lower(ctx, x, constant(ctx, lower_bound, x.dtype(), x.shape()))
+              .setDtype(x.dtype());
+      return detail::exp_taylor(ctx, clamped_x);
+    }
+    case RuntimeConfig::EXP_PADE: {
+      const float kInputLimit = 32.0 / std::log2(std::exp(1));
+      const auto clamped_x =
+          _clamp_lower(ctx, x,
+                       constant(ctx, -kInputLimit, x.dtype(), x.shape()))
+              .setDtype(x.dtype());
+      return detail::exp_pade(ctx, clamped_x);
+    }
+    default:
+      return f_exp(ctx, x);
+  }
+}
+
 Value f_log(SPUContext* ctx, const Value& x) {
   SPU_TRACE_HAL_LEAF(ctx, x);
 
@@ -708,6 +765,173 @@ Value f_sqrt(SPUContext* ctx, const Value& x) {
   return g;
 }
 
+namespace detail {
+
+// Tables below are fitted per segment with a minimax criterion, outside the
+// outer breakpoints the functions saturate.
+const PiecewisePolynomial& sigmoid_table() {
+  static const PiecewisePolynomial kTable{
+      {-8, -5, -3, -1.5, 0, 1.5, 3, 5, 8},
+      {
+          {0, {0, 0, 0, 0}},
+          {-6.5,
+           {0.00145919246, 0.00146643006, 0.000893850702, 0.000290104272}},
+          {-4, {0.0179165575, 0.0176274917, 0.00907260059, 0.00273901712}},
+          {-2.25, {0.0953550497, 0.0863286598, 0.0348158826, 0.00652641265}},
+          {-0.75, {0.321011804, 0.217843853, 0.036251897, -0.0108934032}},
+          {0.75, {0.678988196, 0.217843853, -0.036251897, -0.0108934032}},
+          {2.25, {0.90464495, 0.0863286598, -0.0348158826, 0.00652641265}},
+          {4, {0.982083443, 0.0176274917, -0.00907260059, 0.00273901712}},
+          {6.5,
+           {0.998540808, 0.00146643006, -0.000893850702, 0.000290104272}},
+          {0, {1, 0, 0, 0}},
+      }};
+  return kTable;
+}
+
+const PiecewisePolynomial& erf_table() {
+  static const PiecewisePolynomial kTable{
+      {-3, -2.25, -1.5, -0.75, 0, 0.75, 1.5, 2.25, 3},
+      {
+          {0, {-1, 0, 0, 0}},
+          {-2.625, {-0.999808891, 0.00110465612, 0.00381482473, 0.00580391613}},
+          {-1.875, {-0.992092036, 0.033443152, 0.0687530278, 0.0696866882}},
+          {-1.125, {-0.888319449, 0.318837848, 0.353953189, 0.150007962}},
+          {-0.375, {-0.403731285, 0.979919763, 0.34518164, -0.225509551}},
+          {0.375, {0.403731285, 0.979919763, -0.34518164, -0.225509551}},
+          {1.125, {0.888319449, 0.318837848, -0.353953189, 0.150007962}},
+          {1.875, {0.992092036, 0.033443152, -0.0687530278, 0.0696866882}},
+          {2.625, {0.999808891, 0.00110465612, -0.00381482473, 0.00580391613}},
+          {0, {1, 0, 0, 0}},
+      }};
+  return kTable;
+}
+
+const PiecewisePolynomial& gelu_table() {
+  static const PiecewisePolynomial kTable{
+      {-5, -3, -2, -1, 0, 1, 2, 3, 5},
+      {
+          {0, {0, 0, 0, 0}},
+          {-4,
+           {-4.80652433e-06, -0.000275300587, -0.00188602462, -0.0017488145}},
+          {-2.5, {-0.0155300458, -0.037729653, -0.0370384335, -0.0148836604}},
+          {-1.5, {-0.100478653, -0.127537201, -0.00746834772, 0.0575288252}},
+          {-0.5, {-0.154018667, 0.133158293, 0.299814771, 0.101988013}},
+          {0.5, {0.345981333, 0.866841707, 0.299814771, -0.101988013}},
+          {1.5, {1.39952135, 1.1275372, -0.00746834772, -0.0575288252}},
+          {2.5, {2.48446995, 1.03772965, -0.0370384335, 0.0148836604}},
+          {4, {3.99999519, 1.0002753, -0.00188602462, 0.0017488145}},
+          {0, {0, 1, 0, 0}},
+      }};
+  return kTable;
+}
+
+const PiecewisePolynomial& silu_table() {
+  static const PiecewisePolynomial kTable{
+      {-12, -8, -5, -3, -1.5, 0, 1.5, 3, 5, 8, 12},
+      {
+          {0, {0, 0, 0, 0}},
+          {-10,
+           {-0.000428836045, -0.000392029086, -0.000230735759,
+            -6.5059375e-05}},
+          {-6.5,
+           {-0.00966316085, -0.00820349686, -0.00369544975, -0.000914215616}},
+          {-4, {-0.0720027886, -0.0528027966, -0.0159355702, -0.0016038951}},
+          {-2.25, {-0.214812735, -0.0988756081, 0.0116924992, 0.0200921266}},
+          {-0.75, {-0.240344965, 0.158178094, 0.184589603, 0.043106628}},
+          {0.75, {0.509655035, 0.841821906, 0.184589603, -0.043106628}},
+          {2.25, {2.03518727, 1.09887561, 0.0116924992, -0.0200921266}},
+          {4, {3.92799721, 1.0528028, -0.0159355702, 0.0016038951}},
+          {6.5, {6.49033684, 1.0082035, -0.00369544975, 0.000914215616}},
+          {10, {9.99957116, 1.00039203, -0.000230735759, 6.5059375e-05}},
+          {0, {0, 1, 0, 0}},
+      }};
+  return kTable;
+}
+
+}  // namespace detail
+
+Value f_piecewise_polynomial(SPUContext* ctx, const Value& x,
+                             const PiecewisePolynomial& pp) {
+  SPU_TRACE_HAL_DISP(ctx, x);
+
+  SPU_ENFORCE(x.isFxp());
+  const auto n = static_cast<int64_t>(pp.breakpoints.size());
+  SPU_ENFORCE(static_cast<int64_t>(pp.segments.size()) == n + 1,
+              "{} breakpoints need {} segments, got {}", n, n + 1,
+              pp.segments.size());
+  SPU_ENFORCE(std::is_sorted(pp.breakpoints.begin(), pp.breakpoints.end()),
+              "breakpoints should be ascending");
+  const auto num_coeffs = pp.segments.front().coeffs.size();
+  SPU_ENFORCE(num_coeffs > 0);
+  for (const auto& segment : pp.segments) {
+    SPU_ENFORCE(segment.coeffs.size() == num_coeffs,
+                "segments should have the same number of coefficients");
+  }
+
+  if (x.numel() == 0) {
+    return x;
+  }
+
+  const int64_t numel = x.numel();
+  const auto num_rows = static_cast<int64_t>(num_coeffs) + 1;
+
+  // Column i holds the coefficients of segment i followed by its center.
+  std::vector<float> flat_table(num_rows * (n + 1));
+  for (int64_t i = 0; i <= n; ++i) {
+    const auto& segment = pp.segments[i];
+    for (size_t k = 0; k < num_coeffs; ++k) {
+      flat_table[k * (n + 1) + i] = segment.coeffs[k];
+    }
+    flat_table[num_coeffs * (n + 1) + i] = segment.center;
+  }
+  auto table = constant(ctx, flat_table, x.dtype(), {num_rows, n + 1});
+  auto last = broadcast_to(ctx, slice(ctx, table, {0, n}, {num_rows, n + 1}),
+                           {num_rows, numel});
+
+  Value selected = last;
+  if (n > 0) {
+    // c[j] = x < breakpoints[j], every comparison in one msb.
+    auto xs = broadcast_to(ctx, reshape(ctx, x, {1, numel}), {n, numel});
+    auto bps = constant(ctx, pp.breakpoints, x.dtype(), {n, 1});
+    auto c = _prefer_a(ctx, _less(ctx, xs, broadcast_to(ctx, bps, {n, numel})));
+
+    // An element of segment i has c[j] = 1 exactly for j >= i, so column i is
+    //   table[:, n] + sum_j c[j] * (table[:, j] - table[:, j + 1])
+    // The differences are taken on the ring to telescope exactly, and the sum
+    // is a local product with a public matrix.
+    auto deltas = _sub(ctx, slice(ctx, table, {0, 0}, {num_rows, n}),
+                       slice(ctx, table, {0, 1}, {num_rows, n + 1}));
+    selected = _add(ctx, last, _mmul(ctx, deltas, c));
+  }
+
+  auto row = [&](int64_t k) {
+    return reshape(ctx, slice(ctx, selected, {k, 0}, {k + 1, numel}),
+                   x.shape())
+        .setDtype(x.dtype());
+  };
+
+  std::vector<Value> coeffs;
+  for (size_t k = 0; k < num_coeffs; ++k) {
+    coeffs.emplace_back(row(static_cast<int64_t>(k)));
+  }
+  auto t = f_sub(ctx, x, row(num_rows - 1));
+
+  return detail::polynomial(ctx, t, coeffs);
+}
+
+Value f_gelu(SPUContext* ctx, const Value& x) {
+  SPU_TRACE_HAL_DISP(ctx, x);
+
+  return f_piecewise_polynomial(ctx, x, detail::gelu_table());
+}
+
+Value f_silu(SPUContext* ctx, const Value& x) {
+  SPU_TRACE_HAL_DISP(ctx, x);
+
+  return f_piecewise_polynomial(ctx, x, detail::silu_table());
+}
+
 namespace {
 
 Value sigmoid_real(SPUContext* ctx, const Value& x) {
@@ -757,6 +981,9 @@ Value f_sigmoid(SPUContext* ctx, const Value& x) {
     case RuntimeConfig::SIGMOID_REAL: {
       return sigmoid_real(ctx, x);
     }
+    case RuntimeConfig::SIGMOID_PIECEWISE: {
+      return f_piecewise_polynomial(ctx, x, detail::sigmoid_table());
+    }
     default: {
       SPU_THROW("Should not hit");
     }
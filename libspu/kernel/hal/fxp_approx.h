@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "libspu/core/value.h"
 
 namespace spu {
@@ -22,8 +24,27 @@ class SPUContext;
 
 // !!please read [README.md] for api naming conventions.
 namespace spu::kernel::hal {
+
+// A function approximated by low degree polynomials on segments of the real
+// line. n ascending breakpoints split it into n + 1 segments, segment i covers
+// [breakpoints[i-1], breakpoints[i]) and evaluates
+//   sum_k coeffs[k] * (x - center)^k
+// All segments must have the same number of coefficients.
+struct PiecewisePolynomial {
+  struct Segment {
+    float center;
+    std::vector<float> coeffs;
+  };
+
+  std::vector<float> breakpoints;
+  std::vector<Segment> segments;
+};
+
 namespace detail {
 
+// log(x) for x in [1, 2], a degree 8 minimax polynomial of x - 1.
+Value log_minmax_normalized(SPUContext* ctx, const Value& x);
+
 Value log_minmax(SPUContext* ctx, const Value& x);
 
 Value log2_pade(SPUContext* ctx, const Value& x);
@@ -42,10 +63,41 @@ Value exp_prime(SPUContext* ctx, const Value& x);
 
 Value tanh_chebyshev(SPUContext* ctx, const Value& x);
 
+// The odd Chebyshev polynomials T_1(x), T_3(x), ..., T_{2*terms-1}(x),
+// concatenated along the first axis.
+Value compute_chebyshev_polynomials(SPUContext* ctx, const Value& x,
+                                    int64_t terms);
+
+// Degree 3 preset tables, max abs error on the whole real line:
+//   sigmoid 3.4e-4, erf 3.9e-4, gelu 2.7e-4, silu 3.1e-4.
+const PiecewisePolynomial& sigmoid_table();
+
+const PiecewisePolynomial& erf_table();
+
+const PiecewisePolynomial& gelu_table();
+
+const PiecewisePolynomial& silu_table();
+
 }  // namespace detail
 
+// Evaluates a piecewise polynomial. All segment comparisons share one batched
+// msb, the coefficients of the segment of each element are selected locally
+// from the comparison bits, and the polynomial takes a single final truncation.
+Value f_piecewise_polynomial(SPUContext* ctx, const Value& x,
+                             const PiecewisePolynomial& pp);
+
+// x * Phi(x), Phi is the standard normal cdf.
+Value f_gelu(SPUContext* ctx, const Value& x);
+
+// x * sigmoid(x)
+Value f_silu(SPUContext* ctx, const Value& x);
+
 Value f_exp(SPUContext* ctx, const Value& x);
 
+// exp(x) for inputs known to be non-positive, e.g. softmax inputs shifted by
+// their row max. Only the lower end of the input range needs a clamp.
+Value f_exp_nonpositive(SPUContext* ctx, const Value& x);
+
 Value f_log1p(SPUContext* ctx, const Value& x);
 
 Value f_log(SPUContext* ctx, const Value& x);
@@ -0,0 +1,135 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cmath>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+
+#include "libspu/kernel/bench_util.h"
+#include "libspu/kernel/hal/constants.h"
+#include "libspu/kernel/hal/fxp_approx.h"
+#include "libspu/kernel/hal/fxp_base.h"
+#include "libspu/kernel/hal/public_helper.h"
+#include "libspu/kernel/hal/type_cast.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::kernel::hal {
+
+namespace {
+
+enum class Func : int64_t {
+  Sigmoid = 0,
+  Erf = 1,
+  Gelu = 2,
+  Silu = 3,
+};
+
+xt::xarray<float> reference(Func func, const xt::xarray<float> &x) {
+  switch (func) {
+    case Func::Sigmoid:
+      return 1.0 / (1.0 + xt::exp(-x));
+    case Func::Erf:
+      return xt::erf(x);
+    case Func::Gelu:
+      return 0.5 * x * (1.0 + xt::erf(x / std::sqrt(2.0F)));
+    case Func::Silu:
+      return x / (1.0 + xt::exp(-x));
+  }
+  return {};
+}
+
+// The compositions a model had to use before the piecewise engine.
+Value current(SPUContext *ctx, Func func, const Value &x) {
+  switch (func) {
+    case Func::Sigmoid:
+      return f_sigmoid(ctx, x);
+    case Func::Erf:
+      return f_erf(ctx, x);
+    case Func::Gelu: {
+      auto scaled = f_mul(ctx, x,
+                          constant(ctx, static_cast<float>(M_SQRT1_2),
+                                   x.dtype(), x.shape()));
+      auto phi = f_add(ctx, f_erf(ctx, scaled),
+                       constant(ctx, 1.0F, x.dtype(), x.shape()));
+      return f_mul(ctx, f_mul(ctx, x, phi),
+                   constant(ctx, 0.5F, x.dtype(), x.shape()));
+    }
+    case Func::Silu:
+      return f_mul(ctx, x, f_sigmoid(ctx, x));
+  }
+  return x;
+}
+
+Value piecewise(SPUContext *ctx, Func func, const Value &x) {
+  switch (func) {
+    case Func::Sigmoid:
+      return f_piecewise_polynomial(ctx, x, detail::sigmoid_table());
+    case Func::Erf:
+      return f_piecewise_polynomial(ctx, x, detail::erf_table());
+    case Func::Gelu:
+      return f_gelu(ctx, x);
+    case Func::Silu:
+      return f_silu(ctx, x);
+  }
+  return x;
+}
+
+}  // namespace
+
+// Activation of n elements drawn from [-8, 8], piecewise engine vs. the
+// current implementation (sigmoid in SIGMOID_REAL mode). max_abs_err is
+// measured against a float reference.
+static void BM_Activation(benchmark::State &state) {
+  const auto n = state.range(0);
+  const auto func = static_cast<Func>(state.range(1));
+  const auto prot = static_cast<ProtocolKind>(state.range(2));
+  const bool engine = state.range(3) != 0;
+
+  xt::xarray<float> x =
+      test::xt_random<float>({static_cast<size_t>(n)}, -8, 8);
+  xt::xarray<float> expected = reference(func, x);
+
+  RuntimeConfig conf;
+  conf.set_protocol(prot);
+  conf.set_field(FieldType::FM64);
+  conf.set_sigmoid_mode(RuntimeConfig::SIGMOID_REAL);
+
+  std::atomic<float> max_abs_err = 0;
+  bench::runKernelBench(state, conf, [&](SPUContext *ctx) {
+    auto in = test::makeValue(ctx, x, VIS_SECRET);
+    auto ret = engine ? piecewise(ctx, func, in) : current(ctx, func, in);
+    // The reveal adds the same cost to both variants.
+    auto p_ret = dump_public_as<float>(ctx, reveal(ctx, ret));
+    max_abs_err = xt::amax(xt::abs(p_ret - expected))();
+  });
+  state.counters["max_abs_err"] = max_abs_err;
+}
+
+BENCHMARK(BM_Activation)
+    ->ArgNames({"n", "func", "prot", "engine"})
+    ->ArgsProduct({
+        {1 << 10, 1 << 16},                          // numel
+        {0, 1, 2, 3},                                // sigmoid/erf/gelu/silu
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3},  // protocol
+        {0, 1},                                      // engine
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+}  // namespace spu::kernel::hal
+
+BENCHMARK_MAIN();
@@ -16,10 +16,13 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xio.hpp"
+#include "xtensor/xview.hpp"
 
 #include "libspu/kernel/hal/constants.h"
+#include "libspu/kernel/hal/shape_ops.h"
 #include "libspu/kernel/hal/type_cast.h"
 #include "libspu/kernel/test_util.h"
+#include "libspu/mpc/common/communicator.h"
 #include "libspu/mpc/utils/simulate.h"
 
 namespace spu::kernel::hal {
@@ -535,4 +538,169 @@ TEST(FxpTest, Asin) {
   }
 }
 
+TEST(FxpTest, PolynomialRounds) {
+  const int64_t kNumel = 64;
+  xt::xarray<float> x = xt::linspace<float>(-1.0, 1.0, kNumel);
+
+  // taylor series of exp(x) with degree 16.
+  std::vector<float> coeffs{1.0};
+  for (size_t i = 1; i <= 16; i++) {
+    coeffs.push_back(coeffs.back() / i);
+  }
+  const int64_t kTerms = 9;
+
+  spu::mpc::utils::simulate(3, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    RuntimeConfig conf;
+    conf.set_protocol(ProtocolKind::ABY3);
+    conf.set_field(FieldType::FM64);
+    SPUContext ctx = test::makeSPUContext(conf, lctx);
+    auto* comm = ctx.getState<mpc::Communicator>();
+
+    Value a = test::makeValue(&ctx, x, VIS_SECRET);
+
+    auto stats = comm->getStats();
+    f_mul(&ctx, a, a);
+    const auto mul_cost = comm->getStats() - stats;
+
+    stats = comm->getStats();
+    Value c = detail::polynomial(&ctx, a, coeffs);
+    const auto poly_cost = comm->getStats() - stats;
+
+    Value row = reshape(&ctx, a, {1, kNumel});
+    stats = comm->getStats();
+    Value t = detail::compute_chebyshev_polynomials(&ctx, row, kTerms);
+    const auto cheb_cost = comm->getStats() - stats;
+
+    // Computing every power takes 15 multiplications and truncations plus
+    // the final one, Paterson-Stockmeyer about 10.
+    EXPECT_LT(poly_cost.comm, 12 * mul_cost.comm);
+    // The three-term recurrence takes one multiplication round per term,
+    // doubling the known terms takes 1 + ceil(log2(terms)).
+    EXPECT_LT(cheb_cost.latency, 7 * mul_cost.latency);
+
+    auto y = dump_public_as<float>(&ctx, reveal(&ctx, c));
+    EXPECT_TRUE(xt::allclose(xt::exp(x), y, 0.01, 0.001))
+        << xt::exp(x) << std::endl
+        << y;
+
+    auto z = dump_public_as<float>(&ctx, reveal(&ctx, t));
+    xt::xarray<float> expected = xt::zeros<float>({kTerms, kNumel});
+    for (int64_t i = 0; i < kTerms; i++) {
+      xt::row(expected, i) = xt::cos(static_cast<float>(2 * i + 1) * xt::acos(x));
+    }
+    EXPECT_TRUE(xt::allclose(expected, z, 0.01, 0.01))
+        << expected << std::endl
+        << z;
+  });
+}
+
+TEST(FxpTest, LogPolynomialRounds) {
+  xt::xarray<float> x = xt::linspace<float>(1.0, 2.0, 64);
+
+  spu::mpc::utils::simulate(3, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    RuntimeConfig conf;
+    conf.set_protocol(ProtocolKind::ABY3);
+    conf.set_field(FieldType::FM64);
+    SPUContext ctx = test::makeSPUContext(conf, lctx);
+    auto* comm = ctx.getState<mpc::Communicator>();
+
+    Value a = test::makeValue(&ctx, x, VIS_SECRET);
+
+    auto stats = comm->getStats();
+    f_mul(&ctx, a, a);
+    const auto mul_cost = comm->getStats() - stats;
+
+    stats = comm->getStats();
+    Value c = detail::log_minmax_normalized(&ctx, a);
+    const auto log_cost = comm->getStats() - stats;
+
+    // Computing every power of the degree 8 polynomial takes 7
+    // multiplications and truncations plus the final one,
+    // Paterson-Stockmeyer 5 multiplications and 6 truncations.
+    EXPECT_LT(log_cost.comm, 7 * mul_cost.comm);
+
+    auto y = dump_public_as<float>(&ctx, reveal(&ctx, c));
+    EXPECT_TRUE(xt::allclose(xt::log(x), y, 0.01, 0.001))
+        << xt::log(x) << std::endl
+        << y;
+  });
+}
+
+TEST(FxpTest, PiecewisePolynomial) {
+  // GIVEN
+  SPUContext ctx = test::makeSPUContext();
+
+  xt::xarray<float> x = xt::linspace<float>(-16.0, 16.0, 257);
+  xt::xarray<float> gelu = 0.5 * x * (1.0 + xt::erf(x / std::sqrt(2.0F)));
+  xt::xarray<float> sigmoid = 1.0 / (1.0 + xt::exp(-x));
+
+  auto check = [&](const PiecewisePolynomial& pp, const xt::xarray<float>& r) {
+    // public
+    {
+      Value a = constant(&ctx, x, DT_F32);
+      Value c = f_piecewise_polynomial(&ctx, a, pp);
+      EXPECT_EQ(c.dtype(), DT_F32);
+
+      auto y = dump_public_as<float>(&ctx, c);
+      EXPECT_TRUE(xt::allclose(r, y, 0.0, 0.002)) << r << std::endl << y;
+    }
+    // secret
+    {
+      Value a = test::makeValue(&ctx, x, VIS_SECRET);
+      Value c = f_piecewise_polynomial(&ctx, a, pp);
+      EXPECT_EQ(c.dtype(), DT_F32);
+
+      auto y = dump_public_as<float>(&ctx, reveal(&ctx, c));
+      EXPECT_TRUE(xt::allclose(r, y, 0.0, 0.002)) << r << std::endl << y;
+    }
+  };
+
+  check(detail::sigmoid_table(), sigmoid);
+  check(detail::erf_table(), xt::erf(x));
+  check(detail::gelu_table(), gelu);
+  check(detail::silu_table(), x * sigmoid);
+
+  {
+    Value a = test::makeValue(&ctx, x, VIS_SECRET);
+    auto y = dump_public_as<float>(&ctx, reveal(&ctx, f_gelu(&ctx, a)));
+    EXPECT_TRUE(xt::allclose(gelu, y, 0.0, 0.002)) << gelu << std::endl << y;
+    auto z = dump_public_as<float>(&ctx, reveal(&ctx, f_silu(&ctx, a)));
+    EXPECT_TRUE(xt::allclose(x * sigmoid, z, 0.0, 0.002))
+        << x * sigmoid << std::endl
+        << z;
+  }
+}
+
+TEST(FxpTest, PiecewiseSigmoidRounds) {
+  xt::xarray<float> x = xt::linspace<float>(-10.0, 10.0, 64);
+  xt::xarray<float> expected = 1.0 / (1.0 + xt::exp(-x));
+
+  spu::mpc::utils::simulate(3, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    auto rounds = [&](RuntimeConfig::SigmoidMode mode, float atol) {
+      RuntimeConfig conf;
+      conf.set_protocol(ProtocolKind::ABY3);
+      conf.set_field(FieldType::FM64);
+      conf.set_sigmoid_mode(mode);
+      SPUContext ctx = test::makeSPUContext(conf, lctx);
+
+      Value a = test::makeValue(&ctx, x, VIS_SECRET);
+      auto *comm = ctx.getState<mpc::Communicator>();
+      auto before = comm->getStats();
+      Value c = f_sigmoid(&ctx, a);
+      size_t latency = (comm->getStats() - before).latency;
+
+      auto y = dump_public_as<float>(&ctx, reveal(&ctx, c));
+      EXPECT_TRUE(xt::allclose(expected, y, 0.0, atol))
+          << expected << std::endl
+          << y;
+      return latency;
+    };
+
+    size_t piecewise = rounds(RuntimeConfig::SIGMOID_PIECEWISE, 0.002);
+    size_t real = rounds(RuntimeConfig::SIGMOID_REAL, 0.01);
+    EXPECT_LT(piecewise, real)
+        << "sigmoid rounds, piecewise: " << piecewise << ", real: " << real;
+  });
+}
+
 }  // namespace spu::kernel::hal
@@ -14,10 +14,12 @@
 
 #include "libspu/kernel/hal/fxp_base.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "libspu/core/prelude.h"
 #include "libspu/core/trace.h"
+#include "libspu/core/vectorize.h"
 #include "libspu/kernel/hal/constants.h"
 #include "libspu/kernel/hal/fxp_cleartext.h"
 #include "libspu/kernel/hal/ring.h"
@@ -25,18 +27,17 @@
 namespace spu::kernel::hal {
 namespace detail {
 
-// Calc:
-//   y = c0 + x*c1 + x^2*c2 + x^3*c3 + ... + x^n*c[n]
-Value polynomial(SPUContext* ctx, const Value& x,
-                 absl::Span<Value const> coeffs, SignType sign_x,
-                 SignType sign_ret) {
-  SPU_TRACE_HAL_DISP(ctx, x);
-  SPU_ENFORCE(x.isFxp());
-  SPU_ENFORCE(!coeffs.empty());
+namespace {
 
-  if (coeffs.size() == 1U || x.numel() == 0) {
-    return coeffs[0];
-  }
+// Polynomials of at least this degree are evaluated with Paterson-Stockmeyer
+// splitting, e.g. the degree 8 log and degree 10 atan approximations. It takes
+// about two more rounds than computing every power, but at degree 8 already
+// saves two of seven secret multiplications.
+constexpr size_t kPatersonStockmeyerMinDegree = 8;
+
+// Calc x, x^2, x^3, ..., x^n.
+std::vector<Value> computePowers(SPUContext* ctx, const Value& x, size_t n,
+                                 SignType sign_x) {
   // Use a parallel circuit to calculate x, x^2, x^3, ..., x^n.
   // The general log(n) algorithm
   // algorithm:
@@ -45,9 +46,8 @@ Value polynomial(SPUContext* ctx, const Value& x,
   //  Step 2. x, x2, x3, x4
   //  ...
   std::vector<spu::Value> x_prefix(1, x);
-  size_t degree = coeffs.size() - 1;
-  for (int64_t i = 0; i < Log2Ceil(degree); ++i) {
-    size_t x_size = std::min(x_prefix.size(), degree - x_prefix.size());
+  for (int64_t i = 0; i < Log2Ceil(n); ++i) {
+    size_t x_size = std::min(x_prefix.size(), n - x_prefix.size());
     std::vector<spu::Value> x_pow(x_size, x_prefix.back());
     // TODO: this can be further optimized to use sign hint
     vmap(x_prefix.begin(), x_prefix.begin() + x_size, x_pow.begin(),
@@ -56,13 +56,111 @@ Value polynomial(SPUContext* ctx, const Value& x,
            return f_mul(ctx, a, b, sign_x);
          });
   }
+  return x_prefix;
+}
 
+// Calc c0 + x*c1 + ... + x^(n-1)*c[n-1] without truncation, where x_prefix
+// holds x, x^2, ..., x^(n-1).
+Value sumTerms(SPUContext* ctx, absl::Span<Value const> x_prefix,
+               absl::Span<Value const> coeffs) {
+  const auto& x = x_prefix.front();
   Value res = _mul(ctx, constant(ctx, 1.0F, x.dtype(), x.shape()), coeffs[0]);
-
-  const auto fbits = ctx->getFxpBits();
+  const auto packable = [&](const Value& v) {
+    return v.storage_type() == coeffs[1].storage_type() &&
+           v.dtype() == coeffs[1].dtype() && v.shape() == x.shape();
+  };
+  if (coeffs.size() > 2 && coeffs[1].isSecret() &&
+      std::all_of(coeffs.begin() + 1, coeffs.end(), packable) &&
+      std::all_of(x_prefix.begin(), x_prefix.begin() + coeffs.size() - 1,
+                  [&](const Value& v) {
+                    return v.storage_type() == x.storage_type() &&
+                           v.dtype() == x.dtype() && v.shape() == x.shape();
+                  })) {
+    // Secret coefficients, e.g. selected per segment, pack all terms into one
+    // multiplication.
+    std::vector<Value> terms;
+    vmap(x_prefix.begin(), x_prefix.begin() + coeffs.size() - 1,
+         coeffs.begin() + 1, coeffs.end(), std::back_inserter(terms),
+         [ctx](const Value& a, const Value& b) { return _mul(ctx, a, b); });
+    for (const auto& term : terms) {
+      res = _add(ctx, res, term);
+    }
+    return res;
+  }
   for (size_t i = 1; i < coeffs.size(); i++) {
     res = _add(ctx, res, _mul(ctx, x_prefix[i - 1], coeffs[i]));
   }
+  return res;
+}
+
+// Paterson-Stockmeyer, split the polynomial into m blocks of k ~ sqrt(n)
+// terms
+//   y = p_0(x) + p_1(x) * x^k + ... + p_{m-1}(x) * x^(k(m-1))
+// the blocks only multiply x, ..., x^(k-1) with public coefficients, so the
+// secret multiplications drop from n - 1 to about 3 * sqrt(n).
+Value polynomialPS(SPUContext* ctx, const Value& x,
+                   absl::Span<Value const> coeffs, SignType sign_x,
+                   SignType sign_ret) {
+  const size_t degree = coeffs.size() - 1;
+  const auto k = static_cast<size_t>(std::ceil(std::sqrt(degree + 1)));
+  const size_t m = (coeffs.size() + k - 1) / k;
+
+  // x, ..., x^k and x^k, x^2k, ..., x^(k(m-1))
+  auto x_prefix = computePowers(ctx, x, k, sign_x);
+  auto y_prefix = computePowers(ctx, x_prefix.back(), m - 1, sign_x);
+
+  const auto fbits = ctx->getFxpBits();
+  Value res = sumTerms(ctx, x_prefix, coeffs.subspan(0, k));
+
+  std::vector<Value> blocks;
+  for (size_t j = 1; j < m; j++) {
+    blocks.push_back(sumTerms(ctx, x_prefix, coeffs.subspan(j * k, k)));
+  }
+  std::vector<Value> blocks_trunc;
+  vmap(blocks.begin(), blocks.end(), std::back_inserter(blocks_trunc),
+       [&](const Value& b) {
+         return _trunc(ctx, b, fbits, SignType::Unknown).setDtype(x.dtype());
+       });
+
+  // one batched multiplication, truncation is deferred to the final sum.
+  std::vector<Value> terms;
+  vmap(blocks_trunc.begin(), blocks_trunc.end(), y_prefix.begin(),
+       y_prefix.end(), std::back_inserter(terms),
+       [ctx](const Value& a, const Value& b) { return _mul(ctx, a, b); });
+  for (const auto& term : terms) {
+    res = _add(ctx, res, term);
+  }
+
+  return _trunc(ctx, res, fbits, sign_ret).setDtype(x.dtype());
+}
+
+}  // namespace
+
+// Calc:
+//   y = c0 + x*c1 + x^2*c2 + x^3*c3 + ... + x^n*c[n]
+Value polynomial(SPUContext* ctx, const Value& x,
+                 absl::Span<Value const> coeffs, SignType sign_x,
+                 SignType sign_ret) {
+  SPU_TRACE_HAL_DISP(ctx, x);
+  SPU_ENFORCE(x.isFxp());
+  SPU_ENFORCE(!coeffs.empty());
+
+  if (coeffs.size() == 1U || x.numel() == 0) {
+    return coeffs[0];
+  }
+
+  size_t degree = coeffs.size() - 1;
+  const bool public_coeffs = std::all_of(
+      coeffs.begin(), coeffs.end(), [](const Value& c) { return c.isPublic(); });
+  if (degree >= kPatersonStockmeyerMinDegree && public_coeffs &&
+      !x.isPublic()) {
+    return polynomialPS(ctx, x, coeffs, sign_x, sign_ret);
+  }
+
+  auto x_prefix = computePowers(ctx, x, degree, sign_x);
+
+  const auto fbits = ctx->getFxpBits();
+  auto res = sumTerms(ctx, x_prefix, coeffs);
 
   return _trunc(ctx, res, fbits, sign_ret).setDtype(x.dtype());
 }
@@ -280,4 +280,27 @@ TEST(FxpTest, Ceil) {
   }
 }
 
+TEST(FxpTest, PolynomialPatersonStockmeyer) {
+  // GIVEN
+  SPUContext ctx = test::makeSPUContext();
+
+  xt::xarray<float> x = xt::linspace<float>(-1.0, 1.0, 32);
+
+  // taylor series of exp(x) with degree 16, which is evaluated with
+  // Paterson-Stockmeyer splitting.
+  std::vector<float> coeffs{1.0};
+  for (size_t i = 1; i <= 16; i++) {
+    coeffs.push_back(coeffs.back() / i);
+  }
+
+  Value a = test::makeValue(&ctx, x, VIS_SECRET);
+  Value c = detail::polynomial(&ctx, a, coeffs);
+  EXPECT_EQ(c.dtype(), DT_F32);
+
+  auto y = dump_public_as<float>(&ctx, reveal(&ctx, c));
+  EXPECT_TRUE(xt::allclose(xt::exp(x), y, 0.01, 0.001))
+      << xt::exp(x) << std::endl
+      << y;
+}
+
 }  // namespace spu::kernel::hal
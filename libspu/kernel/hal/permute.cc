@@ -15,6 +15,7 @@
 #include "libspu/kernel/hal/permute.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "libspu/core/bit_utils.h"
 #include "libspu/core/context.h"
@@ -197,12 +198,21 @@ Value _permute_1d(SPUContext *, const Value &x, const Index &indices) {
   return Value(x.data().linear_gather(indices), x.dtype());
 }
 
+// Prefix sum of each row of matrix x.
 Value _prefix_sum(SPUContext *ctx, const Value &x) {
-  SPU_ENFORCE(x.shape().ndim() == 2U && x.shape()[0] == 1,
-              "x should be 1-row matrix");
-  auto x_v = hal::reshape(ctx, x, {x.numel()});
-  auto ret = hal::associative_scan(hal::_add, ctx, x_v);
-  return hal::reshape(ctx, ret, {1, x.numel()});
+  SPU_ENFORCE(x.shape().ndim() == 2U, "x should be a matrix");
+  return hal::associative_scan(hal::_add, ctx, x);
+}
+
+// Public offsets of a flattened (num_rows, W) tensor, i.e. ret[i] = i / W * W.
+Value _row_offsets(SPUContext *ctx, int64_t num_rows, int64_t W) {
+  std::vector<int64_t> offsets(num_rows * W);
+  for (int64_t i = 0; i < num_rows * W; ++i) {
+    offsets[i] = i / W * W;
+  }
+  auto dt =
+      ctx->config().field() == FieldType::FM32 ? spu::DT_I32 : spu::DT_I64;
+  return constant(ctx, offsets, dt, {num_rows * W});
 }
 
 void _cmp_swap(SPUContext *ctx, const CompFn &comparator_body,
@@ -234,31 +244,13 @@ void _cmp_swap(SPUContext *ctx, const CompFn &comparator_body,
   }
 }
 
-// Secure Odd-even mergesort
-// Ref:
-// https://hwlang.de/algorithmen/sortieren/networks/oemen.htm
-std::vector<spu::Value> odd_even_merge_sort(
-    SPUContext *ctx, const CompFn &comparator_body,
-    absl::Span<spu::Value const> inputs) {
-  // make a copy for inplace sort
-  std::vector<spu::Value> ret;
-  for (auto const &input : inputs) {
-    spu::Value casted;
-    if (!input.isSecret()) {
-      // we can not linear_scatter a secret value to a public operand
-      casted = _2s(ctx, input.clone()).setDtype(input.dtype());
-    } else {
-      casted = input.clone();
-    }
-    // we can not linear_scatter an ashare value to a bshare operand
-    casted = _prefer_a(ctx, casted);
-    ret.emplace_back(std::move(casted));
-  }
-
-  // sort by per network layer for memory optimizations, sorting N elements
-  // needs log2(N) stages, and the i_th stage has i layers, which means the
-  // same latency cost as BitonicSort but less _cmp_swap unit.
-  const auto n = inputs.front().numel();
+// Index pairs of each layer of the odd-even merge sorting network on n
+// elements.
+//
+// The network on m > n elements without the comparators touching the last
+// m - n lanes also sorts n elements, as if these lanes held the last values.
+std::vector<std::pair<Index, Index>> _odd_even_merge_layers(int64_t n) {
+  std::vector<std::pair<Index, Index>> layers;
   for (int64_t max_gap_in_stage = 1; max_gap_in_stage < n;
        max_gap_in_stage += max_gap_in_stage) {
     for (int64_t step = max_gap_in_stage; step > 0; step /= 2) {
@@ -282,10 +274,58 @@ std::vector<spu::Value> odd_even_merge_sort(
         }
       }
 
-      _cmp_swap(ctx, comparator_body, absl::MakeSpan(ret), lhs_indices,
-                rhs_indices);
+      layers.emplace_back(std::move(lhs_indices), std::move(rhs_indices));
     }
   }
+  return layers;
+}
+
+// Secure Odd-even mergesort
+// Ref:
+// https://hwlang.de/algorithmen/sortieren/networks/oemen.htm
+//
+// The inputs may hold num_rows independent rows of equal length back to back,
+// every network layer then compares and swaps the same lanes of all rows at
+// once, so the rounds are the same as sorting a single row.
+std::vector<spu::Value> odd_even_merge_sort(SPUContext *ctx,
+                                            const CompFn &comparator_body,
+                                            absl::Span<spu::Value const> inputs,
+                                            int64_t num_rows = 1) {
+  // make a copy for inplace sort
+  std::vector<spu::Value> ret;
+  for (auto const &input : inputs) {
+    spu::Value casted;
+    if (!input.isSecret()) {
+      // we can not linear_scatter a secret value to a public operand
+      casted = _2s(ctx, input.clone()).setDtype(input.dtype());
+    } else {
+      casted = input.clone();
+    }
+    // we can not linear_scatter an ashare value to a bshare operand
+    casted = _prefer_a(ctx, casted);
+    ret.emplace_back(std::move(casted));
+  }
+
+  // sort by per network layer for memory optimizations, sorting N elements
+  // needs log2(N) stages, and the i_th stage has i layers, which means the
+  // same latency cost as BitonicSort but less _cmp_swap unit.
+  SPU_ENFORCE(num_rows > 0 && inputs.front().numel() % num_rows == 0,
+              "numel {} is not divisible by num_rows {}",
+              inputs.front().numel(), num_rows);
+  const auto n = inputs.front().numel() / num_rows;
+  for (auto [lhs_indices, rhs_indices] : _odd_even_merge_layers(n)) {
+    // the same pairs for the other rows.
+    const auto num_pairs = static_cast<int64_t>(lhs_indices.size());
+    for (int64_t row = 1; row < num_rows; ++row) {
+      for (int64_t k = 0; k < num_pairs; ++k) {
+        lhs_indices.emplace_back(lhs_indices[k] + row * n);
+        rhs_indices.emplace_back(rhs_indices[k] + row * n);
+      }
+    }
+
+    _cmp_swap(ctx, comparator_body, absl::MakeSpan(ret), lhs_indices,
+              rhs_indices);
+  }
 
   return ret;
 }
@@ -562,16 +602,15 @@ void mergesort(SPUContext *ctx, const CompFn &comparator_body,
   }
 }
 
-std::vector<spu::Value> QuickMergesort(SPUContext *ctx, const int64_t num_keys,
-                                       const CompFn &quick_comp,
-                                       const CompFn &merge_comp,
-                                       absl::Span<spu::Value const> inputs) {
+// Sorts every interval of the shuffled inputs on its own, all intervals are
+// partitioned together.
+std::vector<spu::Value> QuickMergesort(
+    SPUContext *ctx, const int64_t num_keys, const CompFn &quick_comp,
+    const CompFn &merge_comp, absl::Span<spu::Value const> inputs,
+    std::vector<std::pair<int64_t, int64_t>> intervals) {
   // we do not need to copy or _2s here because of the secret shuffling.
   std::vector<spu::Value> ret(inputs.begin(), inputs.end());
 
-  const auto n = inputs.front().numel();
-  std::vector<std::pair<int64_t, int64_t>> intervals;
-  intervals.emplace_back(0, n - 1);
   int64_t quicksort_num = 0;
   // set max depth to avoid infinite loop
   int64_t depth = 1000;
@@ -621,7 +660,8 @@ std::vector<spu::Value> quick_sort(SPUContext *ctx,
   // in merge sort stage, only normal keys are used for comparison
   auto merge_comp = _get_cmp_func(ctx, num_keys, direction);
   auto ret = QuickMergesort(ctx, num_keys, quick_comp, merge_comp,
-                            absl::MakeSpan(inp));
+                            absl::MakeSpan(inp),
+                            {{0, inputs.front().numel() - 1}});
   return ret;
 }
 
@@ -761,6 +801,178 @@ std::vector<spu::Value> PrepareInput(SPUContext *ctx, const Value &input,
   return inp;
 }
 
+// The largest k for which topk prefers the tournament over quick select.
+constexpr int64_t kMaxTournamentTopK = 32;
+// The tournament is chosen only when k is small compared to the row length.
+constexpr int64_t kMinTournamentRowsPerK = 8;
+
+TopKMethod _resolve_topk_method(SPUContext *ctx, int64_t n,
+                                const TopKConfig &config) {
+  if (config.method == TopKMethod::Tournament) {
+    return TopKMethod::Tournament;
+  }
+  // without shuffles, quick select falls back to a full sort which is never
+  // cheaper than the tournament.
+  if (!ctx->hasKernel("rand_perm_m") || !ctx->hasKernel("perm_am")) {
+    return TopKMethod::Tournament;
+  }
+  if (config.method == TopKMethod::QuickSelect) {
+    return TopKMethod::QuickSelect;
+  }
+  return config.k_hi <= kMaxTournamentTopK &&
+                 n >= kMinTournamentRowsPerK * config.k_hi
+             ? TopKMethod::Tournament
+             : TopKMethod::QuickSelect;
+}
+
+// Tournament topk of each row of a 2-D input.
+//
+// Let K be k rounded up to a power of 2. Each row is cut into groups of K
+// elements (the last one may be shorter), and all groups of all rows are
+// sorted by one odd-even merge network. Then neighbouring candidate lists
+// are merged level by level until one list is left per row. Merging sorted
+// lists A and B takes c[i] = best(A[i], B[K - 1 - i]), which holds the top K
+// of both as a bitonic sequence, and sorts c by a bitonic merge of log(K)
+// layers. All merges of one level are done together, so the whole topk costs
+// O(log(K) * log(n / K) + log(K)^2) comparison rounds without any shuffle.
+//
+// The results are sorted, which satisfies both k_lo and k_hi of config.
+std::vector<spu::Value> tournament_topk(SPUContext *ctx,
+                                        const spu::Value &input,
+                                        const SimpleCompFn &scalar_cmp,
+                                        const TopKConfig &config) {
+  SPU_ENFORCE(input.shape().ndim() == 2);
+  const int64_t N = input.shape().dim(0);
+  const int64_t n = input.shape().dim(1);
+  const int64_t K = int64_t{1} << Log2Ceil(config.k_hi);
+
+  auto dt =
+      ctx->config().field() == FieldType::FM32 ? spu::DT_I32 : spu::DT_I64;
+  std::vector<spu::Value> arr;
+  arr.push_back(hal::reshape(ctx, input, {N * n}));
+  if (!config.value_only) {
+    std::vector<int64_t> indices(N * n);
+    for (int64_t i = 0; i < N * n; ++i) {
+      indices[i] = i % n;
+    }
+    arr.push_back(constant(ctx, indices, dt, {N * n}));
+  }
+  for (auto &item : arr) {
+    auto dtype = item.dtype();
+    // we can not linear_scatter a secret value to a public operand, nor an
+    // ashare value to a bshare operand
+    item = _prefer_a(ctx, _2s(ctx, item).setDtype(dtype));
+  }
+
+  hal::CompFn comp_fn =
+      [ctx, &scalar_cmp](absl::Span<const spu::Value> values) -> spu::Value {
+    return scalar_cmp(ctx, values[0], values[1]);
+  };
+
+  // candidate lists of a row as (offset, length), the same for all rows.
+  std::vector<std::pair<int64_t, int64_t>> groups;
+  for (int64_t offset = 0; offset < n; offset += K) {
+    groups.emplace_back(offset, std::min(K, n - offset));
+  }
+  int64_t width = n;
+
+  // 1. sort all groups.
+  for (const auto &[lhs, rhs] : _odd_even_merge_layers(std::min(K, n))) {
+    Index lhs_indices;
+    Index rhs_indices;
+    for (int64_t row = 0; row < N; ++row) {
+      for (const auto &[offset, len] : groups) {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+          if (rhs[i] < len) {
+            lhs_indices.emplace_back(row * width + offset + lhs[i]);
+            rhs_indices.emplace_back(row * width + offset + rhs[i]);
+          }
+        }
+      }
+    }
+    _cmp_swap(ctx, comp_fn, absl::MakeSpan(arr), lhs_indices, rhs_indices);
+  }
+
+  // 2. merge neighbouring groups until one is left.
+  while (groups.size() > 1) {
+    std::vector<std::pair<int64_t, int64_t>> merged;
+    Index gather_indices;  // A or the unpaired group
+    Index lhs_indices;     // lanes of A to compare
+    Index rhs_indices;     // lanes of B to compare
+    Index dst_indices;     // where the compared lanes go
+    int64_t merged_width = 0;
+    for (size_t g = 0; g < groups.size(); g += 2) {
+      merged.emplace_back(merged_width, groups[g].second);
+      merged_width += groups[g].second;
+    }
+    for (int64_t row = 0; row < N; ++row) {
+      for (size_t g = 0; g < groups.size(); g += 2) {
+        const auto [a_offset, a_len] = groups[g];
+        const auto dst = row * merged_width + merged[g / 2].first;
+        for (int64_t i = 0; i < a_len; ++i) {
+          gather_indices.emplace_back(row * width + a_offset + i);
+        }
+        if (g + 1 == groups.size()) {
+          continue;
+        }
+        // A is full, the missing lanes of B are the worst values.
+        const auto [b_offset, b_len] = groups[g + 1];
+        for (int64_t i = K - b_len; i < K; ++i) {
+          lhs_indices.emplace_back(row * width + a_offset + i);
+          rhs_indices.emplace_back(row * width + b_offset + K - 1 - i);
+          dst_indices.emplace_back(dst + i);
+        }
+      }
+    }
+
+    std::vector<spu::Value> values;
+    values.reserve(2 * arr.size());
+    for (const auto &item : arr) {
+      values.emplace_back(item.data().linear_gather(lhs_indices), item.dtype());
+      values.emplace_back(item.data().linear_gather(rhs_indices), item.dtype());
+    }
+    auto predicate = _prefer_a(ctx, comp_fn(values));
+
+    for (size_t i = 0; i < arr.size(); ++i) {
+      auto best = select(ctx, predicate, values[2 * i], values[2 * i + 1]);
+      Value next(arr[i].data().linear_gather(gather_indices), arr[i].dtype());
+      next.data().linear_scatter(best.data(), dst_indices);
+      arr[i] = std::move(next);
+    }
+
+    // bitonic merge of the merged groups, the unpaired group is sorted.
+    const auto num_merged = groups.size() / 2;
+    for (int64_t step = K / 2; step > 0; step /= 2) {
+      Index bitonic_lhs;
+      Index bitonic_rhs;
+      for (int64_t row = 0; row < N; ++row) {
+        for (size_t g = 0; g < num_merged; ++g) {
+          const auto base = row * merged_width + merged[g].first;
+          for (int64_t i = 0; i < K; ++i) {
+            if ((i & step) == 0) {
+              bitonic_lhs.emplace_back(base + i);
+              bitonic_rhs.emplace_back(base + i + step);
+            }
+          }
+        }
+      }
+      _cmp_swap(ctx, comp_fn, absl::MakeSpan(arr), bitonic_lhs, bitonic_rhs);
+    }
+
+    groups = std::move(merged);
+    width = merged_width;
+  }
+
+  std::vector<spu::Value> ret;
+  for (auto &item : arr) {
+    auto dtype = item.dtype();
+    ret.push_back(slice(ctx, reshape(ctx, item, {N, width}), {0, 0},
+                        {N, config.k_hi}, {})
+                      .setDtype(dtype));
+  }
+  return ret;
+}
+
 // Ref: https://eprint.iacr.org/2019/695.pdf
 // Algorithm 13 Optimized inverse application of a permutation
 //
@@ -796,27 +1008,20 @@ std::pair<std::vector<spu::Value>, spu::Value> _opt_apply_inv_perm_ss(
   return {v, m};
 }
 
-// Process two bit vectors in one loop
+// Process multiple bit vectors (a digit) in one loop
 // Reference: https://eprint.iacr.org/2019/695.pdf (5.2 Optimizations)
 //
-// perm = _gen_inv_perm_by_bv(x, y)
-//   input: bit vector x, bit vector y
-//          bit vector y is more significant than x
-//   output: shared inverse permutation
-//
-// We can generate inverse permutation by two bit vectors in one loop.
-// It needs one extra mul op and 2 times memory to store intermediate data
-// than _gen_inv_perm_by_bv. But the number of invocations of
-// permutation-related protocols such as SecureInvPerm or Compose will be
-// reduced to half.
+// perm = _gen_inv_perm_by_digit(bits)
+//   input: d bit vectors of one digit, bits[j] is more significant than
+//          bits[j - 1]
+//   output: shared inverse permutation which stably sorts the digit
 //
-// If we process three bit vectors in one loop, it needs at least four extra
-// mul ops and 2^2 times data to store intermediate data. The number of
-// invocations of permutation-related protocols such as SecureInvPerm or
-// Compose will be reduced to 1/3. It's latency friendly but not bandwidth
-// friendly.
+// Each loop of radix sort costs a few secure shuffles, processing d bits in
+// one loop cuts the number of loops to 1/d. In return, the 2^d one-hot digit
+// indicators take d - 1 extra rounds of mul and 2^d times memory to store
+// intermediate data, see _radix_digit_bits for the trade-off.
 //
-// Example:
+// Example (d = 2):
 //   1) x = [0, 1], y = [1, 0]
 //   2) rev_x = [1, 0], rev_y = [0, 1]
 //   3) f0 = rev_x * rev_y = [0, 0]
@@ -837,24 +1042,62 @@ std::pair<std::vector<spu::Value>, spu::Value> _opt_apply_inv_perm_ss(
 //      r = [2, 1]
 //   8) get res by sub r by one
 //      res = [1, 0]
-spu::Value _gen_inv_perm_by_bv(SPUContext *ctx, const spu::Value &x,
-                               const spu::Value &y) {
-  SPU_ENFORCE(x.shape() == y.shape(), "x and y should has the same shape");
-  SPU_ENFORCE(x.shape().ndim() == 1, "x and y should be 1-d");
+//
+// The indicators are built one bit at a time: given the indicators f of the
+// lower bits and the next bit b, f * b are the indicators with b set and
+// f - f * b those with b unset. The products sum up to b, so the last one is
+// derived by subtraction and each bit costs 2^j - 1 muls in one round.
+//
+// When the bits hold num_rows rows of length W back to back, steps 3) to 7)
+// are done on each row and the row offset is added to the result, so the
+// permutation never moves an element out of its row.
+spu::Value _gen_inv_perm_by_digit(SPUContext *ctx,
+                                  absl::Span<spu::Value const> bits,
+                                  int64_t num_rows = 1) {
+  SPU_ENFORCE(!bits.empty());
+  const auto &shape = bits[0].shape();
+  SPU_ENFORCE(shape.ndim() == 1, "bit vectors should be 1-d");
+  SPU_ENFORCE(std::all_of(bits.begin(), bits.end(),
+                          [&](const Value &b) { return b.shape() == shape; }),
+              "bit vectors should has the same shape");
+
+  const auto k1 = _constant(ctx, 1U, shape);
+
+  // one-hot indicators of the digit formed by bits[0, j)
+  std::vector<spu::Value> ind{_sub(ctx, k1, bits[0]), bits[0]};
+  for (size_t j = 1; j < bits.size(); ++j) {
+    const auto m = static_cast<int64_t>(ind.size());
+    const auto numel = shape.numel();
+    auto prod = _mul(
+        ctx,
+        concatenate(ctx, std::vector<spu::Value>(ind.begin(), ind.end() - 1),
+                    0),
+        concatenate(ctx, std::vector<spu::Value>(m - 1, bits[j]), 0));
+
+    std::vector<spu::Value> hi;
+    hi.reserve(m);
+    auto rest = bits[j];
+    for (int64_t k = 0; k < m - 1; ++k) {
+      hi.push_back(slice(ctx, prod, {k * numel}, {(k + 1) * numel}, {}));
+      rest = _sub(ctx, rest, hi.back());
+    }
+    hi.push_back(std::move(rest));
 
-  const auto k1 = _constant(ctx, 1U, x.shape());
-  auto rev_x = _sub(ctx, k1, x);
-  auto rev_y = _sub(ctx, k1, y);
-  auto f0 = _mul(ctx, rev_x, rev_y);
-  auto f1 = _sub(ctx, rev_y, f0);
-  auto f2 = _sub(ctx, rev_x, f0);
-  auto f3 = _sub(ctx, y, f2);
-
-  const auto numel = x.numel();
-  auto f = concatenate(ctx,
-                       {unsqueeze(ctx, f0), unsqueeze(ctx, f1),
-                        unsqueeze(ctx, f2), unsqueeze(ctx, f3)},
-                       1);
+    std::vector<spu::Value> next;
+    next.reserve(2 * m);
+    for (int64_t k = 0; k < m; ++k) {
+      next.push_back(_sub(ctx, ind[k], hi[k]));
+    }
+    next.insert(next.end(), hi.begin(), hi.end());
+    ind = std::move(next);
+  }
+
+  const auto W = shape.numel() / num_rows;
+  const auto num_buckets = static_cast<int64_t>(ind.size());
+  for (auto &f : ind) {
+    f = reshape(ctx, f, {num_rows, W});
+  }
+  auto f = concatenate(ctx, ind, 1);
 
   // calculate prefix sum
   auto ps = _prefix_sum(ctx, f);
@@ -862,62 +1105,54 @@ spu::Value _gen_inv_perm_by_bv(SPUContext *ctx, const spu::Value &x,
   // mul f and s
   auto fs = _mul(ctx, f, ps);
 
-  auto fs0 = slice(ctx, fs, {0, 0}, {1, numel}, {});
-  auto fs1 = slice(ctx, fs, {0, numel}, {1, 2 * numel}, {});
-  auto fs2 = slice(ctx, fs, {0, 2 * numel}, {1, 3 * numel}, {});
-  auto fs3 = slice(ctx, fs, {0, 3 * numel}, {1, 4 * numel}, {});
-
   // calculate result
-  auto s01 = _add(ctx, fs0, fs1);
-  auto s23 = _add(ctx, fs2, fs3);
-  auto r = _add(ctx, s01, s23);
-  auto res = _sub(ctx, reshape(ctx, r, x.shape()), k1);
-
+  auto r = slice(ctx, fs, {0, 0}, {num_rows, W}, {});
+  for (int64_t k = 1; k < num_buckets; ++k) {
+    r = _add(ctx, r, slice(ctx, fs, {0, k * W}, {num_rows, (k + 1) * W}, {}));
+  }
+  auto res = _sub(ctx, reshape(ctx, r, shape), k1);
+  if (num_rows > 1) {
+    res = _add(ctx, res, _row_offsets(ctx, num_rows, W));
+  }
   return res;
 }
 
-// Generate perm by bit vector
-//   input: bit vector generated by bit decomposition
-//   output: shared inverse permutation
+// Choose the number of bits processed in one loop of radix sort.
 //
-// Example:
-//   1) x = [1, 0, 1, 0, 0]
-//   2) rev_x = [0, 1, 0, 1, 1]
-//   3) f = [rev_x, x]
-//      f = [0, 1, 0, 1, 1, 1, 0, 1, 0, 0]
-//   4) s[i] = s[i - 1] + f[i], s[0] = f[0]
-//      s = [0, 1, 1, 2, 3, 4, 4, 5, 5, 5]
-//   5) fs = f * s
-//      fs = [0, 1, 0, 2, 3, 4, 0, 5, 0, 0]
-//   6) split fs to two vector
-//      fsv[0] = [0, 1, 0, 2, 3]
-//      fsv[1] = [4, 0, 5, 0, 0]
-//   7) r = fsv[0] + fsv[1]
-//      r = [4, 1, 5, 2, 3]
-//   8) get res by sub r by one
-//      res = [3, 0, 4, 1, 2]
-spu::Value _gen_inv_perm_by_bv(SPUContext *ctx, const spu::Value &x) {
-  SPU_ENFORCE(x.shape().ndim() == 1, "x should be 1-d");
-
-  const auto k1 = _constant(ctx, 1U, x.shape());
-  auto rev_x = _sub(ctx, k1, x);
-
-  const auto numel = x.numel();
-  auto f = concatenate(ctx, {unsqueeze(ctx, rev_x), unsqueeze(ctx, x)}, 1);
-
-  // calculate prefix sum
-  auto ps = _prefix_sum(ctx, f);
-
-  // mul f and s
-  auto fs = _mul(ctx, f, ps);
-
-  auto fs0 = slice(ctx, fs, {0, 0}, {1, numel}, {});
-  auto fs1 = slice(ctx, fs, {0, numel}, {1, 2 * numel}, {});
-
-  // calculate result
-  auto r = _add(ctx, fs0, fs1);
-  auto res = _sub(ctx, reshape(ctx, r, x.shape()), k1);
-  return res;
+// One loop over d bits of n elements costs (see _gen_inv_perm_s)
+//   - d + 2 secure shuffles, each runs world_size rounds of 2 messages of n
+//     elements,
+//   - 2^(d+1) - d - 1 muls of n elements in d rounds.
+// The latency of a round is counted as kRoundCostElements elements on wire,
+// and the width minimizing the total cost of all loops is chosen.
+int64_t _radix_digit_bits(SPUContext *ctx, int64_t nbits, int64_t numel) {
+  constexpr int64_t kMaxDigitBits = 4;
+  // ~1ms of latency on a 1Gbps link, in 64-bit elements.
+  constexpr double kRoundCostElements = 16384.0;
+
+  const auto world_size =
+      ctx->lctx() ? static_cast<int64_t>(ctx->lctx()->WorldSize()) : 1;
+  // elements sent per multiplied element.
+  const double mul_comm =
+      ctx->config().protocol() == ProtocolKind::ABY3 ? 1.0 : 2.0;
+  const double shuffle_comm = 2.0 * world_size;
+  const double shuffle_rounds = 2.0 * world_size;
+
+  int64_t best_bits = 1;
+  double best_cost = std::numeric_limits<double>::max();
+  for (int64_t d = 1; d <= std::min(kMaxDigitBits, nbits); ++d) {
+    const double muls = static_cast<double>((int64_t{1} << (d + 1)) - d - 1);
+    const double rounds = (d + 2) * shuffle_rounds + 1 + d;
+    const double comm = ((d + 2) * shuffle_comm + muls * mul_comm) *
+                        static_cast<double>(numel);
+    const double cost = static_cast<double>((nbits + d - 1) / d) *
+                        (rounds * kRoundCostElements + comm);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_bits = d;
+    }
+  }
+  return best_bits;
 }
 
 // Ref: https://eprint.iacr.org/2019/695.pdf
@@ -971,6 +1206,16 @@ std::vector<spu::Value> _bit_decompose(SPUContext *ctx, const spu::Value &x,
   return rets_a;
 }
 
+// Whether the high bits of x are known to be zero, i.e. x is a boolean share
+// hinted with fewer bits than the ring (see hintNumberOfBits).
+bool _has_known_zero_high_bits(SPUContext *ctx, const spu::Value &x) {
+  if (!x.storage_type().isa<BShare>()) {
+    return false;
+  }
+  const auto nbits = x.storage_type().as<BShare>()->nbits();
+  return nbits < SizeOf(ctx->config().field()) * 8;
+}
+
 // Generate vector of bit decomposition of sorting keys
 std::vector<spu::Value> _gen_bv_vector(SPUContext *ctx,
                                        absl::Span<spu::Value const> keys,
@@ -980,31 +1225,38 @@ std::vector<spu::Value> _gen_bv_vector(SPUContext *ctx,
   const auto k1 = _constant(ctx, 1U, keys[0].shape());
   // keys[0] is the most significant key
   for (size_t i = keys.size(); i > 0; --i) {
-    const auto t = _bit_decompose(ctx, keys[i - 1], valid_bits);
+    const auto &key = keys[i - 1];
+    // The known zero high bits are skipped by _bit_decompose, then the key is
+    // non-negative and the top decomposed bit is not a sign bit.
+    const bool is_unsigned =
+        valid_bits == -1 && _has_known_zero_high_bits(ctx, key);
+    const auto t = _bit_decompose(ctx, key, valid_bits);
 
     SPU_ENFORCE(t.size() > 0);
-    for (size_t j = 0; j < t.size() - 1; j++) {
+    for (size_t j = 0; j < t.size(); j++) {
       // Radix sort is a stable sorting algorithm for the ascending order, if
-      // we flip the bit, then we can get the descending order for stable sort
-      if (direction == SortDirection::Descending) {
+      // we flip the bit, then we can get the descending order for stable sort.
+      // The sign bit is opposite.
+      const bool is_sign = !is_unsigned && j == t.size() - 1;
+      if ((direction == SortDirection::Descending) != is_sign) {
         ret.emplace_back(_sub(ctx, k1, t[j]));
       } else {
         ret.emplace_back(t[j]);
       }
     }
-    // The sign bit is opposite
-    if (direction == SortDirection::Descending) {
-      ret.emplace_back(t.back());
-    } else {
-      ret.emplace_back(_sub(ctx, k1, t.back()));
-    }
   }
   return ret;
 }
 
 // Generate shared inverse permutation by key
+//
+// The keys may hold num_rows rows of equal length back to back. Each row is
+// then sorted on its own, while the shuffles still run over all rows at once:
+// every intermediate permutation keeps the rows in place, so revealing it
+// after a random shuffle leaks nothing more than in the single row case.
 spu::Value _gen_inv_perm_s(SPUContext *ctx, absl::Span<spu::Value const> keys,
-                           SortDirection direction, int64_t valid_bits) {
+                           SortDirection direction, int64_t valid_bits,
+                           int64_t num_rows = 1) {
   // 1. generate bit decomposition vector of keys
   std::vector<spu::Value> bv = _gen_bv_vector(ctx, keys, direction, valid_bits);
   SPU_ENFORCE_GT(bv.size(), 0U);
@@ -1015,25 +1267,16 @@ spu::Value _gen_inv_perm_s(SPUContext *ctx, absl::Span<spu::Value const> keys,
   auto init_perm = iota(ctx, dt, keys[0].numel());
   auto shared_perm = _p2s(ctx, init_perm);
 
-  // 3. generate shared inverse permutation by bit vector and process
-  size_t bv_size = bv.size();
-  size_t bv_idx = 0;
-  for (; bv_idx < bv_size - 1; bv_idx += 2) {
-    // generate random permutation for shuffle
-    auto random_perm = hal::_rand_perm_s(ctx, keys[0].shape());
-    auto [shuffled_bv, shuffled_perm] = _opt_apply_inv_perm_ss(
-        ctx, std::vector<spu::Value>{bv[bv_idx], bv[bv_idx + 1]}, shared_perm,
-        random_perm);
-    auto perm = _gen_inv_perm_by_bv(ctx, shuffled_bv[0], shuffled_bv[1]);
-    shared_perm = _opt_apply_perm_ss(ctx, perm, shuffled_perm, random_perm);
-  }
-
-  if (bv_idx == bv_size - 1) {
+  // 3. generate shared inverse permutation by digits of bit vector and process
+  const auto bv_size = static_cast<int64_t>(bv.size());
+  const auto digit_bits = _radix_digit_bits(ctx, bv_size, keys[0].numel());
+  for (int64_t bv_idx = 0; bv_idx < bv_size; bv_idx += digit_bits) {
+    const auto digit = absl::MakeConstSpan(bv).subspan(bv_idx, digit_bits);
     // generate random permutation for shuffle
     auto random_perm = hal::_rand_perm_s(ctx, keys[0].shape());
-    auto [shuffled_bv, shuffled_perm] = _opt_apply_inv_perm_ss(
-        ctx, std::vector<spu::Value>{bv[bv_idx]}, shared_perm, random_perm);
-    auto perm = _gen_inv_perm_by_bv(ctx, shuffled_bv[0]);
+    auto [shuffled_bv, shuffled_perm] =
+        _opt_apply_inv_perm_ss(ctx, digit, shared_perm, random_perm);
+    auto perm = _gen_inv_perm_by_digit(ctx, shuffled_bv, num_rows);
     shared_perm = _opt_apply_perm_ss(ctx, perm, shuffled_perm, random_perm);
   }
 
@@ -1504,6 +1747,158 @@ std::vector<spu::Value> radix_sort(SPUContext *ctx,
   return res;
 }
 
+// Batched radix sort, each input holds num_rows rows of equal length back to
+// back and all keys are secret. The bit vectors of all rows go through one
+// chain of shuffles, so the rounds are those of a single row.
+std::vector<spu::Value> batch_radix_sort(SPUContext *ctx,
+                                         absl::Span<spu::Value const> inputs,
+                                         SortDirection direction,
+                                         int64_t num_keys, int64_t valid_bits,
+                                         int64_t num_rows) {
+  auto perm = _gen_inv_perm_s(ctx, inputs.subspan(0, num_keys), direction,
+                              valid_bits, num_rows);
+  auto res = apply_inv_perm(ctx, inputs, perm);
+  return res;
+}
+
+// Batched quick sort, each input holds num_rows rows of equal length back to
+// back.
+//
+// All rows are shuffled at once together with their public row index. The
+// revealed row indices only tell which shuffled slots belong to which row, the
+// order inside every row stays hidden. Each row is then gathered back to its
+// public offset locally and sorted as an independent interval, the partitions
+// of all rows still share their comparisons.
+std::vector<spu::Value> batch_quick_sort(SPUContext *ctx,
+                                         absl::Span<spu::Value const> inputs,
+                                         int64_t num_keys,
+                                         SortDirection direction,
+                                         int64_t num_rows) {
+  if (num_rows == 1) {
+    return quick_sort(ctx, inputs, num_keys, direction);
+  }
+
+  const auto numel = inputs.front().numel();
+  const auto W = numel / num_rows;
+  auto dt =
+      ctx->config().field() == FieldType::FM32 ? spu::DT_I32 : spu::DT_I64;
+  auto rows = _row_offsets(ctx, num_rows, W);
+
+  std::vector<spu::Value> inp(inputs.begin(), inputs.end());
+  inp.push_back(_p2s(ctx, rows).setDtype(dt));
+  inp = PrepareSort(ctx, inp);
+  const auto shuffled_rows =
+      dump_public_as<int64_t>(ctx, hal::reveal(ctx, inp.back()));
+  inp.pop_back();
+
+  Index indices(numel);
+  std::vector<int64_t> next(num_rows);
+  for (int64_t row = 0; row < num_rows; ++row) {
+    next[row] = row * W;
+  }
+  for (int64_t idx = 0; idx < numel; ++idx) {
+    indices[next[shuffled_rows[idx] / W]++] = idx;
+  }
+  for (auto &v : inp) {
+    v = _permute_1d(ctx, v, indices);
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> intervals;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    intervals.emplace_back(row * W, (row + 1) * W - 1);
+  }
+  auto quick_comp = _get_cmp_func(ctx, num_keys, direction, true);
+  auto merge_comp = _get_cmp_func(ctx, num_keys, direction);
+  return QuickMergesort(ctx, num_keys, quick_comp, merge_comp,
+                        absl::MakeSpan(inp), std::move(intervals));
+}
+
+// Resolve the sort method of simple sort from the runtime config.
+RuntimeConfig::SortMethod _resolve_sort_method(SPUContext *ctx) {
+  const auto sort_method = ctx->config().sort_method();
+
+  // if use default sort method, trying to find the most best method
+  // currently, radix sort -> quick sort -> sorting network
+  if (sort_method == RuntimeConfig::SORT_DEFAULT) {
+    if (_check_method_require(ctx, RuntimeConfig::SORT_RADIX)) {
+      return RuntimeConfig::SORT_RADIX;
+    } else if (_check_method_require(ctx, RuntimeConfig::SORT_QUICK)) {
+      return RuntimeConfig::SORT_QUICK;
+    } else if (_check_method_require(
+                   ctx,
+                   RuntimeConfig::SORT_NETWORK)) {  // always true now.
+      return RuntimeConfig::SORT_NETWORK;
+    }
+    SPU_THROW("should not reach here");
+  }
+
+  auto selected_method = select_sort_method(ctx, sort_method);
+  if (selected_method != sort_method) {
+    SPDLOG_WARN(
+        "Manually set method: {}, which is not supported, falling back to "
+        "{}.",
+        sort_method, selected_method);
+  }
+  return selected_method;
+}
+
+// Apply permute_fn to each row of the 2-D inputs.
+std::vector<spu::Value> _permute_rows(SPUContext *ctx,
+                                      absl::Span<const spu::Value> inputs,
+                                      const Permute1dFn &permute_fn) {
+  const int64_t M = inputs.size();
+  const int64_t N = inputs[0].shape().dim(0);
+  const int64_t W = inputs[0].shape().dim(1);
+
+  // Call permute1d for each dim to permute.
+  // results (N,M,W), each element is a vector with length W.
+  std::vector<std::vector<spu::Value>> permuted1d;
+  for (int64_t ni = 0; ni < N; ni++) {
+    std::vector<spu::Value> input_i;
+    input_i.reserve(inputs.size());
+    for (auto const &input : inputs) {
+      // we need 1-d tensor here
+      input_i.push_back(
+          hal::reshape(ctx, hal::slice(ctx, input, {ni, 0}, {ni + 1, W}), {W}));
+    }
+
+    permuted1d.push_back(permute_fn(input_i));
+  }
+
+  // result is (M,N,W)
+  std::vector<spu::Value> results(M);
+  for (int64_t mi = 0; mi < M; mi++) {
+    std::vector<spu::Value> output2d;
+    for (int64_t ni = 0; ni < N; ni++) {
+      output2d.push_back(hal::unsqueeze(ctx, permuted1d[ni][mi]));
+    }
+    results[mi] = hal::concatenate(ctx, output2d, 0);
+  }
+
+  return results;
+}
+
+std::vector<spu::Value> _flatten(SPUContext *ctx,
+                                 absl::Span<const spu::Value> inputs) {
+  std::vector<spu::Value> ret;
+  ret.reserve(inputs.size());
+  for (const auto &input : inputs) {
+    ret.push_back(hal::reshape(ctx, input, {input.numel()}));
+  }
+  return ret;
+}
+
+std::vector<spu::Value> _unflatten(SPUContext *ctx,
+                                   absl::Span<const spu::Value> inputs,
+                                   const Shape &shape) {
+  std::vector<spu::Value> ret;
+  ret.reserve(inputs.size());
+  for (const auto &input : inputs) {
+    ret.push_back(hal::reshape(ctx, input, shape));
+  }
+  return ret;
+}
+
 }  // namespace internal
 
 std::vector<spu::Value> sort1d(SPUContext *ctx,
@@ -1577,7 +1972,6 @@ std::vector<spu::Value> simple_sort1d(SPUContext *ctx,
               "num_keys {} is not valid", num_keys);
 
   std::vector<spu::Value> ret;
-  const auto sort_method = ctx->config().sort_method();
 
   // There are multiple sort methods supported by SPU, we will try to seek the
   // best method in the following order if the user does not specify the method
@@ -1613,65 +2007,131 @@ std::vector<spu::Value> simple_sort1d(SPUContext *ctx,
     return internal::fallback_sort1d(ctx, inputs, num_keys, direction);
   }
 
-  // if use default sort method, trying to find the most best method
-  // currently, radix sort -> quick sort -> sorting network
-  if (sort_method == RuntimeConfig::SORT_DEFAULT) {
-    if (internal::_check_method_require(ctx, RuntimeConfig::SORT_RADIX)) {
+  switch (internal::_resolve_sort_method(ctx)) {
+    case RuntimeConfig::SORT_RADIX:
       ret = internal::radix_sort(ctx, inputs, direction, num_keys, valid_bits);
-    } else if (internal::_check_method_require(ctx,
-                                               RuntimeConfig::SORT_QUICK)) {
+      break;
+    case RuntimeConfig::SORT_QUICK:
       ret = internal::quick_sort(ctx, inputs, num_keys, direction);
-    } else if (internal::_check_method_require(
-                   ctx,
-                   RuntimeConfig::SORT_NETWORK)) {  // always true now.
+      break;
+    case RuntimeConfig::SORT_NETWORK:
       ret = internal::fallback_sort1d(ctx, inputs, num_keys, direction);
-    } else {
+      break;
+    default:
       SPU_THROW("should not reach here");
-    }
-  } else {
-    auto selected_method = internal::select_sort_method(ctx, sort_method);
-    if (selected_method != sort_method) {
-      SPDLOG_WARN(
-          "Manually set method: {}, which is not supported, falling back to "
-          "{}.",
-          sort_method, selected_method);
-    }
-
-    switch (selected_method) {
-      case RuntimeConfig::SORT_RADIX:
-        ret =
-            internal::radix_sort(ctx, inputs, direction, num_keys, valid_bits);
-        break;
-      case RuntimeConfig::SORT_QUICK:
-        ret = internal::quick_sort(ctx, inputs, num_keys, direction);
-        break;
-      case RuntimeConfig::SORT_NETWORK:
-        ret = internal::fallback_sort1d(ctx, inputs, num_keys, direction);
-        break;
-      default:
-        SPU_THROW("should not reach here");
-    }
   }
 
   return ret;
 }
 
-std::vector<spu::Value> permute(SPUContext *ctx,
-                                absl::Span<const spu::Value> inputs,
-                                int64_t permute_dim,
-                                const Permute1dFn &permute_fn) {
+std::vector<spu::Value> sort2d(SPUContext *ctx,
+                               absl::Span<spu::Value const> inputs,
+                               const CompFn &cmp, Visibility comparator_ret_vis,
+                               bool is_stable) {
+  // sanity check.
+  SPU_ENFORCE(!inputs.empty(), "Inputs should not be empty");
+  SPU_ENFORCE(inputs[0].shape().ndim() == 2,
+              "Inputs should be 2-d but actually have {} dimensions",
+              inputs[0].shape().ndim());
+  SPU_ENFORCE(std::all_of(inputs.begin(), inputs.end(),
+                          [&inputs](const spu::Value &v) {
+                            return v.shape() == inputs[0].shape();
+                          }),
+              "Inputs shape mismatched");
+
+  // plaintext sort has no rounds to save.
+  if (comparator_ret_vis != VIS_SECRET) {
+    return internal::_permute_rows(
+        ctx, inputs, [&](absl::Span<const spu::Value> input) {
+          return sort1d(ctx, input, cmp, comparator_ret_vis, is_stable);
+        });
+  }
+
+  SPU_ENFORCE(!is_stable,
+              "Stable sort is unsupported if comparator return is secret.");
+
+  const auto num_rows = inputs[0].shape().dim(0);
+  auto ret = internal::odd_even_merge_sort(
+      ctx, cmp, internal::_flatten(ctx, inputs), num_rows);
+  return internal::_unflatten(ctx, ret, inputs[0].shape());
+}
+
+std::vector<spu::Value> simple_sort2d(SPUContext *ctx,
+                                      absl::Span<spu::Value const> inputs,
+                                      SortDirection direction, int64_t num_keys,
+                                      int64_t valid_bits) {
+  // sanity check.
+  SPU_ENFORCE(!inputs.empty(), "Inputs should not be empty");
+  SPU_ENFORCE(inputs[0].shape().ndim() == 2,
+              "Inputs should be 2-d but actually have {} dimensions",
+              inputs[0].shape().ndim());
+  SPU_ENFORCE(std::all_of(inputs.begin(), inputs.end(),
+                          [&inputs](const spu::Value &v) {
+                            return v.shape() == inputs[0].shape();
+                          }),
+              "Inputs shape mismatched");
+  SPU_ENFORCE(num_keys > 0 && num_keys <= static_cast<int64_t>(inputs.size()),
+              "num_keys {} is not valid", num_keys);
+
+  auto sort_rows = [&](const Permute1dFn &sort_fn) {
+    return internal::_permute_rows(ctx, inputs, sort_fn);
+  };
+
+  // if all keys are public, fallback to plaintext sort.
+  if (std::all_of(inputs.begin(), inputs.begin() + num_keys,
+                  [](const spu::Value &v) { return v.isPublic(); })) {
+    return sort_rows([&](absl::Span<const spu::Value> input) {
+      return internal::fallback_sort1d(ctx, input, num_keys, direction);
+    });
+  }
+
+  const auto num_rows = inputs[0].shape().dim(0);
+  const auto flattened = internal::_flatten(ctx, inputs);
+  std::vector<spu::Value> ret;
+  switch (internal::_resolve_sort_method(ctx)) {
+    case RuntimeConfig::SORT_RADIX:
+      // merging public and private keys works on whole vectors, sort such
+      // keys row by row.
+      if (!std::all_of(inputs.begin(), inputs.begin() + num_keys,
+                       [](const spu::Value &v) { return v.isSecret(); })) {
+        return sort_rows([&](absl::Span<const spu::Value> input) {
+          return internal::radix_sort(ctx, input, direction, num_keys,
+                                      valid_bits);
+        });
+      }
+      ret = internal::batch_radix_sort(ctx, flattened, direction, num_keys,
+                                       valid_bits, num_rows);
+      break;
+    case RuntimeConfig::SORT_QUICK:
+      ret = internal::batch_quick_sort(ctx, flattened, num_keys, direction,
+                                       num_rows);
+      break;
+    case RuntimeConfig::SORT_NETWORK:
+      ret = internal::odd_even_merge_sort(
+          ctx, internal::_get_cmp_func(ctx, num_keys, direction), flattened,
+          num_rows);
+      break;
+    default:
+      SPU_THROW("should not reach here");
+  }
+
+  return internal::_unflatten(ctx, ret, inputs[0].shape());
+}
+
+std::vector<spu::Value> batch_permute(SPUContext *ctx,
+                                      absl::Span<const spu::Value> inputs,
+                                      int64_t permute_dim,
+                                      const Permute2dFn &permute_fn) {
   // sanity check.
   SPU_ENFORCE(!inputs.empty(), "Inputs should not be empty");
   // put the to_permute dimension to the last dimension.
   const Shape shape = inputs[0].shape();
 
   // let
-  // - M is the number of inputs.
   // - N is the number of vector to permute
   // - W is the vector length.
-  const int64_t M = inputs.size();
   const int64_t W = shape.dim(permute_dim);
-  if (W == 0) {
+  if (shape.numel() == 0) {
     return std::vector<spu::Value>(inputs.begin(), inputs.end());
   }
   const int64_t N = shape.numel() / W;
@@ -1699,38 +2159,30 @@ std::vector<spu::Value> permute(SPUContext *ctx,
     inputs2d.push_back(std::move(reshaped));
   }
 
-  // Call permute1d for each dim to permute.
-  // results (N,M,W), each element is a vector with length W.
-  std::vector<std::vector<spu::Value>> permuted1d;
-  for (int64_t ni = 0; ni < N; ni++) {
-    // TODO: all these small permutations could be done in parallel.
-    std::vector<spu::Value> input_i;
-    input_i.reserve(inputs2d.size());
-    for (auto const &input : inputs2d) {
-      // we need 1-d tensor here
-      input_i.push_back(
-          hal::reshape(ctx, hal::slice(ctx, input, {ni, 0}, {ni + 1, W}), {W}));
-    }
-
-    permuted1d.push_back(permute_fn(input_i));
-  }
+  auto permuted2d = permute_fn(inputs2d);
 
   // result is (M,shape)
-  std::vector<spu::Value> results(M);
-  for (int64_t mi = 0; mi < M; mi++) {
-    std::vector<spu::Value> output2d;
-    for (int64_t ni = 0; ni < N; ni++) {
-      output2d.push_back(hal::unsqueeze(ctx, permuted1d[ni][mi]));
-    }
-    auto result = hal::concatenate(ctx, output2d, 0);
+  std::vector<spu::Value> results;
+  results.reserve(permuted2d.size());
+  for (const auto &result : permuted2d) {
     // Permute it back, final result is (M, shape)
-    result = hal::reshape(ctx, result, perm_shape);
-    results[mi] = hal::transpose(ctx, result, unperm);
+    results.push_back(hal::transpose(
+        ctx, hal::reshape(ctx, result, perm_shape), unperm));
   }
 
   return results;
 }
 
+std::vector<spu::Value> permute(SPUContext *ctx,
+                                absl::Span<const spu::Value> inputs,
+                                int64_t permute_dim,
+                                const Permute1dFn &permute_fn) {
+  return batch_permute(
+      ctx, inputs, permute_dim, [&](absl::Span<const spu::Value> inputs2d) {
+        return internal::_permute_rows(ctx, inputs2d, permute_fn);
+      });
+}
+
 std::vector<Value> topk_1d(SPUContext *ctx, const spu::Value &input,
                            const SimpleCompFn &scalar_cmp,
                            const TopKConfig &config) {
@@ -1829,6 +2281,43 @@ std::vector<Value> topk_1d(SPUContext *ctx, const spu::Value &input,
   }
 }
 
+std::vector<Value> topk_2d(SPUContext *ctx, const spu::Value &input,
+                           const SimpleCompFn &scalar_cmp,
+                           const TopKConfig &config) {
+  SPU_ENFORCE(input.shape().ndim() == 2,
+              "Inputs should be 2-d but actually have {} dimensions",
+              input.shape().ndim());
+  const int64_t N = input.shape().dim(0);
+  const int64_t W = input.shape().dim(1);
+  SPU_ENFORCE(W >= config.k_hi, "k={} is larger than the last dimension={}",
+              config.k_hi, W);
+  SPU_ENFORCE(config.k_lo <= config.k_hi);
+
+  if (!input.isPublic() && internal::_resolve_topk_method(ctx, W, config) ==
+                               TopKMethod::Tournament) {
+    return internal::tournament_topk(ctx, input, scalar_cmp, config);
+  }
+
+  std::vector<std::vector<spu::Value>> topk1d;
+  topk1d.reserve(N);
+  for (int64_t i = 0; i < N; ++i) {
+    auto input_i =
+        hal::reshape(ctx, hal::slice(ctx, input, {i, 0}, {i + 1, W}), {W});
+    topk1d.push_back(topk_1d(ctx, input_i, scalar_cmp, config));
+  }
+
+  std::vector<spu::Value> ret(topk1d[0].size());
+  for (size_t j = 0; j < ret.size(); ++j) {
+    std::vector<spu::Value> rows;
+    rows.reserve(N);
+    for (int64_t i = 0; i < N; ++i) {
+      rows.push_back(hal::unsqueeze(ctx, topk1d[i][j]));
+    }
+    ret[j] = hal::concatenate(ctx, rows, 0);
+  }
+  return ret;
+}
+
 std::vector<spu::Value> apply_inv_permute_1d(
     SPUContext *ctx, absl::Span<const spu::Value> inputs,
     const spu::Value &perm) {
@@ -24,11 +24,18 @@ class SPUContext;
 
 namespace spu::kernel::hal {
 
+enum class TopKMethod {
+  Auto,         // choose by the row length, k and the protocol
+  QuickSelect,  // randomized quick select on shuffled values
+  Tournament,   // merge sorted k-element candidate lists in log-depth
+};
+
 struct TopKConfig {
   bool value_only;  // only return values
   bool confusion;   // add random noise to hide the data-dependant pattern
   int64_t k_lo;     // the `k_lo`-th largest element order is guaranteed
   int64_t k_hi;     // returning the largest `k_hi` values (or with indices)
+  TopKMethod method = TopKMethod::Auto;
 };
 
 using SimpleCompFn = std::function<spu::Value(SPUContext *, const spu::Value &,
@@ -39,6 +46,10 @@ using CompFn = std::function<spu::Value(absl::Span<const spu::Value>)>;
 using Permute1dFn =
     std::function<std::vector<spu::Value>(absl::Span<const spu::Value>)>;
 
+// Permute all rows of 2-D operands in one call.
+using Permute2dFn =
+    std::function<std::vector<spu::Value>(absl::Span<const spu::Value>)>;
+
 // sort direction for sorters without comparators
 enum class SortDirection {
   Ascending,
@@ -63,6 +74,27 @@ std::vector<spu::Value> simple_sort1d(SPUContext *ctx,
                                       SortDirection direction, int64_t num_keys,
                                       int64_t valid_bits);
 
+// batched sort1d, each row of the 2-D operands is sorted independently.
+//
+// With a secret comparator, every layer of the sorting network compares the
+// same lanes of all rows at once, so the rounds do not grow with the number of
+// rows.
+std::vector<spu::Value> sort2d(SPUContext *ctx,
+                               absl::Span<spu::Value const> inputs,
+                               const CompFn &cmp, Visibility comparator_ret_vis,
+                               bool is_stable);
+
+// batched simple_sort1d, each row of the 2-D operands is sorted independently.
+//
+// All rows are sorted together by the selected method: radix sort generates
+// the bit-vector permutations of all rows at once, quick sort partitions all
+// rows in lock-step and sorting network compare-swaps all rows in each layer.
+// Radix sort with non-secret keys still sorts row by row.
+std::vector<spu::Value> simple_sort2d(SPUContext *ctx,
+                                      absl::Span<spu::Value const> inputs,
+                                      SortDirection direction, int64_t num_keys,
+                                      int64_t valid_bits);
+
 // transform n-d permute to 1-d permute and applying permute function to each
 // 1-d array
 std::vector<spu::Value> permute(SPUContext *ctx,
@@ -70,6 +102,13 @@ std::vector<spu::Value> permute(SPUContext *ctx,
                                 int64_t permute_dim,
                                 const Permute1dFn &permute_fn);
 
+// transform n-d permute to 2-d (N, W) permute, where W is the permute_dim, and
+// applying permute function to all the N vectors at once
+std::vector<spu::Value> batch_permute(SPUContext *ctx,
+                                      absl::Span<const spu::Value> inputs,
+                                      int64_t permute_dim,
+                                      const Permute2dFn &permute_fn);
+
 // general topk1d
 // Inputs:
 //  -inputs: an 1-D operand to search top k elements
@@ -79,6 +118,15 @@ std::vector<Value> topk_1d(SPUContext *ctx, const spu::Value &input,
                            const SimpleCompFn &scalar_cmp,
                            const TopKConfig &config);
 
+// batched topk over the rows of a 2-D operand
+//
+// The tournament handles all rows together and is preferred for small k
+// (or when the protocol has no shuffle), otherwise each row goes through
+// topk_1d.
+std::vector<Value> topk_2d(SPUContext *ctx, const spu::Value &input,
+                           const SimpleCompFn &scalar_cmp,
+                           const TopKConfig &config);
+
 // For each input x, we get y = perm^{-1} (x), i.e. y[i] = x[perm^{-1}(i)]
 std::vector<spu::Value> apply_inv_permute_1d(
     SPUContext *ctx, absl::Span<const spu::Value> inputs,
@@ -239,6 +239,25 @@ Value select(SPUContext* ctx, const Value& pred, const Value& a,
   return _mux(ctx, pred, a, b).setDtype(a.dtype());
 }
 
+std::vector<Value> select(SPUContext* ctx, const Value& pred,
+                          absl::Span<const Value> a,
+                          absl::Span<const Value> b) {
+  SPU_TRACE_HAL_DISP(ctx, pred, a.size());
+
+  SPU_ENFORCE(pred.isInt());
+  SPU_ENFORCE_EQ(a.size(), b.size());
+  for (size_t idx = 0; idx < a.size(); ++idx) {
+    SPU_ENFORCE(a[idx].shape() == b[idx].shape());
+    SPU_ENFORCE(a[idx].dtype() == b[idx].dtype());
+  }
+
+  auto ret = _mux(ctx, pred, a, b);
+  for (size_t idx = 0; idx < a.size(); ++idx) {
+    ret[idx].setDtype(a[idx].dtype());
+  }
+  return ret;
+}
+
 Value bitwise_and(SPUContext* ctx, const Value& x, const Value& y) {
   SPU_TRACE_HAL_DISP(ctx, x, y);
 
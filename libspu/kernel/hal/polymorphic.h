@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include "absl/types/span.h"
+
 #include "libspu/core/value.h"
 
 namespace spu {
@@ -170,6 +174,13 @@ Value reciprocal(SPUContext* ctx, const Value& in);
 Value select(SPUContext* ctx, const Value& pred, const Value& a,
              const Value& b);
 
+/// select of every (a[i], b[i]) by the same pred
+// @param pred, the predicate, a scalar or of the shape of every a[i]
+// Secret outputs are selected by a single multiplication.
+std::vector<Value> select(SPUContext* ctx, const Value& pred,
+                          absl::Span<const Value> a,
+                          absl::Span<const Value> b);
+
 /// general element-wise subtract operator
 // @param x, the first parameter
 // @param y, the second parameter
@@ -242,9 +253,12 @@ Value sqrt(SPUContext* ctx, const Value& x);
 // @param in, the input value
 Value sign(SPUContext* ctx, const Value& x);
 
+// Builds the {n, db_size} onehots of the n indices in 1-D x, or nullopt when
+// the protocol has no ORAM.
 std::optional<Value> oramonehot(SPUContext* ctx, const Value& x,
                                 int64_t db_size, bool db_is_secret);
 
+// Reads one row of the 2-D database y per onehot in x.
 Value oramread(SPUContext* ctx, const Value& x, const Value& y, int64_t offset);
 
 }  // namespace spu::kernel::hal
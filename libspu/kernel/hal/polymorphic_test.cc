@@ -759,7 +759,8 @@ TEST(MathTest, GreaterWithLargeNumber) {
 INSTANTIATE_TEST_SUITE_P(
     LogisticTestInstance, LogisticTest,
     testing::Values(RuntimeConfig::SIGMOID_MM1, RuntimeConfig::SIGMOID_SEG3,
-                    RuntimeConfig::SIGMOID_REAL),
+                    RuntimeConfig::SIGMOID_REAL,
+                    RuntimeConfig::SIGMOID_PIECEWISE),
     [](const testing::TestParamInfo<LogisticTest::ParamType>& p) {
       return fmt::format("{}", p.param);
     });
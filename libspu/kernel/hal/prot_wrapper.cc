@@ -76,6 +76,11 @@ Value _cast_type_s(SPUContext* ctx, const Value& in, const Type& to) {
   return ret;
 }
 
+Value _ring_cast_s(SPUContext* ctx, const Value& in, FieldType to_field) {
+  SPU_TRACE_HAL_DISP(ctx, in);
+  return mpc::ring_cast_s(ctx, in, to_field);
+}
+
 Value _make_p(SPUContext* ctx, uint128_t init, const Shape& shape) {
   SPU_TRACE_HAL_DISP(ctx, init);
   auto res = mpc::make_p(ctx, init, shape);
@@ -30,6 +30,7 @@ namespace spu::kernel::hal {
 Type _common_type_s(SPUContext* ctx, const Type& a, const Type& b);
 Type _common_type_v(SPUContext* ctx, const Type& a, const Type& b);
 Value _cast_type_s(SPUContext* ctx, const Value& in, const Type& to);
+Value _ring_cast_s(SPUContext* ctx, const Value& in, FieldType to_field);
 
 Value _p2s(SPUContext* ctx, const Value& in);
 Value _s2p(SPUContext* ctx, const Value& in);
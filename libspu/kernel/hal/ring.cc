@@ -14,7 +14,10 @@
 
 #include "libspu/kernel/hal/ring.h"
 
+#include <algorithm>
 #include <cmath>
+#include <future>
+#include <tuple>
 #include <vector>
 
 #include "libspu/core/bit_utils.h"
@@ -286,6 +289,25 @@ std::tuple<int64_t, int64_t, int64_t> calcMmulTilingSize(int64_t m, int64_t n,
   return {m_step, n_step, k_step};
 }
 
+RuntimeConfig::MmulStrategy getMmulStrategy(SPUContext* ctx) {
+  if (ctx->config().experimental_disable_mmul_split()) {
+    return RuntimeConfig::MMUL_NO_SPLIT;
+  }
+  auto strategy = ctx->config().mmul_strategy();
+  if (strategy == RuntimeConfig::MMUL_DEFAULT) {
+    return RuntimeConfig::MMUL_SEQUENTIAL;
+  }
+  if (strategy == RuntimeConfig::MMUL_PIPELINED && ctx->lctx() == nullptr) {
+    // Nothing to overlap without a network.
+    return RuntimeConfig::MMUL_SEQUENTIAL;
+  }
+  return strategy;
+}
+
+// Number of blocks in flight of a pipelined mmul, one computing while the
+// other one communicates.
+constexpr int64_t kMmulPipelineDepth = 2;
+
 }  // namespace
 
 Value _sub(SPUContext* ctx, const Value& x, const Value& y) {
@@ -311,18 +333,38 @@ Value _sub(SPUContext* ctx, const Value& x, const Value& y) {
 }
 
 Value _mmul(SPUContext* ctx, const Value& x, const Value& y) {
-  auto [m, n, k] = deduceMmulArgs(x.shape(), y.shape());
+  // Plain variables, C++17 lambdas cannot capture structured bindings.
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  std::tie(m, n, k) = deduceMmulArgs(x.shape(), y.shape());
 
   // Enforce no vector
   if (x.shape() != Shape{m, k} || y.shape() != Shape{k, n}) {
     return _mmul(ctx, Value(x.data().reshape({m, k}), x.dtype()),
                  Value(y.data().reshape({k, n}), y.dtype()));
   }
-  auto [m_step, n_step, k_step] =
+
+  const auto strategy = getMmulStrategy(ctx);
+  if (strategy == RuntimeConfig::MMUL_NO_SPLIT) {
+    return _mmul_impl(ctx, x, y);
+  }
+
+  int64_t m_step;
+  int64_t n_step;
+  int64_t k_step;
+  std::tie(m_step, n_step, k_step) =
       calcMmulTilingSize(m, n, k, x.elsize(), 256UL * 1024 * 1024);
 
-  if (ctx->config().experimental_disable_mmul_split() ||
-      (m_step == m && n_step == n && k_step == k)) {
+  const bool pipelined = strategy == RuntimeConfig::MMUL_PIPELINED;
+  if (pipelined) {
+    const int64_t edge = ctx->config().mmul_pipeline_edge();
+    SPU_ENFORCE(edge > 0, "invalid mmul_pipeline_edge {}", edge);
+    m_step = std::min(m_step, edge);
+    n_step = std::min(n_step, edge);
+  }
+
+  if (m_step == m && n_step == n && k_step == k) {
     // no split
     return _mmul_impl(ctx, x, y);
   }
@@ -334,42 +376,67 @@ Value _mmul(SPUContext* ctx, const Value& x, const Value& y) {
   std::vector<std::vector<Value>> ret_blocks(m_blocks,
                                              std::vector<Value>(n_blocks));
 
-  for (int64_t r = 0; r < m_blocks; r++) {
-    for (int64_t c = 0; c < n_blocks; c++) {
-      for (int64_t i = 0; i < k_blocks; i++) {
-        auto m_start = r * m_step;
-        auto n_start = c * n_step;
-        auto k_start = i * k_step;
-        auto m_end = std::min(m, m_start + m_step);
-        auto n_end = std::min(n, n_start + n_step);
-        auto k_end = std::min(k, k_start + k_step);
-
-        Value x_block;
-        if (x.shape().size() == 1) {
-          SPU_ENFORCE(m_start == 0 && m_end == 1);
-          x_block = _extract_slice(ctx, x, {k_start}, {k_end}, {});
-        } else {
-          x_block =
-              _extract_slice(ctx, x, {m_start, k_start}, {m_end, k_end}, {});
-        }
+  auto mmul_block = [&](SPUContext* sctx, int64_t r, int64_t c) {
+    for (int64_t i = 0; i < k_blocks; i++) {
+      auto m_start = r * m_step;
+      auto n_start = c * n_step;
+      auto k_start = i * k_step;
+      auto m_end = std::min(m, m_start + m_step);
+      auto n_end = std::min(n, n_start + n_step);
+      auto k_end = std::min(k, k_start + k_step);
+
+      Value x_block;
+      if (x.shape().size() == 1) {
+        SPU_ENFORCE(m_start == 0 && m_end == 1);
+        x_block = _extract_slice(sctx, x, {k_start}, {k_end}, {});
+      } else {
+        x_block =
+            _extract_slice(sctx, x, {m_start, k_start}, {m_end, k_end}, {});
+      }
 
-        Value y_block;
-        if (y.shape().size() == 1) {
-          SPU_ENFORCE(n_start == 0 && n_end == 1);
-          y_block = _extract_slice(ctx, y, {k_start}, {k_end}, {});
-        } else {
-          y_block =
-              _extract_slice(ctx, y, {k_start, n_start}, {k_end, n_end}, {});
-        }
+      Value y_block;
+      if (y.shape().size() == 1) {
+        SPU_ENFORCE(n_start == 0 && n_end == 1);
+        y_block = _extract_slice(sctx, y, {k_start}, {k_end}, {});
+      } else {
+        y_block =
+            _extract_slice(sctx, y, {k_start, n_start}, {k_end, n_end}, {});
+      }
 
-        auto mmul_ret = _mmul_impl(ctx, x_block, y_block);
-        if (i == 0) {
-          ret_blocks[r][c] = std::move(mmul_ret);
-        } else {
-          ret_blocks[r][c] = _add(ctx, ret_blocks[r][c], mmul_ret);
-        }
+      auto mmul_ret = _mmul_impl(sctx, x_block, y_block);
+      if (i == 0) {
+        ret_blocks[r][c] = std::move(mmul_ret);
+      } else {
+        ret_blocks[r][c] = _add(sctx, ret_blocks[r][c], mmul_ret);
       }
     }
+  };
+
+  const int64_t num_blocks = m_blocks * n_blocks;
+  if (pipelined && num_blocks > 1) {
+    // Every lane owns a forked context and walks its blocks in order, so the
+    // local GEMM of one lane overlaps the network exchange of the other.
+    const int64_t num_lanes = std::min(num_blocks, kMmulPipelineDepth);
+    std::vector<std::unique_ptr<SPUContext>> sub_ctxs;
+    for (int64_t lane = 0; lane < num_lanes; lane++) {
+      sub_ctxs.push_back(ctx->fork());
+    }
+
+    std::vector<std::future<void>> futures;
+    for (int64_t lane = 0; lane < num_lanes; lane++) {
+      futures.push_back(std::async(std::launch::async, [&, lane] {
+        for (int64_t idx = lane; idx < num_blocks; idx += num_lanes) {
+          mmul_block(sub_ctxs[lane].get(), idx / n_blocks, idx % n_blocks);
+        }
+      }));
+    }
+    for (auto& f : futures) {
+      f.get();
+    }
+  } else {
+    for (int64_t idx = 0; idx < num_blocks; idx++) {
+      mmul_block(ctx, idx / n_blocks, idx % n_blocks);
+    }
   }
 
   // merge blocks.
@@ -462,6 +529,21 @@ Value _less(SPUContext* ctx, const Value& x, const Value& y) {
   return _msb(ctx, _sub(ctx, x, y));
 }
 
+Value _less(SPUContext* ctx, const Value& x, const Value& y, FieldType field) {
+  SPU_TRACE_HAL_LEAF(ctx, x, y);
+
+  auto diff = _sub(ctx, x, y);
+  if (!diff.isSecret() || !ctx->hasKernel("ring_cast_s") ||
+      SizeOf(field) >= SizeOf(ctx->getField())) {
+    return _msb(ctx, diff);
+  }
+
+  // The msb circuit is linear in the ring width, evaluate it on the narrow
+  // ring and move the resulting bit back, both casts are local.
+  auto msb = _msb(ctx, _ring_cast_s(ctx, diff, field));
+  return _ring_cast_s(ctx, msb, ctx->getField());
+}
+
 Value _mux(SPUContext* ctx, const Value& pred, const Value& a, const Value& b) {
   SPU_TRACE_HAL_LEAF(ctx, pred, a, b);
 
@@ -469,6 +551,81 @@ Value _mux(SPUContext* ctx, const Value& pred, const Value& a, const Value& b) {
   return _add(ctx, b, _mul(ctx, pred, _sub(ctx, a, b)));
 }
 
+std::vector<Value> _mul(SPUContext* ctx, absl::Span<const Value> x,
+                        absl::Span<const Value> y) {
+  SPU_TRACE_HAL_LEAF(ctx, x.size());
+  SPU_ENFORCE_EQ(x.size(), y.size());
+
+  // Products with a public operand are local, only secret pairs are fused.
+  std::vector<Value> ret(x.size());
+  std::vector<size_t> fused;
+  for (size_t idx = 0; idx < x.size(); ++idx) {
+    SPU_ENFORCE(x[idx].shape() == y[idx].shape(), "x={}, y={}", x[idx],
+                y[idx]);
+    if (x[idx].isSecret() && y[idx].isSecret() && x[idx].numel() > 0) {
+      fused.emplace_back(idx);
+    } else {
+      ret[idx] = _mul(ctx, x[idx], y[idx]);
+    }
+  }
+
+  if (fused.size() == 1) {
+    ret[fused[0]] = _mul(ctx, x[fused[0]], y[fused[0]]);
+  }
+  if (fused.size() <= 1) {
+    return ret;
+  }
+
+  auto flatten = [&](absl::Span<const Value> in) {
+    Type common_type = in[fused[0]].storage_type();
+    for (auto idx : fused) {
+      common_type = _common_type(ctx, common_type, in[idx].storage_type());
+    }
+    std::vector<Value> flat;
+    for (auto idx : fused) {
+      flat.emplace_back(_reshape(ctx, _cast_type(ctx, in[idx], common_type),
+                                 {in[idx].numel()}));
+    }
+    return _concatenate(ctx, flat, 0);
+  };
+  auto product = _mul(ctx, flatten(x), flatten(y));
+
+  int64_t offset = 0;
+  for (auto idx : fused) {
+    const int64_t numel = x[idx].numel();
+    ret[idx] = _reshape(
+        ctx, _extract_slice(ctx, product, {offset}, {offset + numel}, {}),
+        x[idx].shape());
+    offset += numel;
+  }
+  return ret;
+}
+
+std::vector<Value> _mux(SPUContext* ctx, const Value& pred,
+                        absl::Span<const Value> a, absl::Span<const Value> b) {
+  SPU_TRACE_HAL_LEAF(ctx, pred, a.size());
+  SPU_ENFORCE_EQ(a.size(), b.size());
+
+  // b + pred*(a-b)
+  std::vector<Value> preds;
+  std::vector<Value> diffs;
+  for (size_t idx = 0; idx < a.size(); ++idx) {
+    const auto& shape = a[idx].shape();
+    SPU_ENFORCE(pred.shape().isScalar() || pred.shape() == shape,
+                "pred={}, a={}", pred, a[idx]);
+    preds.emplace_back(pred.shape() == shape
+                           ? pred
+                           : _broadcast(ctx, pred, shape, {}));
+    diffs.emplace_back(_sub(ctx, a[idx], b[idx]));
+  }
+
+  auto products = _mul(ctx, preds, diffs);
+  for (size_t idx = 0; idx < a.size(); ++idx) {
+    products[idx] = _add(ctx, b[idx], products[idx]);
+  }
+  return products;
+}
+
 Value _clamp(SPUContext* ctx, const Value& x, const Value& minv,
              const Value& maxv) {
   SPU_TRACE_HAL_LEAF(ctx, x, minv, maxv);
@@ -690,7 +847,11 @@ std::optional<Value> _oramonehot(SPUContext* ctx, const Value& x,
 Value _oramread(SPUContext* ctx, const Value& x, const Value& y,
                 int64_t offset) {
   SPU_ENFORCE(x.isSecret(), "onehot should be secret shared");
-  auto reshaped_x = Value(x.data().reshape({1, x.numel()}), x.dtype());
+  // A single onehot reads one row, a {n, db_size} batch reads n rows.
+  auto reshaped_x = x;
+  if (x.shape().size() != 2) {
+    reshaped_x = Value(x.data().reshape({1, x.numel()}), x.dtype());
+  }
   auto reshaped_y = y;
   if (y.shape().size() == 1) {
     reshaped_y = Value(y.data().reshape({y.numel(), 1}), y.dtype());
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include "absl/types/span.h"
+
 #include "libspu/core/value.h"
 
 namespace spu {
@@ -71,6 +75,11 @@ Value _equal(SPUContext* ctx, const Value& x, const Value& y);
 
 Value _less(SPUContext* ctx, const Value& x, const Value& y);
 
+// Return 1{x < y}, the msb is evaluated on `field` when it is narrower than
+// the working field. The caller should guarantee that x - y is representable
+// on `field`.
+Value _less(SPUContext* ctx, const Value& x, const Value& y, FieldType field);
+
 Value _lshift(SPUContext* ctx, const Value& in, const Sizes& bits);
 
 Value _rshift(SPUContext* ctx, const Value& in, const Sizes& bits);
@@ -85,6 +94,16 @@ Value _bitrev(SPUContext* ctx, const Value&, size_t start_idx, size_t end_idx);
 // Expect pred is either {0, 1}.
 Value _mux(SPUContext* ctx, const Value& pred, const Value& a, const Value& b);
 
+// Return x[i] * y[i] for every i. All products of two secrets are flattened
+// into a single _mul, so the whole batch takes one protocol invocation.
+std::vector<Value> _mul(SPUContext* ctx, absl::Span<const Value> x,
+                        absl::Span<const Value> y);
+
+// Return _mux(pred, a[i], b[i]) for every i, pred is either a scalar or has
+// the shape of every a[i]. The products share one batched _mul.
+std::vector<Value> _mux(SPUContext* ctx, const Value& pred,
+                        absl::Span<const Value> a, absl::Span<const Value> b);
+
 // TODO: test me
 Value _clamp(SPUContext* ctx, const Value& x, const Value& minv,
              const Value& maxv);
@@ -0,0 +1,81 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "yacl/link/algorithm/barrier.h"
+
+#include "libspu/kernel/hal/ring.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::kernel::hal {
+
+// Secret (edge, edge) x (edge, edge) matmul. Only wall time is reported, the
+// pipelined blocks communicate on forked links that the root link statistics
+// do not cover.
+static void BM_Mmul(benchmark::State &state) {
+  const auto edge = static_cast<size_t>(state.range(0));
+  const auto prot = static_cast<ProtocolKind>(state.range(1));
+  const auto strategy =
+      static_cast<RuntimeConfig::MmulStrategy>(state.range(2));
+
+  xt::xarray<int64_t> x = test::xt_random<int64_t>({edge, edge});
+  xt::xarray<int64_t> y = test::xt_random<int64_t>({edge, edge});
+
+  for (auto _ : state) {
+    std::atomic<double> elapsed = 0;
+    mpc::utils::simulate(
+        3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+          RuntimeConfig conf;
+          conf.set_protocol(prot);
+          conf.set_field(FieldType::FM64);
+          conf.set_mmul_strategy(strategy);
+          SPUContext sctx = test::makeSPUContext(conf, lctx);
+
+          auto lhs = test::makeValue(&sctx, x, VIS_SECRET);
+          auto rhs = test::makeValue(&sctx, y, VIS_SECRET);
+          // Parties start the timed part together.
+          yacl::link::Barrier(lctx, "mmul_bench");
+          const auto start = std::chrono::steady_clock::now();
+          benchmark::DoNotOptimize(_mmul(&sctx, lhs, rhs));
+          yacl::link::Barrier(lctx, "mmul_bench");
+          if (lctx->Rank() == 0) {
+            elapsed = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+          }
+        });
+    state.SetIterationTime(elapsed);
+  }
+}
+
+BENCHMARK(BM_Mmul)
+    ->ArgNames({"edge", "prot", "strategy"})
+    ->ArgsProduct({
+        {1024, 4096},                                // edge
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3},  // protocol
+        {RuntimeConfig::MMUL_NO_SPLIT, RuntimeConfig::MMUL_SEQUENTIAL,
+         RuntimeConfig::MMUL_PIPELINED},  // strategy
+    })
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+}  // namespace spu::kernel::hal
+
+BENCHMARK_MAIN();
@@ -18,6 +18,8 @@
 #include "xtensor/xarray.hpp"
 
 #include "libspu/kernel/test_util.h"
+#include "libspu/mpc/common/communicator.h"
+#include "libspu/mpc/utils/simulate.h"
 
 namespace spu::kernel::hal {
 
@@ -60,4 +62,65 @@ TEST(RingTest, _popcount) {
     EXPECT_EQ(p_ret, expected);
   }
 }
+
+class MmulStrategyTest
+    : public ::testing::TestWithParam<
+          std::tuple<ProtocolKind, RuntimeConfig::MmulStrategy>> {};
+
+TEST_P(MmulStrategyTest, Works) {
+  const auto prot = std::get<0>(GetParam());
+  const auto strategy = std::get<1>(GetParam());
+
+  const size_t m = 300;
+  const size_t k = 170;
+  const size_t n = 270;
+  xt::xarray<int64_t> x = test::xt_random<int64_t>({m, k}, -100, 100);
+  xt::xarray<int64_t> y = test::xt_random<int64_t>({k, n}, -100, 100);
+
+  xt::xarray<int64_t> expected = xt::zeros<int64_t>({m, n});
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = 0; j < n; j++) {
+      for (size_t l = 0; l < k; l++) {
+        expected(i, j) += x(i, l) * y(l, j);
+      }
+    }
+  }
+
+  mpc::utils::simulate(3, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    RuntimeConfig conf;
+    conf.set_protocol(prot);
+    conf.set_field(FieldType::FM64);
+    conf.set_mmul_strategy(strategy);
+    // 3x3 blocks, with ragged last rows and columns.
+    conf.set_mmul_pipeline_edge(128);
+    SPUContext ctx = test::makeSPUContext(conf, lctx);
+
+    auto lhs = test::makeValue(&ctx, x, VIS_SECRET);
+    auto rhs = test::makeValue(&ctx, y, VIS_SECRET);
+    auto* comm = ctx.getState<mpc::Communicator>();
+    auto before = comm->getStats();
+    auto ret = _mmul(&ctx, lhs, rhs);
+    if (strategy == RuntimeConfig::MMUL_PIPELINED) {
+      // Every block ran on a forked context.
+      EXPECT_EQ((comm->getStats() - before).latency, 0U);
+    } else {
+      EXPECT_GT((comm->getStats() - before).latency, 0U);
+    }
+
+    auto p_ret =
+        hal::dump_public_as<int64_t>(&ctx, _s2p(&ctx, ret).setDtype(DT_I64));
+    EXPECT_EQ(p_ret, expected);
+  });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MmulStrategyTestInstances, MmulStrategyTest,
+    testing::Combine(testing::Values(ProtocolKind::SEMI2K, ProtocolKind::ABY3),
+                     testing::Values(RuntimeConfig::MMUL_NO_SPLIT,
+                                     RuntimeConfig::MMUL_SEQUENTIAL,
+                                     RuntimeConfig::MMUL_PIPELINED)),
+    [](const testing::TestParamInfo<MmulStrategyTest::ParamType>& p) {
+      return fmt::format("{}x{}", std::get<0>(p.param), std::get<1>(p.param));
+    });
+
 }  // namespace spu::kernel::hal
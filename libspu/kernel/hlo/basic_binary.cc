@@ -17,6 +17,7 @@
 #include "libspu/kernel/hal/complex.h"
 #include "libspu/kernel/hal/constants.h"
 #include "libspu/kernel/hal/polymorphic.h"
+#include "libspu/kernel/hal/ring.h"
 #include "libspu/kernel/hal/shape_ops.h"
 #include "libspu/kernel/hal/utils.h"
 
@@ -50,6 +51,44 @@ SIMPLE_BINARY_KERNEL_DEFN(Atan2, hal::atan2)
 
 #undef SIMPLE_BINARY_KERNEL_DEFN
 
+namespace {
+
+// The narrowest field that holds `bits`, or the working field.
+FieldType narrowField(SPUContext *ctx, int64_t bits) {
+  for (auto field : {FieldType::FM32, FieldType::FM64}) {
+    if (bits <= static_cast<int64_t>(SizeOf(field) * 8) &&
+        SizeOf(field) < SizeOf(ctx->getField())) {
+      return field;
+    }
+  }
+  return ctx->getField();
+}
+
+}  // namespace
+
+spu::Value Less(SPUContext *ctx, const spu::Value &lhs, const spu::Value &rhs,
+                int64_t bits) {
+  if (!lhs.isInt() || !rhs.isInt() || lhs.dtype() != rhs.dtype()) {
+    return Less(ctx, lhs, rhs);
+  }
+  return hal::_less(ctx, lhs, rhs, narrowField(ctx, bits)).setDtype(DT_I1);
+}
+
+spu::Value Greater(SPUContext *ctx, const spu::Value &lhs,
+                   const spu::Value &rhs, int64_t bits) {
+  return Less(ctx, rhs, lhs, bits);
+}
+
+spu::Value LessEqual(SPUContext *ctx, const spu::Value &lhs,
+                     const spu::Value &rhs, int64_t bits) {
+  return hal::logical_not(ctx, Greater(ctx, lhs, rhs, bits));
+}
+
+spu::Value GreaterEqual(SPUContext *ctx, const spu::Value &lhs,
+                        const spu::Value &rhs, int64_t bits) {
+  return hal::logical_not(ctx, Less(ctx, lhs, rhs, bits));
+}
+
 spu::Value Remainder(SPUContext *ctx, const spu::Value &lhs,
                      const spu::Value &rhs) {
   SPU_ENFORCE(lhs.dtype() == rhs.dtype(), "dtype mismatch {} != {}",
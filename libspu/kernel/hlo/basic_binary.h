@@ -50,4 +50,17 @@ SIMPLE_BINARY_KERNEL_DECL(Atan2)
 
 #undef SIMPLE_BINARY_KERNEL_DECL
 
+// Ordering comparisons whose operand difference is known to fit in `bits`
+// signed bits, see the `infer-bitwidth` compiler pass.
+#define NARROW_COMPARE_KERNEL_DECL(NAME)                  \
+  spu::Value NAME(SPUContext *ctx, const spu::Value &lhs, \
+                  const spu::Value &rhs, int64_t bits);
+
+NARROW_COMPARE_KERNEL_DECL(Less)
+NARROW_COMPARE_KERNEL_DECL(Greater)
+NARROW_COMPARE_KERNEL_DECL(LessEqual)
+NARROW_COMPARE_KERNEL_DECL(GreaterEqual)
+
+#undef NARROW_COMPARE_KERNEL_DECL
+
 }  // namespace spu::kernel::hlo
@@ -15,9 +15,11 @@
 #include "libspu/kernel/hlo/basic_binary.h"
 
 #include "gtest/gtest.h"
+#include "xtensor/xio.hpp"
 
 #include "libspu/core/context.h"
 #include "libspu/core/value.h"
+#include "libspu/kernel/hal/public_helper.h"
 #include "libspu/kernel/hlo/casting.h"
 #include "libspu/kernel/hlo/const.h"
 #include "libspu/kernel/test_util.h"
@@ -136,6 +138,52 @@ TEST_P(BinaryTest, MixedIntMul) {
       });
 }
 
+TEST_P(BinaryTest, NarrowCompare) {
+  FieldType field = std::get<0>(GetParam());
+  ProtocolKind prot = std::get<1>(GetParam());
+
+  for (int64_t bits : {8, 32, 40}) {
+    // Differences on both ends of the `bits` signed range.
+    const int64_t max_diff = (int64_t(1) << (bits - 1)) - 1;
+    const int64_t min_diff = -max_diff - 1;
+    std::vector<int64_t> diffs = {min_diff, min_diff + 1, -1,      0,
+                                  1,        max_diff - 1, max_diff};
+    std::vector<int64_t> rhs_bases = {-(int64_t(1) << 20), -5, 0, 7};
+
+    const Shape shape = {static_cast<int64_t>(diffs.size()),
+                         static_cast<int64_t>(rhs_bases.size())};
+    xt::xarray<int64_t> lhs =
+        xt::zeros<int64_t>({diffs.size(), rhs_bases.size()});
+    xt::xarray<int64_t> rhs =
+        xt::zeros<int64_t>({diffs.size(), rhs_bases.size()});
+    for (size_t i = 0; i < diffs.size(); i++) {
+      for (size_t j = 0; j < rhs_bases.size(); j++) {
+        rhs(i, j) = rhs_bases[j];
+        lhs(i, j) = rhs_bases[j] + diffs[i];
+      }
+    }
+
+    mpc::utils::simulate(
+        3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+          SPUContext sctx = test::makeSPUContext(prot, field, lctx);
+          auto x = Seal(&sctx, Constant(&sctx, lhs, shape));
+          auto y = Seal(&sctx, Constant(&sctx, rhs, shape));
+
+          auto reveal = [&](const spu::Value &v) {
+            return hal::dump_public_as<bool>(&sctx, Reveal(&sctx, v));
+          };
+          xt::xarray<bool> lt = lhs < rhs;
+          xt::xarray<bool> gt = lhs > rhs;
+          xt::xarray<bool> le = !gt;
+          xt::xarray<bool> ge = !lt;
+          EXPECT_EQ(reveal(Less(&sctx, x, y, bits)), lt) << bits;
+          EXPECT_EQ(reveal(Greater(&sctx, x, y, bits)), gt) << bits;
+          EXPECT_EQ(reveal(LessEqual(&sctx, x, y, bits)), le) << bits;
+          EXPECT_EQ(reveal(GreaterEqual(&sctx, x, y, bits)), ge) << bits;
+        });
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     BinaryTestInstances, BinaryTest,
     testing::Combine(testing::Values(FieldType::FM64, FieldType::FM128),
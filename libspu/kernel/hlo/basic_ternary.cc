@@ -34,6 +34,42 @@ spu::Value Select(SPUContext *ctx, const spu::Value &pred,
   return hal::select(ctx, pred, on_true, on_false);
 }
 
+std::vector<spu::Value> Select(SPUContext *ctx, const spu::Value &pred,
+                               absl::Span<const spu::Value> on_true,
+                               absl::Span<const spu::Value> on_false) {
+  SPU_ENFORCE_EQ(on_true.size(), on_false.size());
+
+  // Complex outputs are selected as their real and imaginary parts.
+  std::vector<spu::Value> a;
+  std::vector<spu::Value> b;
+  for (size_t idx = 0; idx < on_true.size(); ++idx) {
+    if (on_true[idx].isComplex()) {
+      SPU_ENFORCE(on_false[idx].isComplex());
+      a.emplace_back(hal::real(ctx, on_true[idx]));
+      a.emplace_back(hal::imag(ctx, on_true[idx]));
+      b.emplace_back(hal::real(ctx, on_false[idx]));
+      b.emplace_back(hal::imag(ctx, on_false[idx]));
+    } else {
+      a.emplace_back(on_true[idx]);
+      b.emplace_back(on_false[idx]);
+    }
+  }
+
+  auto selected = hal::select(ctx, pred, a, b);
+
+  std::vector<spu::Value> ret;
+  size_t pos = 0;
+  for (const auto &v : on_true) {
+    if (v.isComplex()) {
+      ret.emplace_back(hal::complex(ctx, selected[pos], selected[pos + 1]));
+      pos += 2;
+    } else {
+      ret.emplace_back(std::move(selected[pos++]));
+    }
+  }
+  return ret;
+}
+
 spu::Value Clamp(SPUContext *ctx, const spu::Value &operand,
                  const spu::Value &min, const spu::Value &max) {
   SPU_ENFORCE(!operand.isComplex() && !min.isComplex() && !max.isComplex());
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include "absl/types/span.h"
+
 #include "libspu/core/value.h"
 
 namespace spu {
@@ -25,6 +29,13 @@ namespace spu::kernel::hlo {
 spu::Value Select(SPUContext *ctx, const spu::Value &pred,
                   const spu::Value &on_true, const spu::Value &on_false);
 
+// Select of every (on_true[i], on_false[i]) by the same pred, pred is either a
+// scalar or has the shape of every output. All secret outputs are selected by
+// one multiplication, so the batch takes a single round.
+std::vector<spu::Value> Select(SPUContext *ctx, const spu::Value &pred,
+                               absl::Span<const spu::Value> on_true,
+                               absl::Span<const spu::Value> on_false);
+
 spu::Value Clamp(SPUContext *ctx, const spu::Value &operand,
                  const spu::Value &min, const spu::Value &max);
 
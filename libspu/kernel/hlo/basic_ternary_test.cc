@@ -15,9 +15,12 @@
 #include "libspu/kernel/hlo/basic_ternary.h"
 
 #include "gtest/gtest.h"
+#include "xtensor/xio.hpp"
 
 #include "libspu/core/context.h"
 #include "libspu/core/value.h"
+#include "libspu/kernel/hal/public_helper.h"
+#include "libspu/kernel/hal/type_cast.h"
 #include "libspu/kernel/hlo/casting.h"
 #include "libspu/kernel/hlo/const.h"
 #include "libspu/kernel/test_util.h"
@@ -47,6 +50,56 @@ TEST_P(TernaryTest, SelectEmpty) {
       });
 }
 
+TEST_P(TernaryTest, SelectMultiOutputs) {
+  FieldType field = std::get<0>(GetParam());
+  ProtocolKind prot = std::get<1>(GetParam());
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(prot, field, lctx);
+        xt::xarray<float> x = {{1.5, -2.0, 3.0}, {4.0, 5.5, -6.0}};
+        xt::xarray<float> y = {{0.5, 1.0, 1.5}, {2.0, 2.5, 3.0}};
+        xt::xarray<int64_t> u = {1, 2, 3, 4};
+        xt::xarray<int64_t> v = {-1, -2, -3, -4};
+
+        std::vector<spu::Value> on_true = {
+            test::makeValue(&sctx, x, VIS_SECRET),
+            test::makeValue(&sctx, u, VIS_SECRET),
+            test::makeValue(&sctx, u, VIS_PUBLIC)};
+        std::vector<spu::Value> on_false = {
+            test::makeValue(&sctx, y, VIS_SECRET),
+            test::makeValue(&sctx, v, VIS_SECRET),
+            test::makeValue(&sctx, v, VIS_SECRET)};
+
+        for (bool p : {true, false}) {
+          auto pred = Seal(&sctx, Constant(&sctx, p, {}));
+
+          size_t actions = lctx->GetStats()->sent_actions;
+          auto single = Select(&sctx, pred, absl::MakeConstSpan(on_true, 1),
+                               absl::MakeConstSpan(on_false, 1));
+          size_t single_actions = lctx->GetStats()->sent_actions - actions;
+
+          actions = lctx->GetStats()->sent_actions;
+          auto ret = Select(&sctx, pred, on_true, on_false);
+          size_t batch_actions = lctx->GetStats()->sent_actions - actions;
+
+          // All outputs are selected in the rounds of a single select.
+          EXPECT_EQ(batch_actions, single_actions);
+          ASSERT_EQ(ret.size(), 3);
+
+          auto r0 =
+              hal::dump_public_as<float>(&sctx, hal::reveal(&sctx, ret[0]));
+          auto r1 =
+              hal::dump_public_as<int64_t>(&sctx, hal::reveal(&sctx, ret[1]));
+          auto r2 =
+              hal::dump_public_as<int64_t>(&sctx, hal::reveal(&sctx, ret[2]));
+          EXPECT_TRUE(xt::allclose(r0, p ? x : y, 0.01, 0.001)) << r0;
+          EXPECT_EQ(r1, p ? u : v);
+          EXPECT_EQ(r2, p ? u : v);
+        }
+      });
+}
+
 TEST_P(TernaryTest, ClampEmpty) {
   FieldType field = std::get<0>(GetParam());
   ProtocolKind prot = std::get<1>(GetParam());
@@ -14,11 +14,14 @@
 
 #include "libspu/kernel/hlo/control_flow.h"
 
+#include "libspu/kernel/hal/complex.h"
 #include "libspu/kernel/hal/constants.h"
 #include "libspu/kernel/hal/polymorphic.h"
 #include "libspu/kernel/hal/public_helper.h"
+#include "libspu/kernel/hal/ring.h"
 #include "libspu/kernel/hal/shape_ops.h"
 #include "libspu/kernel/hal/type_cast.h"
+#include "libspu/kernel/hlo/basic_ternary.h"
 #include "libspu/kernel/hlo/const.h"
 #include "libspu/kernel/hlo/utils.h"
 
@@ -37,13 +40,8 @@ std::vector<spu::Value> IfElse(SPUContext *ctx, const spu::Value &condition,
 
     SPU_ENFORCE(true_ret.size() == false_ret.size());
 
-    std::vector<spu::Value> selected(true_ret.size());
-    for (size_t idx = 0; idx < true_ret.size(); ++idx) {
-      selected[idx] =
-          hal::select(ctx, condition, true_ret[idx], false_ret[idx]);
-    }
-
-    return selected;
+    // All outputs share the condition, select them together.
+    return Select(ctx, condition, true_ret, false_ret);
   } else {
     bool v = hal::getBooleanValue(ctx, condition);
 
@@ -51,6 +49,78 @@ std::vector<spu::Value> IfElse(SPUContext *ctx, const spu::Value &condition,
   }
 }
 
+std::vector<spu::Value> Multiplex(
+    SPUContext *ctx, const spu::Value &mask,
+    absl::Span<const std::vector<spu::Value>> branches) {
+  SPU_ENFORCE(mask.isInt());
+  SPU_ENFORCE(!branches.empty());
+  SPU_ENFORCE_EQ(mask.numel(), static_cast<int64_t>(branches.size()));
+  const auto &first = branches.front();
+  auto flat_mask = hal::reshape(ctx, mask, {mask.numel()});
+
+  // Complex outputs are multiplexed as their real and imaginary parts.
+  std::vector<spu::Value> masks;
+  std::vector<spu::Value> parts;
+  for (int64_t branch_id = 0;
+       branch_id < static_cast<int64_t>(branches.size()); ++branch_id) {
+    const auto &r = branches[branch_id];
+    SPU_ENFORCE_EQ(r.size(), first.size());
+    // Slice mask
+    auto mask_i =
+        hal::slice(ctx, flat_mask, {branch_id}, {branch_id + 1}, {});
+
+    for (size_t result_id = 0; result_id < r.size(); ++result_id) {
+      const auto &ret = r[result_id];
+      SPU_ENFORCE(ret.shape() == first[result_id].shape());
+      SPU_ENFORCE(ret.dtype() == first[result_id].dtype());
+      SPU_ENFORCE(ret.isComplex() == first[result_id].isComplex());
+
+      Value mask_i_b;
+      if (ret.numel() == mask_i.numel()) {
+        mask_i_b = hal::reshape(ctx, mask_i, ret.shape());
+      } else {
+        mask_i_b = hal::broadcast_to(ctx, mask_i, ret.shape(), {});
+      }
+
+      if (ret.isComplex()) {
+        masks.insert(masks.end(), {mask_i_b, mask_i_b});
+        parts.emplace_back(hal::real(ctx, ret));
+        parts.emplace_back(hal::imag(ctx, ret));
+      } else {
+        masks.emplace_back(mask_i_b);
+        parts.emplace_back(ret);
+      }
+    }
+  }
+
+  // mask is an integer, so products need no truncation and the dtype of each
+  // output is kept.
+  auto products = hal::_mul(ctx, masks, parts);
+
+  // Collect results
+  const size_t parts_per_branch = parts.size() / branches.size();
+  std::vector<spu::Value> sums(parts_per_branch);
+  for (size_t pos = 0; pos < parts_per_branch; ++pos) {
+    auto r = products[pos];
+    for (size_t branch_id = 1; branch_id < branches.size(); ++branch_id) {
+      r = hal::_add(ctx, r, products[branch_id * parts_per_branch + pos]);
+    }
+    sums[pos] = r.setDtype(parts[pos].dtype());
+  }
+
+  std::vector<spu::Value> results;
+  size_t pos = 0;
+  for (const auto &ret : first) {
+    if (ret.isComplex()) {
+      results.emplace_back(hal::complex(ctx, sums[pos], sums[pos + 1]));
+      pos += 2;
+    } else {
+      results.emplace_back(std::move(sums[pos++]));
+    }
+  }
+  return results;
+}
+
 std::vector<spu::Value> Case(SPUContext *ctx, const spu::Value &index,
                              absl::Span<const BranchFcnT> branches) {
   SPU_ENFORCE(index.isInt());
@@ -77,38 +147,11 @@ std::vector<spu::Value> Case(SPUContext *ctx, const spu::Value &index,
                    hal::broadcast_to(ctx, normalized_index, indices.shape()));
 
     std::vector<std::vector<spu::Value>> values;
-    for (int64_t branch_id = 0;
-         branch_id < static_cast<int64_t>(branches.size()); ++branch_id) {
-      auto r = branches[branch_id]();
-      // Slice mask
-      auto mask_i = hal::slice(ctx, masks, {branch_id}, {branch_id + 1}, {});
-
-      for (auto &ret : r) {
-        Value mask_i_b;
-        if (ret.numel() == mask_i.numel()) {
-          mask_i_b = hal::reshape(ctx, mask_i, ret.shape());
-        } else {
-          mask_i_b = hal::broadcast_to(ctx, mask_i, ret.shape(), {});
-        }
-
-        ret = hal::mul(ctx, ret, mask_i_b);
-      }
-      values.emplace_back(std::move(r));
+    for (const auto &branch : branches) {
+      values.emplace_back(branch());
     }
 
-    // Collect results
-    std::vector<spu::Value> results(values.front().size());
-
-    for (int64_t result_id = 0;
-         result_id < static_cast<int64_t>(values.front().size()); ++result_id) {
-      auto r = values.front()[result_id];
-      for (int64_t branch_id = 1;
-           branch_id < static_cast<int64_t>(branches.size()); ++branch_id) {
-        r = hal::add(ctx, r, values[branch_id][result_id]);
-      }
-      results[result_id] = r;
-    }
-    return results;
+    return Multiplex(ctx, masks, values);
   }
 }
 
@@ -31,6 +31,13 @@ std::vector<spu::Value> IfElse(SPUContext *ctx, const spu::Value &condition,
 std::vector<spu::Value> Case(SPUContext *ctx, const spu::Value &index,
                              absl::Span<const BranchFcnT> branches);
 
+// Returns sum_j mask[j] * branches[j][i] for every output i, where mask is a
+// one-hot integer vector over the branches. The products of all branches and
+// outputs are done by a single multiplication.
+std::vector<spu::Value> Multiplex(
+    SPUContext *ctx, const spu::Value &mask,
+    absl::Span<const std::vector<spu::Value>> branches);
+
 /// While evaluation order:
 /// 1. Forward all args into cond block
 /// 2. Evaluate condition
@@ -14,13 +14,211 @@
 
 #include "libspu/kernel/hlo/convolution.h"
 
+#include <tuple>
+
+#include "spdlog/spdlog.h"
+
+#include "libspu/core/cexpr.h"
+#include "libspu/core/context.h"
 #include "libspu/core/value.h"
 #include "libspu/kernel/hal/polymorphic.h"
+#include "libspu/kernel/hal/ring.h"
 #include "libspu/kernel/hal/shape_ops.h"
+#include "libspu/kernel/hlo/utils.h"
 
 namespace spu::kernel::hlo {
 
-// This is an optimized conv2D with im2col
+namespace {
+
+// When two lowerings cost the same communication, im2col is replaced by window
+// accumulation once the expanded input exceeds this many elements.
+constexpr int64_t kMaxIm2colElements = int64_t{1} << 26;
+
+struct Conv2DDims {
+  int64_t N, H, W, C;  // input
+  int64_t h, w, O;     // kernel
+  int64_t hh, ww;      // output
+  int64_t sh, sw;      // strides
+};
+
+// Communication of one secret x secret (M, K) x (K, L) matmul in bits, by the
+// cost model of the protocol's mmul_aa kernel. Kernels without a static model
+// count as free, which leaves the choice to rounds and memory.
+int64_t mmulCommCost(SPUContext *ctx, int64_t M, int64_t K, int64_t L) {
+  if (!ctx->hasKernel("mmul_aa")) {
+    return 0;
+  }
+  const auto *kernel = ctx->getKernel("mmul_aa");
+  if (kernel->kind() == Kernel::Kind::Dynamic) {
+    return 0;
+  }
+  const auto comm = kernel->comm();
+  if (comm == nullptr) {
+    return 0;
+  }
+  const ce::Params params = {{"K", SizeOf(ctx->getField()) * 8},
+                             {"N", ctx->lctx()->WorldSize()},
+                             {"m", static_cast<ce::Value>(M)},
+                             {"n", static_cast<ce::Value>(L)},
+                             {"k", static_cast<ce::Value>(K)}};
+  return static_cast<int64_t>(comm->eval(params));
+}
+
+struct ConvCost {
+  int64_t comm = 0;
+  int64_t rounds = 0;
+  // Peak elements materialized by the lowering exceed the local budget.
+  bool over_budget = false;
+
+  bool operator<(const ConvCost &other) const {
+    return std::tie(comm, rounds, over_budget) <
+           std::tie(other.comm, other.rounds, other.over_budget);
+  }
+};
+
+bool isAvailable(RuntimeConfig::ConvStrategy strategy, const Value &input,
+                 const Value &kernel) {
+  switch (strategy) {
+    case RuntimeConfig::CONV_IM2COL:
+      return true;
+    case RuntimeConfig::CONV_WINDOW:
+      // Partial products are summed before one truncation, which needs a
+      // common dtype.
+      return input.dtype() == kernel.dtype();
+    default:
+      return false;
+  }
+}
+
+ConvCost estimateCost(SPUContext *ctx, RuntimeConfig::ConvStrategy strategy,
+                      const Value &input, const Value &kernel,
+                      const Conv2DDims &d) {
+  const bool ss = input.isSecret() && kernel.isSecret();
+  const int64_t M = d.N * d.hh * d.ww;
+
+  ConvCost cost;
+  switch (strategy) {
+    case RuntimeConfig::CONV_IM2COL: {
+      if (ss) {
+        cost.comm = mmulCommCost(ctx, M, d.h * d.w * d.C, d.O);
+        cost.rounds = 1;
+      }
+      cost.over_budget = M * d.h * d.w * d.C > kMaxIm2colElements;
+      break;
+    }
+    case RuntimeConfig::CONV_WINDOW: {
+      if (ss) {
+        cost.comm = d.h * d.w * mmulCommCost(ctx, M, d.C, d.O);
+        cost.rounds = d.h * d.w;
+      }
+      break;
+    }
+    default:
+      SPU_THROW("unknown conv strategy {}", static_cast<int>(strategy));
+  }
+  return cost;
+}
+
+RuntimeConfig::ConvStrategy selectStrategy(SPUContext *ctx,
+                                           const Value &input,
+                                           const Value &kernel,
+                                           const Conv2DDims &d) {
+  const auto configured = ctx->config().conv_strategy();
+  if (configured != RuntimeConfig::CONV_DEFAULT) {
+    if (isAvailable(configured, input, kernel)) {
+      return configured;
+    }
+    SPDLOG_WARN(
+        "Conv strategy {} is not available for input={}, kernel={}, falling "
+        "back to cost based selection.",
+        RuntimeConfig::ConvStrategy_Name(configured), input, kernel);
+  }
+
+  auto best = RuntimeConfig::CONV_IM2COL;
+  if (isAvailable(RuntimeConfig::CONV_WINDOW, input, kernel) &&
+      estimateCost(ctx, RuntimeConfig::CONV_WINDOW, input, kernel, d) <
+          estimateCost(ctx, best, input, kernel, d)) {
+    best = RuntimeConfig::CONV_WINDOW;
+  }
+  return best;
+}
+
+// im2col: expand windows then contract with one large mmul, which benefits
+// from mmul split and beaver caching of the kernel.
+spu::Value im2colConv2D(SPUContext *ctx, const spu::Value &input,
+                        const spu::Value &kernel, const Conv2DDims &d) {
+  const auto [N, H, W, C, h, w, O, hh, ww, sh, sw] = d;
+
+  // expand the image according to the kernel size.
+  // assumption:
+  // - padding is erased by some compiler pass.
+  // - input  : NxHxWxC
+  // - kernel : hxwxCxO
+  //
+  // The windows are a strided view of input, (1, hh, ww, 1, N, h, w, C), which
+  // is materialized once by the reshape below.
+  std::vector<std::pair<int64_t, int64_t>> padding(4, {0, 0});
+  auto expanded = expandWindow(ctx, input,      // input
+                               {N, h, w, C},    // window_shape
+                               {1, sh, sw, 1},  // strides
+                               padding, spu::Value());
+  expanded = hal::reshape(ctx, expanded, {hh * ww, N, h * w, C});
+  expanded = hal::transpose(ctx, expanded, {1, 0, 2, 3});
+
+  // Now expanded shape is (N, hh*ww, h*w, C)
+  SPU_ENFORCE_EQ(expanded.shape()[0], N);
+  SPU_ENFORCE_EQ(expanded.shape()[1], hh * ww);
+  SPU_ENFORCE_EQ(expanded.shape()[2], h * w);
+  SPU_ENFORCE_EQ(expanded.shape()[3], C);
+
+  // Reshape it to (N, hh, ww, h, w, C)
+  expanded = hal::reshape(ctx, expanded, {N, hh, ww, h, w, C});
+
+  // Contract on h, w, C
+  // expanded:  (N, hh, ww, h, w, C)
+  // kernel:               (h, w, C, O)
+  // result:    (N, hh, ww,          O)
+  auto result = hal::tensordot(ctx, expanded, kernel, {3, 4, 5}, {0, 1, 2});
+  SPU_ENFORCE_EQ(result.shape()[0], N);
+  SPU_ENFORCE_EQ(result.shape()[1], hh);
+  SPU_ENFORCE_EQ(result.shape()[2], ww);
+  SPU_ENFORCE_EQ(result.shape()[3], O);
+
+  return result;
+}
+
+// Window accumulation: for every kernel offset (x, y), contract the strided
+// input view with kernel[x, y, :, :] and sum the partial products on the ring,
+// truncating once at the end. Nothing is expanded.
+spu::Value windowConv2D(SPUContext *ctx, const spu::Value &input,
+                        const spu::Value &kernel, const Conv2DDims &d) {
+  const auto [N, H, W, C, h, w, O, hh, ww, sh, sw] = d;
+  const int64_t M = N * hh * ww;
+
+  spu::Value acc;
+  for (int64_t x = 0; x < h; ++x) {
+    for (int64_t y = 0; y < w; ++y) {
+      auto window = hal::slice(ctx, input, {0, x, y, 0},
+                               {N, x + (hh - 1) * sh + 1, y + (ww - 1) * sw + 1,
+                                C},
+                               {1, sh, sw, 1});
+      auto filter =
+          hal::slice(ctx, kernel, {x, y, 0, 0}, {x + 1, y + 1, C, O}, {});
+      auto partial = hal::_mmul(ctx, hal::reshape(ctx, window, {M, C}),
+                                hal::reshape(ctx, filter, {C, O}));
+      acc = (x == 0 && y == 0) ? partial : hal::_add(ctx, acc, partial);
+    }
+  }
+
+  if (input.isFxp()) {
+    acc = hal::_trunc(ctx, acc);
+  }
+  acc.setDtype(input.dtype());
+  return hal::reshape(ctx, acc, {N, hh, ww, O});
+}
+
+}  // namespace
+
 spu::Value Convolution2D(SPUContext *ctx, const spu::Value &input,
                          const spu::Value &kernel,
                          const ConvolutionConfig &config,
@@ -53,57 +251,13 @@ spu::Value Convolution2D(SPUContext *ctx, const spu::Value &input,
   SPU_ENFORCE_EQ(hh, (H - h) / sh + 1);
   SPU_ENFORCE_EQ(ww, (W - w) / sw + 1);
 
-  // Fallback, use im2col + dot to implement convolution
-  {
-    // expand the image according to the kernel size.
-    // assumption:
-    // - padding is erased by some compiler pass.
-    // - input  : NxHxWxC
-    // - kernel : hxwxCxO
-    Value expanded;
-    {
-      std::vector<spu::Value> images;
-      for (int64_t x = 0; x <= H - h; x += sh) {
-        for (int64_t y = 0; y <= W - w; y += sw) {
-          auto window =
-              hal::slice(ctx, input, {0, x, y, 0}, {N, x + h, y + w, C}, {});
-          images.emplace_back(hal::reshape(ctx, window, {N, 1, h, w, C}));
-        }
-      }
-      auto stacked = hal::concatenate(ctx, images, 1);
-      SPU_ENFORCE_EQ(stacked.shape()[1], hh * ww);
-      expanded = hal::reshape(ctx, stacked, {N, hh * ww, h * w, C});
-    }
+  const Conv2DDims dims{N, H, W, C, h, w, O, hh, ww, sh, sw};
 
-    // TODO(jint): the below method is much slower then the code above, consider
-    // to use slice+reshape+concat to rewrite expandWindow.
-    //
-    // std::vector<std::pair<int64_t, int64_t>> padding(4, {0, 0});
-    // auto expanded = expandWindow(ctx, input,      // input
-    //                                    {N, h, w, C},    // window_shape
-    //                                    {1, sh, sw, 1},  // strides
-    //                                    padding);
-
-    // Now expanded shape is (N, hh*ww, h*w, C)
-    SPU_ENFORCE_EQ(expanded.shape()[0], N);
-    SPU_ENFORCE_EQ(expanded.shape()[1], hh * ww);
-    SPU_ENFORCE_EQ(expanded.shape()[2], h * w);
-    SPU_ENFORCE_EQ(expanded.shape()[3], C);
-
-    // Reshape it to (N, hh, ww, h, w, C)
-    expanded = hal::reshape(ctx, expanded, {N, hh, ww, h, w, C});
-
-    // Contract on h, w, C
-    // expanded:  (N, hh, ww, h, w, C)
-    // kernel:               (h, w, C, O)
-    // result:    (N, hh, ww,          O)
-    auto result = hal::tensordot(ctx, expanded, kernel, {3, 4, 5}, {0, 1, 2});
-    SPU_ENFORCE_EQ(result.shape()[0], N);
-    SPU_ENFORCE_EQ(result.shape()[1], hh);
-    SPU_ENFORCE_EQ(result.shape()[2], ww);
-    SPU_ENFORCE_EQ(result.shape()[3], O);
-
-    return result;
+  switch (selectStrategy(ctx, input, kernel, dims)) {
+    case RuntimeConfig::CONV_WINDOW:
+      return windowConv2D(ctx, input, kernel, dims);
+    default:
+      return im2colConv2D(ctx, input, kernel, dims);
   }
 }
 
@@ -35,7 +35,10 @@ struct ConvolutionConfig {
   Axes outputSpatialDimensions;
 };
 
-// This is an optimized conv2D with im2col
+// 2-d convolution, NHWC input and HWCO kernel. The lowering (im2col + one
+// mmul, or per-offset window accumulation) follows RuntimeConfig.conv_strategy,
+// by default the cheaper one under the cost model of the protocol's mmul_aa
+// kernel.
 spu::Value Convolution2D(SPUContext *ctx, const spu::Value &input,
                          const spu::Value &kernel,
                          const ConvolutionConfig &config,
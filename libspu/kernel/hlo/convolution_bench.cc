@@ -0,0 +1,89 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+
+#include "libspu/kernel/bench_util.h"
+#include "libspu/kernel/hlo/convolution.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::kernel::hlo {
+
+struct ConvLayer {
+  int64_t H, W, C;  // input
+  int64_t h, w, O;  // kernel
+  int64_t s;        // stride
+};
+
+// Common CNN layer shapes.
+const ConvLayer kLayers[] = {
+    {28, 28, 1, 5, 5, 16, 1},   // LeNet conv1
+    {32, 32, 16, 3, 3, 16, 1},  // ResNet basic block, CIFAR
+    {16, 16, 32, 3, 3, 64, 2},  // ResNet downsample
+    {8, 8, 64, 1, 1, 128, 1},   // pointwise
+};
+
+// Secret input, secret kernel, batch of 1, FM64.
+static void BM_Conv2D(benchmark::State &state) {
+  const auto &layer = kLayers[state.range(0)];
+  const auto prot = static_cast<ProtocolKind>(state.range(1));
+  const auto strategy =
+      static_cast<RuntimeConfig::ConvStrategy>(state.range(2));
+  const size_t npc = prot == ProtocolKind::CHEETAH ? 2 : 3;
+
+  xt::xarray<float> x = test::xt_random<float>(
+      {1, static_cast<size_t>(layer.H), static_cast<size_t>(layer.W),
+       static_cast<size_t>(layer.C)},
+      -1, 1);
+  xt::xarray<float> k = test::xt_random<float>(
+      {static_cast<size_t>(layer.h), static_cast<size_t>(layer.w),
+       static_cast<size_t>(layer.C), static_cast<size_t>(layer.O)},
+      -1, 1);
+
+  ConvolutionConfig config;
+  config.window_strides = {layer.s, layer.s};
+  const Shape result_shape = {1, (layer.H - layer.h) / layer.s + 1,
+                              (layer.W - layer.w) / layer.s + 1, layer.O};
+
+  RuntimeConfig conf;
+  conf.set_protocol(prot);
+  conf.set_field(FieldType::FM64);
+  conf.set_conv_strategy(strategy);
+
+  bench::runKernelBench(
+      state, conf,
+      [&](SPUContext *ctx) {
+        auto input = test::makeValue(ctx, x, VIS_SECRET);
+        auto kernel = test::makeValue(ctx, k, VIS_SECRET);
+        benchmark::DoNotOptimize(
+            Convolution2D(ctx, input, kernel, config, result_shape));
+      },
+      npc);
+}
+
+BENCHMARK(BM_Conv2D)
+    ->ArgNames({"layer", "prot", "strategy"})
+    ->ArgsProduct({
+        benchmark::CreateDenseRange(0, std::size(kLayers) - 1, /*step=*/1),
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3, ProtocolKind::CHEETAH},
+        {RuntimeConfig::CONV_DEFAULT, RuntimeConfig::CONV_IM2COL,
+         RuntimeConfig::CONV_WINDOW},
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+}  // namespace spu::kernel::hlo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/kernel/hlo/convolution.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/core/context.h"
+#include "libspu/core/value.h"
+#include "libspu/kernel/hlo/casting.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::kernel::hlo {
+
+class ConvStrategyTest
+    : public ::testing::TestWithParam<
+          std::tuple<ProtocolKind, RuntimeConfig::ConvStrategy, Visibility>> {
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    ConvStrategy, ConvStrategyTest,
+    testing::Combine(testing::Values(ProtocolKind::SEMI2K, ProtocolKind::ABY3),
+                     testing::Values(RuntimeConfig::CONV_DEFAULT,
+                                     RuntimeConfig::CONV_IM2COL,
+                                     RuntimeConfig::CONV_WINDOW),
+                     testing::Values(VIS_PUBLIC, VIS_SECRET)),
+    [](const testing::TestParamInfo<ConvStrategyTest::ParamType> &p) {
+      return fmt::format("{}_{}_{}", std::get<0>(p.param),
+                         RuntimeConfig::ConvStrategy_Name(std::get<1>(p.param)),
+                         std::get<2>(p.param));
+    });
+
+TEST_P(ConvStrategyTest, Conv2D) {
+  const auto prot = std::get<0>(GetParam());
+  const auto strategy = std::get<1>(GetParam());
+  const auto kernel_vis = std::get<2>(GetParam());
+
+  // input: 2x5x6x3, kernel: 3x2x3x4, strides: 2x1
+  xt::xarray<float> x = test::xt_random<float>({2, 5, 6, 3}, -1, 1);
+  xt::xarray<float> k = test::xt_random<float>({3, 2, 3, 4}, -1, 1);
+
+  ConvolutionConfig config;
+  config.window_strides = {2, 1};
+  const Shape result_shape = {2, 2, 5, 4};
+
+  xt::xarray<float> expected = xt::zeros<float>({2, 2, 5, 4});
+  for (size_t n = 0; n < 2; ++n) {
+    for (size_t i = 0; i < 2; ++i) {
+      for (size_t j = 0; j < 5; ++j) {
+        for (size_t o = 0; o < 4; ++o) {
+          for (size_t dx = 0; dx < 3; ++dx) {
+            for (size_t dy = 0; dy < 2; ++dy) {
+              for (size_t c = 0; c < 3; ++c) {
+                expected(n, i, j, o) +=
+                    x(n, i * 2 + dx, j + dy, c) * k(dx, dy, c, o);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        RuntimeConfig conf;
+        conf.set_protocol(prot);
+        conf.set_field(FieldType::FM64);
+        conf.set_conv_strategy(strategy);
+        SPUContext sctx = test::makeSPUContext(conf, lctx);
+
+        auto input = test::makeValue(&sctx, x, VIS_SECRET);
+        auto kernel = test::makeValue(&sctx, k, kernel_vis);
+
+        auto ret = Convolution2D(&sctx, input, kernel, config, result_shape);
+        EXPECT_EQ(ret.shape(), result_shape);
+
+        auto p_ret = hal::dump_public_as<float>(&sctx, Reveal(&sctx, ret));
+        EXPECT_TRUE(xt::allclose(p_ret, expected, 0.01, 0.001))
+            << p_ret << std::endl
+            << expected << std::endl;
+      });
+}
+
+}  // namespace spu::kernel::hlo
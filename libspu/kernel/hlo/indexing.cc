@@ -845,6 +845,57 @@ spu::Value SecretDynamicSlice(SPUContext *ctx, const spu::Value &operand,
                                     adjusted_start_indices);
 }
 
+spu::Value SecretRowGather(SPUContext *ctx, const spu::Value &operand,
+                           const spu::Value &indices) {
+  SPU_ENFORCE(indices.shape().size() == 1, "expect 1-d indices, got {}",
+              indices.shape());
+  SPU_ENFORCE(!operand.shape().empty());
+  SPU_ENFORCE(!operand.isComplex());
+
+  const int64_t num_rows = operand.shape()[0];
+  const int64_t num_indices = indices.numel();
+  SPU_ENFORCE(num_rows > 0 && num_indices > 0);
+
+  Shape result_shape = operand.shape();
+  result_shape[0] = num_indices;
+
+  // Clamp all indices at once.
+  auto lower_bound = hal::dtype_cast(
+      ctx, hlo::Constant(ctx, static_cast<int64_t>(0), indices.shape()),
+      indices.dtype());
+  auto upper_bound = hal::dtype_cast(
+      ctx, hlo::Constant(ctx, num_rows - 1, indices.shape()), indices.dtype());
+  auto clamped = hal::clamp(ctx, indices, lower_bound, upper_bound);
+
+  // Reshape from XxYxZ to Xx(Y*Z)
+  auto table = operand;
+  if (table.shape().size() != 2) {
+    table = hal::reshape(ctx, table, {num_rows, operand.numel() / num_rows});
+  }
+
+  // All onehots are built in one batch, so the rounds do not depend on the
+  // number of indices.
+  auto onehot = hal::oramonehot(ctx, clamped, num_rows, operand.isPublic());
+
+  spu::Value result;
+  if (onehot.has_value()) {
+    result = hal::oramread(ctx, *onehot, table, 0);
+  } else {
+    // mask[i, j] = (indices[i] == j)
+    auto idx_iota = hal::iota(ctx, clamped.dtype(), num_rows);
+    auto mask = hal::equal(
+        ctx,
+        hal::broadcast_to(ctx, hal::reshape(ctx, clamped, {num_indices, 1}),
+                          {num_indices, num_rows}),
+        hal::broadcast_to(ctx, hal::reshape(ctx, idx_iota, {1, num_rows}),
+                          {num_indices, num_rows}));
+    hal::detail::hintNumberOfBits(mask, 1);
+    result = hal::matmul(ctx, mask, table);
+  }
+
+  return hal::reshape(ctx, result, result_shape);
+}
+
 spu::Value DynamicSlice(SPUContext *ctx, const spu::Value &operand,
                         const Sizes &slice_size,
                         absl::Span<const spu::Value> start_indices) {
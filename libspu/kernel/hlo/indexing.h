@@ -44,6 +44,14 @@ spu::Value DynamicSlice(SPUContext *ctx, const spu::Value &operand,
                         const Sizes &slice_size,
                         absl::Span<const spu::Value> start_indices);
 
+// Gather rows operand[indices[i], ...] with a 1-d secret index vector, out of
+// range indices are clamped like dynamic_slice.
+//
+// Uses ORAM reads when the protocol provides them, otherwise all indices are
+// one-hot encoded with a single batched comparison and applied with a matmul.
+spu::Value SecretRowGather(SPUContext *ctx, const spu::Value &operand,
+                           const spu::Value &indices);
+
 /// ------------------- non-XLA APIs ------------------------------------
 // @brief Update slice
 spu::Value UpdateSlice(SPUContext *ctx, const spu::Value &in,
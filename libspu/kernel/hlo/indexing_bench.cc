@@ -0,0 +1,61 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+
+#include "libspu/kernel/bench_util.h"
+#include "libspu/kernel/hlo/indexing.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::kernel::hlo {
+
+// Embedding lookup: gather `num_indices` secret rows out of a secret
+// `num_rows` x `dim` table. ABY3 takes the ORAM path, SEMI2K falls back to the
+// batched one-hot matmul. Both take the same rounds for any number of indices.
+static void BM_SecretRowGather(benchmark::State &state) {
+  const int64_t num_rows = state.range(0);
+  const int64_t dim = state.range(1);
+  const int64_t num_indices = state.range(2);
+  const auto prot = static_cast<ProtocolKind>(state.range(3));
+
+  xt::xarray<float> table =
+      test::xt_random<float>({static_cast<size_t>(num_rows),
+                              static_cast<size_t>(dim)},
+                             -1, 1);
+  xt::xarray<int64_t> indices =
+      test::xt_random<int64_t>({static_cast<size_t>(num_indices)}, 0,
+                               static_cast<double>(num_rows - 1));
+
+  bench::runKernelBench(state, prot, [&](SPUContext *ctx) {
+    auto s_table = test::makeValue(ctx, table, VIS_SECRET);
+    auto s_indices = test::makeValue(ctx, indices, VIS_SECRET);
+    benchmark::DoNotOptimize(SecretRowGather(ctx, s_table, s_indices));
+  });
+}
+
+BENCHMARK(BM_SecretRowGather)
+    ->ArgNames({"rows", "dim", "indices", "prot"})
+    ->ArgsProduct({
+        {1000, 100000},                            // rows
+        {64},                                      // dim
+        {1, 16},                                   // indices
+        {ProtocolKind::ABY3, ProtocolKind::SEMI2K},  // protocol
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+}  // namespace spu::kernel::hlo
+
+BENCHMARK_MAIN();
@@ -14,7 +14,11 @@
 
 #include "libspu/kernel/hlo/indexing.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xview.hpp"
 
 #include "libspu/core/context.h"
 #include "libspu/core/ndarray_ref.h"
@@ -23,6 +27,8 @@
 #include "libspu/kernel/hlo/casting.h"
 #include "libspu/kernel/hlo/const.h"
 #include "libspu/kernel/test_util.h"
+#include "libspu/mpc/common/communicator.h"
+#include "libspu/mpc/utils/simulate.h"
 
 namespace spu::kernel::hlo {
 
@@ -258,4 +264,76 @@ TEST(DynamicSliceTest, DynamicSliceWithSecretIndicesOffRangeHigh) {
       << expected << std::endl;
 }
 
+TEST(SecretRowGatherTest, GatherRows) {
+  SPUContext sctx = test::makeSPUContext();
+  xt::xarray<float> x = {{0.5, 1}, {2, 3}, {4, 5}, {6, 7}};
+  auto input = test::makeValue(&sctx, x, VIS_SECRET);
+  xt::xarray<int64_t> idx = {3, 0, -1, 10, 2};
+  auto indices = test::makeValue(&sctx, idx, VIS_SECRET);
+
+  auto output = SecretRowGather(&sctx, input, indices);
+  EXPECT_EQ(output.shape(), Shape({5, 2}));
+
+  auto p_ret = hal::dump_public_as<float>(&sctx, Reveal(&sctx, output));
+  xt::xarray<float> expected{{6, 7}, {0.5, 1}, {0.5, 1}, {6, 7}, {4, 5}};
+  EXPECT_TRUE(xt::allclose(p_ret, expected, 0.01, 0.001))
+      << p_ret << std::endl
+      << expected << std::endl;
+}
+
+class SecretRowGatherProtTest
+    : public ::testing::TestWithParam<
+          std::tuple<FieldType, ProtocolKind, Visibility>> {};
+
+TEST_P(SecretRowGatherProtTest, GatherRows) {
+  FieldType field = std::get<0>(GetParam());
+  ProtocolKind prot = std::get<1>(GetParam());
+  Visibility table_vis = std::get<2>(GetParam());
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(prot, field, lctx);
+        xt::xarray<int64_t> x = xt::arange<int64_t>(5 * 2 * 3);
+        x.reshape({5, 2, 3});
+        auto input = test::makeValue(&sctx, x, table_vis);
+
+        auto *comm = sctx.getState<mpc::Communicator>();
+        auto gather = [&](const xt::xarray<int64_t> &idx) {
+          auto indices = test::makeValue(&sctx, idx, VIS_SECRET);
+          auto before = comm->getStats();
+          auto output = SecretRowGather(&sctx, input, indices);
+          auto latency = (comm->getStats() - before).latency;
+          return std::make_pair(output, latency);
+        };
+
+        auto [single, single_latency] = gather({4});
+        xt::xarray<int64_t> idx = {3, 0, -1, 10, 2, 4, 1, 3};
+        auto [output, latency] = gather(idx);
+
+        // All indices are looked up in the rounds of a single one.
+        EXPECT_EQ(latency, single_latency);
+        EXPECT_EQ(single.shape(), Shape({1, 2, 3}));
+        ASSERT_EQ(output.shape(), Shape({8, 2, 3}));
+
+        auto ret = hal::dump_public_as<int64_t>(&sctx, Reveal(&sctx, output));
+        for (size_t i = 0; i < idx.size(); ++i) {
+          int64_t row = std::clamp<int64_t>(idx(i), 0, 4);
+          EXPECT_EQ(xt::xarray<int64_t>(xt::view(ret, i)),
+                    xt::xarray<int64_t>(xt::view(x, row)))
+              << "index " << idx(i);
+        }
+      });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SecretRowGatherProtTestInstances, SecretRowGatherProtTest,
+    testing::Combine(testing::Values(FieldType::FM64, FieldType::FM128),
+                     testing::Values(ProtocolKind::REF2K, ProtocolKind::SEMI2K,
+                                     ProtocolKind::ABY3),
+                     testing::Values(VIS_SECRET, VIS_PUBLIC)),
+    [](const testing::TestParamInfo<SecretRowGatherProtTest::ParamType> &p) {
+      return fmt::format("{}x{}x{}", std::get<0>(p.param),
+                         std::get<1>(p.param), std::get<2>(p.param));
+    });
+
 }  // namespace spu::kernel::hlo
@@ -20,64 +20,9 @@
 
 namespace spu::kernel::hlo {
 
-namespace {
-std::vector<spu::Value> TopkApply(SPUContext *ctx, const spu::Value &input,
-                                  const Rank1dFn &apply_fn) {
-  const Shape &shape = input.shape();
-
-  // Topk always deals last-dimension
-  // - N is the number of vector to permute
-  // - W is the vector length.
-  const int64_t W = shape.back();
-  const int64_t N = shape.numel() / W;
-
-  // First, reshape the input to (N, W)
-  auto reshaped = hal::reshape(ctx, input, {N, W});
-
-  // Then, do topk in last dimension
-  std::vector<std::vector<spu::Value>> topk1d;
-  topk1d.reserve(N);
-  for (int64_t i = 0; i < N; ++i) {
-    // TODO: how to do these parallelly?
-    auto input_i =
-        hal::reshape(ctx, hal::slice(ctx, reshaped, {i, 0}, {i + 1, W}), {W});
-    topk1d.push_back(apply_fn(input_i));
-  }
-
-  const bool include_index = topk1d[0].size() == 2;
-
-  // the output shape is (..., k)
-  Shape new_shape(shape.begin(), shape.end());
-  const auto k = topk1d[0][0].numel();
-  new_shape.back() = k;
-
-  // Finally, Reshape back to shape
-  std::vector<spu::Value> ret;
-  ret.reserve(2);
-
-  std::vector<spu::Value> value2d;
-  value2d.reserve(N);
-  for (int64_t i = 0; i < N; ++i) {
-    value2d.push_back(hal::reshape(ctx, topk1d[i][0], {1, k}));
-  }
-  auto ret_val = hal::concatenate(ctx, value2d, 0);
-  ret.push_back(hal::reshape(ctx, ret_val, new_shape));
-  if (include_index) {
-    std::vector<spu::Value> index2d;
-    index2d.reserve(N);
-    for (int64_t i = 0; i < N; ++i) {
-      index2d.push_back(hal::reshape(ctx, topk1d[i][1], {1, k}));
-    }
-    auto ret_inx = hal::concatenate(ctx, index2d, 0);
-    ret.push_back(hal::reshape(ctx, ret_inx, new_shape));
-  }
-  return ret;
-}
-}  // namespace
-
 std::vector<spu::Value> TopK(SPUContext *ctx, const spu::Value &input,
                              int64_t k_lo, int64_t k_hi, bool largest,
-                             bool value_only) {
+                             bool value_only, hal::TopKMethod method) {
   const Shape &shape = input.shape();
   SPU_ENFORCE(shape.numel() > 0, "input must non-empty.");
   SPU_ENFORCE(
@@ -101,13 +46,27 @@ std::vector<spu::Value> TopK(SPUContext *ctx, const spu::Value &input,
     }
   };
 
-  hal::TopKConfig config = {value_only, false, k_lo, k_hi};
+  hal::TopKConfig config = {value_only, false, k_lo, k_hi, method};
 
-  auto topk_fn = [&](const spu::Value &input) {
-    return hal::topk_1d(ctx, input, scalar_cmp_fn, config);
-  };
+  // Topk always deals last-dimension
+  // - N is the number of vector to permute
+  // - W is the vector length.
+  const int64_t W = shape.back();
+  const int64_t N = shape.numel() / W;
+
+  auto topk2d = hal::topk_2d(ctx, hal::reshape(ctx, input, {N, W}),
+                             scalar_cmp_fn, config);
 
-  return TopkApply(ctx, input, topk_fn);
+  // the output shape is (..., k)
+  Shape new_shape(shape.begin(), shape.end());
+  new_shape.back() = k_hi;
+
+  std::vector<spu::Value> ret;
+  ret.reserve(topk2d.size());
+  for (const auto &item : topk2d) {
+    ret.push_back(hal::reshape(ctx, item, new_shape));
+  }
+  return ret;
 }
 
 }  // namespace spu::kernel::hlo
@@ -33,8 +33,10 @@ using Rank1dFn = std::function<std::vector<spu::Value>(const spu::Value &)>;
 // largest `k_hi` values (and indices), among which the `k_lo`-th element is
 // exactly the `k_lo`-th largest element (other positions not guaranteed
 // sorted)
+// 5. `method` picks the topk algorithm, see hal::TopKMethod.
 std::vector<spu::Value> TopK(SPUContext *ctx, const spu::Value &input,
                              int64_t k_lo, int64_t k_hi = -1,
-                             bool largest = true, bool value_only = false);
+                             bool largest = true, bool value_only = false,
+                             hal::TopKMethod method = hal::TopKMethod::Auto);
 
 }  // namespace spu::kernel::hlo
\ No newline at end of file
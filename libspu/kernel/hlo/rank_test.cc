@@ -16,6 +16,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xtensor/xsort.hpp"
+#include "xtensor/xview.hpp"
 
 #include "libspu/core/context.h"
 #include "libspu/core/value.h"
@@ -374,6 +375,59 @@ TEST_P(TopkTest, ValueOnlyTest) {
       });
 }
 
+TEST_P(TopkTest, TournamentTest) {
+  size_t npc = std::get<0>(GetParam());
+  FieldType field = std::get<1>(GetParam());
+  ProtocolKind prot = std::get<2>(GetParam());
+
+  mpc::utils::simulate(
+      npc, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(prot, field, lctx);
+
+        // 3 rows of 10, k = 3 is rounded up to a group of 4.
+        xt::xarray<double> a = {
+            {3.2, 0.2, 3.1, 0.2, -0.2, 5.5, 1.1, -3.0, 2.0, 0.7},
+            {0.2, -0.2, 0, 1, 0.12, -1.5, 2.5, 0.3, 0.4, 0.5},
+            {-1, -2, -3, -4, -5, -6, -7, -8, -9, -10}};
+        int64_t k = 3;
+        for (bool largest : {true, false}) {
+          auto inp = test::makeValue(&sctx, a, VIS_SECRET);
+          auto out = TopK(&sctx, inp, k, -1, largest, false,
+                          hal::TopKMethod::Tournament);
+
+          auto val_pub =
+              hal::dump_public_as<float>(&sctx, hal::reveal(&sctx, out[0]));
+          auto ind_pub =
+              hal::dump_public_as<int64_t>(&sctx, hal::reveal(&sctx, out[1]));
+
+          xt::xarray<float> gt_val;
+          xt::xarray<int64_t> gt_ind;
+          if (largest) {
+            gt_val = {{5.5F, 3.2F, 3.1F}, {2.5F, 1.0F, 0.5F}, {-1, -2, -3}};
+            gt_ind = {{5, 0, 2}, {6, 3, 9}, {0, 1, 2}};
+          } else {
+            gt_val = {{-3.0F, -0.2F, 0.2F}, {-1.5F, -0.2F, 0}, {-10, -9, -8}};
+            gt_ind = {{7, 4, 1}, {5, 1, 2}, {9, 8, 7}};
+          }
+
+          ASSERT_THAT(val_pub.shape(),
+                      testing::ElementsAre(inp.shape().front(), k));
+          // The tournament returns each row in sorted order.
+          EXPECT_TRUE(xt::allclose(val_pub, gt_val, 0.001, 0.001))
+              << val_pub << std::endl
+              << gt_val;
+          // Ties (0.2 in the first row) may pick either index.
+          if (largest) {
+            EXPECT_TRUE(xt::all(xt::equal(ind_pub, gt_ind))) << ind_pub;
+          } else {
+            EXPECT_TRUE(xt::all(xt::equal(xt::view(ind_pub, xt::range(1, 3)),
+                                          xt::view(gt_ind, xt::range(1, 3)))))
+                << ind_pub;
+          }
+        }
+      });
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Topk2PCTestInstances, TopkTest,
     testing::Combine(testing::Values(2),
@@ -16,7 +16,6 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <stack>
 #include <vector>
 
 #include "libspu/kernel/hal/constants.h"
@@ -38,70 +37,44 @@ std::vector<spu::Value> TreeReduce(SPUContext *ctx,
 
   std::vector<spu::Value> lhs(nargs);
   std::vector<spu::Value> rhs(nargs);
-
-  std::stack<std::vector<spu::Value>> tails;
-
-  Index slice_begin(inputs.back().shape().size(), 0);
-  Index slice_end(inputs.back().shape().begin(), inputs.back().shape().end());
-  Strides slice_strides(inputs.back().shape().size(), 1);
+  std::vector<spu::Value> tail(nargs);
+
+  auto slice_axis = [&](const spu::Value &in, int64_t begin, int64_t end) {
+    Index slice_begin(in.shape().size(), 0);
+    Index slice_end(in.shape().begin(), in.shape().end());
+    slice_begin[axis] = begin;
+    slice_end[axis] = end;
+    return hal::slice(ctx, in, slice_begin, slice_end, {});
+  };
+
+  // An odd tail is passed through to the next level instead of being reduced
+  // afterwards, so a length n axis takes exactly ceil(lg(n)) reducer calls.
+  //
+  // consider len = 63, levels are 63 -> 32 -> 16 -> 8 -> 4 -> 2 -> 1.
   int64_t len = outputs[0].shape()[axis];
   while (len > 1) {
     const int64_t half = len / 2;
 
-    // lhs & rhs
-    for (size_t idx = 0; idx < outputs.size(); ++idx) {
-      slice_begin[axis] = 0;
-      slice_end[axis] = half;
-      auto len = outputs[idx].shape().size();
-
-      lhs[idx] = hal::slice(
-          ctx, outputs[idx],
-          Index(slice_begin.begin(), slice_begin.begin() + len),
-          Index(slice_end.begin(), slice_end.begin() + len),
-          Strides(slice_strides.begin(), slice_strides.begin() + len));
-
-      slice_begin[axis] = half;
-      slice_end[axis] = 2 * half;
-      rhs[idx] = hal::slice(
-          ctx, outputs[idx],
-          Index(slice_begin.begin(), slice_begin.begin() + len),
-          Index(slice_end.begin(), slice_end.begin() + len),
-          Strides(slice_strides.begin(), slice_strides.begin() + len));
+    for (int64_t idx = 0; idx < nargs; ++idx) {
+      lhs[idx] = slice_axis(outputs[idx], 0, half);
+      rhs[idx] = slice_axis(outputs[idx], half, 2 * half);
+      if (len % 2 == 1) {
+        tail[idx] = slice_axis(outputs[idx], 2 * half, len);
+      }
     }
 
-    // tail
+    outputs = reducer(lhs, rhs);
+
     if (len % 2 == 1) {
-      slice_begin[axis] = 2 * half;
-      slice_end[axis] = len;
-      std::vector<spu::Value> &tail = tails.emplace(nargs);
-      for (size_t idx = 0; idx < outputs.size(); ++idx) {
-        auto len = outputs[idx].shape().size();
-        tail[idx] = hal::slice(
-            ctx, outputs[idx],
-            Index(slice_begin.begin(), slice_begin.begin() + len),
-            Index(slice_end.begin(), slice_end.begin() + len),
-            Strides(slice_strides.begin(), slice_strides.begin() + len));
+      for (int64_t idx = 0; idx < nargs; ++idx) {
+        outputs[idx] = hal::concatenate(ctx, {outputs[idx], tail[idx]}, axis);
       }
     }
-
-    outputs = reducer(lhs, rhs);
-    len /= 2;
+    len = half + len % 2;
 
     SPU_ENFORCE(outputs[0].shape()[axis] == len);
   }
 
-  // TODO: this may cause at worst 2*lg(n) time of reducer call, compare the
-  // best case lg(n) times.
-  //
-  // consider len = 63, will iterate 5 (31, 15, 7, 3, 1), and generate
-  // len(tails) = 5, the total number is 5 + 5 = 10 times.
-  //
-  // Optimize ME.
-  while (!tails.empty()) {
-    outputs = reducer(outputs, tails.top());
-    tails.pop();
-  }
-
   return outputs;
 }
 
@@ -306,15 +279,12 @@ std::vector<spu::Value> Reduce(SPUContext *ctx,
   //   reduce      2 4 6 1
   //   result      2 1 4 1 6
   //
-  // Note(jint), theoretically, this method will reduce number of reducer calls,
-  // in this example, from
+  // Note(jint), this method reduces number of reducer calls, in this example,
+  // from
   //   ceil(lg(3)) + ceil(lg(5)) = 2 + 3 = 5
   // to
   //   ceil(lg(3 * 5)) = 4
   //
-  // But in current TreeReduce (unoptimized) implementation, this method is
-  // slower.
-  //
   // Note(jint): this `lowering` progress is easy to be ported to
   // compile-time.
 
@@ -373,6 +343,257 @@ std::vector<spu::Value> Reduce(SPUContext *ctx,
   return reducer(results, broadcasted_init_values);
 }
 
+namespace {
+
+// Arity of the comparison tree used by ArgReduce.
+//
+// A k-ary level compares all k(k-1)/2 pairs of a group at once, so a length n
+// axis takes log_k(n) comparison rounds instead of lg(n), at the price of k/2
+// times more comparisons. This pays off when comparison latency dominates, as
+// in honest-majority 3PC where bandwidth is cheap.
+int64_t comparisonArity(SPUContext *ctx) {
+  return ctx->config().protocol() == ProtocolKind::ABY3 ? 4 : 2;
+}
+
+// Sums x over axis `axis`, keeping it with size 1.
+spu::Value sumAxis(SPUContext *ctx, const spu::Value &x, int64_t axis) {
+  Index start(x.shape().size(), 0);
+  Index end(x.shape().begin(), x.shape().end());
+  end[axis] = 1;
+  auto sum = hal::slice(ctx, x, start, end, {});
+  for (int64_t idx = 1; idx < x.shape()[axis]; ++idx) {
+    start[axis] = idx;
+    end[axis] = idx + 1;
+    sum = hal::add(ctx, sum, hal::slice(ctx, x, start, end, {}));
+  }
+  return sum;
+}
+
+// One level of a k-ary comparison tree.
+//   values   : (B, g*k)
+//   payloads : (B, g*k, P)
+// Returns the winner of each group of k, (B, g) and (B, g, P).
+std::pair<spu::Value, std::vector<spu::Value>> argReduceGroups(
+    SPUContext *ctx, const spu::Value &values,
+    absl::Span<const spu::Value> payloads, int64_t k, bool is_max) {
+  const int64_t B = values.shape()[0];
+  const int64_t g = values.shape()[1] / k;
+  auto grouped = hal::reshape(ctx, values, {B, g, k});
+
+  // Compare all pairs (i, j), i < j, with a single call.
+  std::vector<std::pair<int64_t, int64_t>> pairs;
+  std::vector<spu::Value> lhs;
+  std::vector<spu::Value> rhs;
+  for (int64_t i = 0; i < k; ++i) {
+    for (int64_t j = i + 1; j < k; ++j) {
+      pairs.emplace_back(i, j);
+      lhs.emplace_back(hal::slice(ctx, grouped, {0, 0, i}, {B, g, i + 1}, {}));
+      rhs.emplace_back(hal::slice(ctx, grouped, {0, 0, j}, {B, g, j + 1}, {}));
+    }
+  }
+  auto x = hal::concatenate(ctx, lhs, 2);
+  auto y = hal::concatenate(ctx, rhs, 2);
+  // j beats i only when strictly better, so ties go to the lower position and
+  // exactly one position of each group wins.
+  auto j_wins = is_max ? hal::less(ctx, x, y) : hal::less(ctx, y, x);
+  auto i_wins = hal::logical_not(ctx, j_wins);
+
+  // wins[i] holds the k-1 outcomes of position i against the others.
+  std::vector<std::vector<spu::Value>> wins(k);
+  for (int64_t p = 0; p < static_cast<int64_t>(pairs.size()); ++p) {
+    const auto [i, j] = pairs[p];
+    wins[i].emplace_back(
+        hal::slice(ctx, i_wins, {0, 0, p}, {B, g, p + 1}, {}));
+    wins[j].emplace_back(
+        hal::slice(ctx, j_wins, {0, 0, p}, {B, g, p + 1}, {}));
+  }
+
+  // AND all outcomes of each position together, batched over positions.
+  std::vector<spu::Value> outcomes(k - 1);
+  for (int64_t t = 0; t < k - 1; ++t) {
+    std::vector<spu::Value> column(k);
+    for (int64_t i = 0; i < k; ++i) {
+      column[i] = wins[i][t];
+    }
+    outcomes[t] = hal::concatenate(ctx, column, 2);
+  }
+  while (outcomes.size() > 1) {
+    std::vector<spu::Value> next;
+    for (size_t t = 0; t + 1 < outcomes.size(); t += 2) {
+      next.emplace_back(hal::bitwise_and(ctx, outcomes[t], outcomes[t + 1]));
+    }
+    if (outcomes.size() % 2 == 1) {
+      next.emplace_back(outcomes.back());
+    }
+    outcomes = std::move(next);
+  }
+  // (B, g, k), one-hot over each group.
+  auto winner = hal::_prefer_a(ctx, outcomes[0]);
+
+  // The value and all payloads are selected by one batched multiplication.
+  // The winner is a 0/1 integer, so products keep the dtype of the selected.
+  std::vector<spu::Value> selectors = {winner};
+  std::vector<spu::Value> selected = {grouped};
+  if (!payloads.empty()) {
+    auto winner_4d = hal::reshape(ctx, winner, {B, g, k, 1});
+    for (const auto &payload : payloads) {
+      const int64_t P = payload.shape()[2];
+      selectors.emplace_back(
+          hal::broadcast_to(ctx, winner_4d, {B, g, k, P}));
+      selected.emplace_back(hal::reshape(ctx, payload, {B, g, k, P}));
+    }
+  }
+  auto products = hal::_mul(ctx, selectors, selected);
+
+  auto value = hal::reshape(
+      ctx, sumAxis(ctx, products[0].setDtype(values.dtype()), 2), {B, g});
+
+  std::vector<spu::Value> carried;
+  for (size_t idx = 0; idx < payloads.size(); ++idx) {
+    const int64_t P = payloads[idx].shape()[2];
+    carried.emplace_back(hal::reshape(
+        ctx, sumAxis(ctx, products[idx + 1].setDtype(payloads[idx].dtype()), 2),
+        {B, g, P}));
+  }
+  return {value, carried};
+}
+
+// Reduces values (B, n) to (B, 1) and carries payloads (B, n, P) along with
+// the winner, to (B, 1, P).
+std::pair<spu::Value, std::vector<spu::Value>> argReduceLastAxis(
+    SPUContext *ctx, spu::Value values, std::vector<spu::Value> payloads,
+    bool is_max, int64_t arity) {
+  const int64_t B = values.shape()[0];
+  int64_t n = values.shape()[1];
+  while (n > 1) {
+    const int64_t k = std::min(arity, n);
+    const int64_t head = n / k * k;
+
+    auto head_values = hal::slice(ctx, values, {0, 0}, {B, head}, {});
+    std::vector<spu::Value> head_payloads;
+    for (const auto &payload : payloads) {
+      const int64_t P = payload.shape()[2];
+      head_payloads.emplace_back(
+          hal::slice(ctx, payload, {0, 0, 0}, {B, head, P}, {}));
+    }
+
+    auto [next_values, next_payloads] =
+        argReduceGroups(ctx, head_values, head_payloads, k, is_max);
+
+    // Pass the tail through to the next level.
+    if (head < n) {
+      next_values = hal::concatenate(
+          ctx, {next_values, hal::slice(ctx, values, {0, head}, {B, n}, {})},
+          1);
+      for (size_t idx = 0; idx < payloads.size(); ++idx) {
+        const int64_t P = payloads[idx].shape()[2];
+        next_payloads[idx] = hal::concatenate(
+            ctx,
+            {next_payloads[idx],
+             hal::slice(ctx, payloads[idx], {0, head, 0}, {B, n, P}, {})},
+            1);
+      }
+    }
+
+    values = std::move(next_values);
+    payloads = std::move(next_payloads);
+    n = head / k + (n - head);
+  }
+  return {values, payloads};
+}
+
+}  // namespace
+
+std::pair<spu::Value, spu::Value> ArgReduce(SPUContext *ctx,
+                                            const spu::Value &input,
+                                            const Axes &dims_to_reduce,
+                                            bool is_max, bool with_index) {
+  const auto &in_shape = input.shape();
+
+  // Move reduced dims to the inner most and flatten them, see Reduce.
+  Axes perm(in_shape.size(), 0);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::stable_partition(perm.begin(), perm.end(), [&](int64_t axis) {
+    return std::find(dims_to_reduce.begin(), dims_to_reduce.end(), axis) ==
+           dims_to_reduce.end();
+  });
+
+  int64_t numel_to_reduce = 1;
+  Shape out_shape = in_shape;
+  for (const auto &axis : dims_to_reduce) {
+    numel_to_reduce *= in_shape[axis];
+    out_shape[axis] = 1;
+  }
+  const int64_t B = in_shape.numel() / numel_to_reduce;
+
+  auto flattened = hal::reshape(ctx, hal::transpose(ctx, input, perm),
+                                {B, numel_to_reduce});
+
+  std::vector<spu::Value> payloads;
+  if (with_index) {
+    auto iota = hal::iota(ctx, DT_I64, numel_to_reduce);
+    payloads.emplace_back(hal::broadcast_to(
+        ctx, hal::reshape(ctx, iota, {1, numel_to_reduce, 1}),
+        {B, numel_to_reduce, 1}));
+  }
+
+  auto [value, carried] = argReduceLastAxis(ctx, flattened, std::move(payloads),
+                                            is_max, comparisonArity(ctx));
+
+  spu::Value index;
+  if (with_index) {
+    index = hal::reshape(ctx, carried[0], out_shape);
+  }
+  return {hal::reshape(ctx, value, out_shape), index};
+}
+
+std::pair<spu::Value, spu::Value> ArgReduceWindow(
+    SPUContext *ctx, const spu::Value &input, const Shape &ret_shape,
+    const ReduceWindowConfig &config, bool is_max, bool with_index) {
+  SPU_ENFORCE(
+      std::all_of(config.window_padding.begin(), config.window_padding.end(),
+                  [](const std::pair<int64_t, int64_t> &p) {
+                    return p.first == 0 && p.second == 0;
+                  }) &&
+          std::all_of(config.window_dilations.begin(),
+                      config.window_dilations.end(),
+                      [](int64_t d) { return d == 1; }),
+      "expect padding and dilations to be removed");
+
+  const int64_t window_size = config.window_shape.numel();
+  const int64_t B = ret_shape.numel();
+
+  // (N0, ..., Nn, W0, ..., Wn) -> (B, window_size)
+  auto expanded = hal::reshape(
+      ctx,
+      expandWindow(ctx, input, config.window_shape, config.window_strides,
+                   config.window_padding, spu::Value()),
+      {B, window_size});
+
+  std::vector<spu::Value> payloads;
+  if (with_index) {
+    // One-hot position inside the window.
+    xt::xarray<bool> e = xt::eye<bool>(
+        {static_cast<size_t>(window_size), static_cast<size_t>(window_size)},
+        0);
+    auto eye = hal::reshape(ctx, hal::constant(ctx, e, DT_I1),
+                            {1, window_size, window_size});
+    payloads.emplace_back(
+        hal::broadcast_to(ctx, eye, {B, window_size, window_size}));
+  }
+
+  auto [value, carried] = argReduceLastAxis(ctx, expanded, std::move(payloads),
+                                            is_max, comparisonArity(ctx));
+
+  spu::Value index;
+  if (with_index) {
+    Shape mask_shape = ret_shape;
+    mask_shape.emplace_back(window_size);
+    index = hal::reshape(ctx, carried[0], mask_shape);
+  }
+  return {hal::reshape(ctx, value, ret_shape), index};
+}
+
 // So idea here..
 // When windows size is 2x2, tile and run parallel on window element level has
 // way to much overhead (both memory and computation).
@@ -488,12 +709,20 @@ std::pair<spu::Value, spu::Value> ArgMax(SPUContext *ctx,
                   [](const std::pair<int64_t, int64_t> &p) {
                     return p.first == 0 && p.second == 0;
                   });
+  auto no_dilation = std::all_of(config.window_dilations.begin(),
+                                 config.window_dilations.end(),
+                                 [](int64_t d) { return d == 1; });
   if (config.window_shape == absl::Span<const int64_t>{1, 2, 2, 1} &&
-      no_padding) {
+      no_padding && comparisonArity(ctx) == 2) {
     return ArgMax1x2x2x1NoPaddingWithoutDilation(ctx, input,
                                                  config.window_strides);
   }
 
+  if (no_padding && no_dilation) {
+    return ArgReduceWindow(ctx, input, ret_shape, config, /*is_max*/ true,
+                           /*with_index*/ true);
+  }
+
   // Create eye
   size_t window_size =
       std::accumulate(config.window_shape.begin(), config.window_shape.end(), 1,
@@ -59,6 +59,20 @@ std::pair<spu::Value, spu::Value> ArgMax(SPUContext *ctx,
                                          const ReduceWindowConfig &config);
 
 /// ------------------- non-PPHLO APIs ------------------------------------
+// Max (is_max) or min of input over dims_to_reduce, reduced dims keep size 1.
+// When with_index is set, also returns the row-major position of the winner
+// inside the reduced dims, as DT_I64. Ties go to the lowest position.
+std::pair<spu::Value, spu::Value> ArgReduce(SPUContext *ctx,
+                                            const spu::Value &input,
+                                            const Axes &dims_to_reduce,
+                                            bool is_max, bool with_index);
+
+// Window version of ArgReduce, without padding or dilation. The index is a
+// one-hot mask of shape ret_shape + [window_size].
+std::pair<spu::Value, spu::Value> ArgReduceWindow(
+    SPUContext *ctx, const spu::Value &input, const Shape &ret_shape,
+    const ReduceWindowConfig &config, bool is_max, bool with_index);
+
 std::vector<spu::Value> TreeReduce(SPUContext *ctx,
                                    absl::Span<const spu::Value> inputs,
                                    int64_t axis,
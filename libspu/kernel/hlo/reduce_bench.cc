@@ -0,0 +1,182 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+
+#include "libspu/kernel/bench_util.h"
+#include "libspu/kernel/hal/public_helper.h"
+#include "libspu/kernel/hlo/basic_binary.h"
+#include "libspu/kernel/hlo/basic_unary.h"
+#include "libspu/kernel/hlo/casting.h"
+#include "libspu/kernel/hlo/geometrical.h"
+#include "libspu/kernel/hlo/reduce.h"
+#include "libspu/kernel/hlo/softmax.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::kernel::hlo {
+
+namespace {
+
+std::vector<spu::Value> maxReducer(SPUContext *ctx,
+                                   absl::Span<const spu::Value> lhs,
+                                   absl::Span<const spu::Value> rhs) {
+  return {Max(ctx, lhs[0], rhs[0])};
+}
+
+}  // namespace
+
+// Row max of softmax inputs, (rows, cols) reduced over cols.
+static void BM_SoftmaxMax(benchmark::State &state) {
+  const auto rows = state.range(0);
+  const auto cols = state.range(1);
+  const auto prot = static_cast<ProtocolKind>(state.range(2));
+  const bool engine = state.range(3) != 0;
+
+  xt::xarray<float> x = test::xt_random<float>(
+      {static_cast<size_t>(rows), static_cast<size_t>(cols)});
+
+  bench::runKernelBench(state, prot, [&](SPUContext *ctx) {
+    auto in = test::makeValue(ctx, x, VIS_SECRET);
+    if (engine) {
+      benchmark::DoNotOptimize(ArgReduce(ctx, in, {1}, true, false));
+    } else {
+      benchmark::DoNotOptimize(
+          Reduce(ctx, {in}, {spu::Value()}, {1},
+                 [&](absl::Span<const spu::Value> lhs,
+                     absl::Span<const spu::Value> rhs) {
+                   return maxReducer(ctx, lhs, rhs);
+                 },
+                 true));
+    }
+  });
+}
+
+// Max pooling of a (1, hw, hw, 16) image with a (1, k, k, 1) window and
+// stride k.
+static void BM_MaxPool(benchmark::State &state) {
+  const auto hw = state.range(0);
+  const auto k = state.range(1);
+  const auto prot = static_cast<ProtocolKind>(state.range(2));
+  const bool engine = state.range(3) != 0;
+
+  xt::xarray<float> x =
+      test::xt_random<float>({1, static_cast<size_t>(hw),
+                              static_cast<size_t>(hw), 16});
+
+  std::vector<std::pair<int64_t, int64_t>> padding(4, {0, 0});
+  ReduceWindowConfig config;
+  config.window_shape = {1, k, k, 1};
+  config.window_strides = {1, k, k, 1};
+  config.window_dilations = {1, 1, 1, 1};
+  config.window_padding = padding;
+  config.base_dilations = {1, 1, 1, 1};
+  const Shape ret_shape = {1, (hw - k) / k + 1, (hw - k) / k + 1, 16};
+
+  bench::runKernelBench(state, prot, [&](SPUContext *ctx) {
+    auto in = test::makeValue(ctx, x, VIS_SECRET);
+    if (engine) {
+      benchmark::DoNotOptimize(
+          ArgReduceWindow(ctx, in, ret_shape, config, true, false));
+    } else {
+      benchmark::DoNotOptimize(ReduceWindow(
+          ctx, {in}, {spu::Value()}, ret_shape, config,
+          [&](absl::Span<const spu::Value> lhs,
+              absl::Span<const spu::Value> rhs) {
+            return maxReducer(ctx, lhs, rhs);
+          },
+          true));
+    }
+  });
+}
+
+// Softmax of (rows, cols) over cols, fused kernel vs. the lowering of the jax
+// idiom. max_abs_err is measured against a float reference.
+static void BM_Softmax(benchmark::State &state) {
+  const auto rows = state.range(0);
+  const auto cols = state.range(1);
+  const auto prot = static_cast<ProtocolKind>(state.range(2));
+  const bool fused = state.range(3) != 0;
+
+  xt::xarray<float> x = test::xt_random<float>(
+      {static_cast<size_t>(rows), static_cast<size_t>(cols)}, -10, 10);
+  xt::xarray<float> e = xt::exp(x - xt::amax(x, {1}, xt::keep_dims));
+  xt::xarray<float> expected = e / xt::sum(e, {1}, xt::keep_dims);
+
+  std::atomic<float> max_abs_err = 0;
+  bench::runKernelBench(state, prot, [&](SPUContext *ctx) {
+    auto in = test::makeValue(ctx, x, VIS_SECRET);
+    spu::Value ret;
+    if (fused) {
+      ret = Softmax(ctx, in, 1);
+    } else {
+      auto row_max = ArgReduce(ctx, in, {1}, true, false).first;
+      auto unnormalized =
+          Exp(ctx, Sub(ctx, in, Broadcast(ctx, row_max, in.shape(), {0, 1})));
+      auto row_sum = Reduce(
+          ctx, {unnormalized}, {spu::Value()}, {1},
+          [&](absl::Span<const spu::Value> lhs,
+              absl::Span<const spu::Value> rhs) {
+            return std::vector<spu::Value>{Add(ctx, lhs[0], rhs[0])};
+          },
+          true)[0];
+      ret = Div(ctx, unnormalized,
+                Broadcast(ctx, row_sum, in.shape(), {0, 1}));
+    }
+    // The reveal adds the same cost to both variants.
+    auto p_ret = hal::dump_public_as<float>(ctx, Reveal(ctx, ret));
+    max_abs_err = xt::amax(xt::abs(p_ret - expected))();
+  });
+  state.counters["max_abs_err"] = max_abs_err;
+}
+
+BENCHMARK(BM_SoftmaxMax)
+    ->ArgNames({"rows", "cols", "prot", "engine"})
+    ->ArgsProduct({
+        {16, 128},                                   // rows
+        {63, 128, 1000},                             // cols
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3},  // protocol
+        {0, 1},                                      // engine
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+BENCHMARK(BM_Softmax)
+    ->ArgNames({"rows", "cols", "prot", "fused"})
+    ->ArgsProduct({
+        {16, 128},                                   // rows
+        {128, 1000},                                 // cols
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3},  // protocol
+        {0, 1},                                      // fused
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+BENCHMARK(BM_MaxPool)
+    ->ArgNames({"hw", "k", "prot", "engine"})
+    ->ArgsProduct({
+        {32},                                        // hw
+        {2, 3},                                      // window
+        {ProtocolKind::SEMI2K, ProtocolKind::ABY3},  // protocol
+        {0, 1},                                      // engine
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+}  // namespace spu::kernel::hlo
+
+BENCHMARK_MAIN();
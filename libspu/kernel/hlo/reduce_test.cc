@@ -0,0 +1,185 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/kernel/hlo/reduce.h"
+
+#include "gtest/gtest.h"
+#include "xtensor/xsort.hpp"
+
+#include "libspu/core/context.h"
+#include "libspu/core/value.h"
+#include "libspu/kernel/hal/polymorphic.h"
+#include "libspu/kernel/hlo/casting.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/common/communicator.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::kernel::hlo {
+
+class ReduceTest : public ::testing::TestWithParam<ProtocolKind> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Reduce, ReduceTest,
+    testing::Values(ProtocolKind::SEMI2K, ProtocolKind::ABY3),
+    [](const testing::TestParamInfo<ReduceTest::ParamType> &p) {
+      return fmt::format("{}", p.param);
+    });
+
+TEST_P(ReduceTest, TreeReduceCalls) {
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(GetParam(), FM64, lctx);
+        xt::xarray<int64_t> x = xt::arange<int64_t>(63);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        int64_t calls = 0;
+        auto ret = TreeReduce(
+            &sctx, {in}, 0,
+            [&](absl::Span<const spu::Value> lhs,
+                absl::Span<const spu::Value> rhs) {
+              ++calls;
+              return std::vector<spu::Value>{
+                  hal::add(&sctx, lhs[0], rhs[0])};
+            });
+
+        // ceil(lg(63))
+        EXPECT_EQ(calls, 6);
+        auto p_ret =
+            hal::dump_public_as<int64_t>(&sctx, Reveal(&sctx, ret[0]));
+        EXPECT_EQ(p_ret(0), 63 * 62 / 2);
+      });
+}
+
+TEST_P(ReduceTest, ArgReduceAxis) {
+  xt::xarray<float> x = test::xt_random<float>({3, 7, 5}, -10, 10);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(GetParam(), FM64, lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        for (bool is_max : {true, false}) {
+          auto [v, i] = ArgReduce(&sctx, in, {1}, is_max, true);
+          EXPECT_EQ(v.shape(), Shape({3, 1, 5}));
+          EXPECT_EQ(i.shape(), Shape({3, 1, 5}));
+
+          auto p_v = hal::dump_public_as<float>(&sctx, Reveal(&sctx, v));
+          auto p_i = hal::dump_public_as<int64_t>(&sctx, Reveal(&sctx, i));
+          xt::xarray<float> expected_v =
+              is_max ? xt::amax(x, {1}, xt::keep_dims)
+                     : xt::amin(x, {1}, xt::keep_dims);
+          EXPECT_TRUE(xt::allclose(p_v, expected_v, 0.01, 0.001))
+              << p_v << std::endl
+              << expected_v << std::endl;
+          for (size_t a = 0; a < 3; ++a) {
+            for (size_t c = 0; c < 5; ++c) {
+              EXPECT_NEAR(x(a, p_i(a, 0, c), c), expected_v(a, 0, c), 0.01);
+            }
+          }
+        }
+      });
+}
+
+TEST_P(ReduceTest, ArgReduceIndexRounds) {
+  xt::xarray<float> x = test::xt_random<float>({3, 17}, -10, 10);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(GetParam(), FM64, lctx);
+        auto *comm = sctx.getState<mpc::Communicator>();
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        auto prev = comm->getStats();
+        ArgReduce(&sctx, in, {1}, true, false);
+        const auto without_index = (comm->getStats() - prev).latency;
+
+        prev = comm->getStats();
+        auto [v, i] = ArgReduce(&sctx, in, {1}, true, true);
+        const auto with_index = (comm->getStats() - prev).latency;
+
+        // Carried indices share the selection round of the values.
+        EXPECT_EQ(with_index, without_index);
+
+        auto p_i = hal::dump_public_as<int64_t>(&sctx, Reveal(&sctx, i));
+        xt::xarray<int64_t> expected = xt::argmax(x, 1);
+        for (size_t a = 0; a < 3; ++a) {
+          EXPECT_EQ(p_i(a, 0), expected(a));
+        }
+      });
+}
+
+TEST_P(ReduceTest, ArgReduceMultiAxis) {
+  xt::xarray<float> x = test::xt_random<float>({4, 3, 5}, -10, 10);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(GetParam(), FM64, lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        auto [v, i] = ArgReduce(&sctx, in, {0, 2}, true, false);
+        EXPECT_EQ(v.shape(), Shape({1, 3, 1}));
+        EXPECT_EQ(i.numel(), 0);
+
+        auto p_v = hal::dump_public_as<float>(&sctx, Reveal(&sctx, v));
+        xt::xarray<float> expected = xt::amax(x, {0, 2}, xt::keep_dims);
+        EXPECT_TRUE(xt::allclose(p_v, expected, 0.01, 0.001))
+            << p_v << std::endl
+            << expected << std::endl;
+      });
+}
+
+TEST_P(ReduceTest, ArgReduceWindow) {
+  // 1x5x5x2 input, 3x3 window, stride 2
+  xt::xarray<float> x = test::xt_random<float>({1, 5, 5, 2}, -10, 10);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(GetParam(), FM64, lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        std::vector<std::pair<int64_t, int64_t>> padding(4, {0, 0});
+        ReduceWindowConfig config;
+        config.window_shape = {1, 3, 3, 1};
+        config.window_strides = {1, 2, 2, 1};
+        config.window_dilations = {1, 1, 1, 1};
+        config.window_padding = padding;
+        config.base_dilations = {1, 1, 1, 1};
+
+        auto [v, mask] = ArgMax(&sctx, in, {1, 2, 2, 2}, config);
+        EXPECT_EQ(mask.shape(), Shape({1, 2, 2, 2, 9}));
+
+        auto p_v = hal::dump_public_as<float>(&sctx, Reveal(&sctx, v));
+        auto p_m = hal::dump_public_as<int64_t>(&sctx, Reveal(&sctx, mask));
+        for (size_t h = 0; h < 2; ++h) {
+          for (size_t w = 0; w < 2; ++w) {
+            for (size_t c = 0; c < 2; ++c) {
+              float expected = x(0, 2 * h, 2 * w, c);
+              int64_t ones = 0;
+              for (size_t k = 0; k < 9; ++k) {
+                float e = x(0, 2 * h + k / 3, 2 * w + k % 3, c);
+                expected = std::max(expected, e);
+                if (p_m(0, h, w, c, k) == 1) {
+                  ++ones;
+                  EXPECT_NEAR(e, p_v(0, h, w, c), 0.01);
+                }
+              }
+              EXPECT_EQ(ones, 1);
+              EXPECT_NEAR(p_v(0, h, w, c), expected, 0.01);
+            }
+          }
+        }
+      });
+}
+
+}  // namespace spu::kernel::hlo
@@ -17,8 +17,8 @@
 
 #include "libspu/kernel/hal/constants.h"
 #include "libspu/kernel/hal/polymorphic.h"
+#include "libspu/kernel/hal/ring.h"
 #include "libspu/kernel/hal/shape_ops.h"
-#include "libspu/kernel/hlo/const.h"  // iota
 #include "libspu/kernel/hlo/reduce.h"
 #include "libspu/kernel/hlo/utils.h"
 
@@ -153,9 +153,8 @@ spu::Value SelectAndScatter(
   //
   // The algorithm:
   // tiled = win_count x window          : (N,W)
-  // index = iota(0, num_window)         : (_,W)
-  // sel_pos = reduce(tiled, index)      : (N,)   # find selected position of each window
-  // onehot = sel_pos == index           : (N,_)->(_,W)->(N,W)  # each window ia one-hot position
+  // onehot = eye(W)                     : (_,W,W)->(N,W,W)
+  // onehot = reduce(tiled, onehot)      : (N,W)   # one-hot selected position of each window
   // sel_val = sel(onehot, source, init) : (N,W)->(N,)->()->(N,W)
   // sel_val = reduce(sel_val, 1)        : (N,W)->(N)
   //
@@ -173,45 +172,42 @@ spu::Value SelectAndScatter(
   const Shape NW2d = {N.numel(), W.numel()};
   auto tiled2d = hal::reshape(ctx, tiled, NW2d);
 
-  // indices is the iota for each window.
-  // win0: [0, 1, 2, 3, 4, 5]
-  // win1: [0, 1, 2, 3, 4, 5]
+  // The one-hot position of each window element, carried along with the
+  // value through the comparison tree so the winner comes out as a one-hot
+  // mask, without an extra equality test against its index.
+  // win0: [[1, 0, 0, ...], [0, 1, 0, ...], ...]
+  // win1: [[1, 0, 0, ...], [0, 1, 0, ...], ...]
   // ...
-  auto indices = hal::broadcast_to(ctx, Iota(ctx, DT_I64, W.numel()), NW2d);
-  SPU_ENFORCE_EQ(indices.shape(), NW2d);
-
-  // Apply the reduce with indices.
+  xt::xarray<bool> e = xt::eye<bool>(
+      {static_cast<size_t>(W.numel()), static_cast<size_t>(W.numel())}, 0);
+  auto eye = hal::reshape(ctx, hal::constant(ctx, e, DT_I1),
+                          {1, W.numel(), W.numel()});
+  auto positions =
+      hal::broadcast_to(ctx, eye, {N.numel(), W.numel(), W.numel()});
+
+  // Apply the reduce with positions, all windows and all pairs of a tree level
+  // are compared by one select_fn call.
   auto reduced = TreeReduce(
-      ctx, {tiled2d, indices}, 1,
+      ctx, {tiled2d, positions}, 1,
       [&](absl::Span<const spu::Value> lhs, absl::Span<const spu::Value> rhs) {
         SPU_ENFORCE(lhs.size() == 2 && rhs.size() == 2);
-        auto pred = select_fn(lhs[0], rhs[0]);
-        std::vector<spu::Value> rets;
-        for (size_t idx = 0; idx < lhs.size(); idx++) {
-          // TODO: if reduce window does not require lhs[0].shape ==
-          // lhs[1].shape, then we could avoid the later comparison.
-          rets.push_back(hal::select(ctx, pred, lhs[idx], rhs[idx]));
-        }
-        return rets;
+        auto pred = hal::_prefer_a(ctx, select_fn(lhs[0], rhs[0]));
+        auto pred_shape = pred.shape();
+        pred_shape.emplace_back(1);
+        auto pred_w = hal::reshape(ctx, pred, pred_shape);
+        pred_shape.back() = W.numel();
+        pred_w = hal::broadcast_to(ctx, pred_w, pred_shape);
+        return std::vector<spu::Value>{
+            hal::select(ctx, pred, lhs[0], rhs[0]),
+            hal::select(ctx, pred_w, lhs[1], rhs[1])};
       });
 
-  // indices is the iota for each window.
-  // win0: [3]              // position 3 is selected.
-  // win1: [1]              // position 1 is selected.
-  // ...
-  auto sel_pos = reduced[1];
-  SPU_ENFORCE_EQ(sel_pos.shape(), Shape({N.numel(), 1}));
-
-  // win0: [3, 3, 3, 3, 3, 3]
-  // win1: [1, 1, 1, 1, 1, 1]
-  sel_pos = hal::broadcast_to(ctx, sel_pos, NW2d, {0});
-
   // one hot encoding for each window
   // win0: [0, 0, 0, 1, 0, 0]  // position 3 is selected.
   // win1: [0, 1, 0, 0, 0, 0]  // position 1 is selected.
   // ...
-  auto onehot = hal::equal(ctx, sel_pos, indices);
-  SPU_ENFORCE_EQ(onehot.shape(), NW2d);
+  auto onehot = reduced[1];
+  SPU_ENFORCE_EQ(onehot.shape(), Shape({N.numel(), 1, W.numel()}));
 
   Shape N_W1d = N;
   N_W1d.push_back(W.numel());
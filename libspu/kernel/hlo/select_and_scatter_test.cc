@@ -108,6 +108,20 @@ INSTANTIATE_TEST_SUITE_P(
             {{0, 0}, {0, 0}},
             {2, 2},
             {1, 1},
-            {{0.0, 0.0, 0.0}, {1.0, 0.0, 2.0}, {3.0, 0.0, 4.0}}}));
+            {{0.0, 0.0, 0.0}, {1.0, 0.0, 2.0}, {3.0, 0.0, 4.0}}},
+        SelectAndScatterTestParam{{{1, 2, 3, 4, 5},
+                                   {6, 25, 8, 9, 10},
+                                   {11, 12, 13, 14, 24},
+                                   {16, 17, 18, 19, 20},
+                                   {21, 22, 23, 15, 0}},
+                                  {{1, 2}, {3, 4}},
+                                  {{0, 0}, {0, 0}},
+                                  {3, 3},
+                                  {2, 2},
+                                  {{0, 0, 0, 0, 0},
+                                   {0, 1, 0, 0, 0},
+                                   {0, 0, 0, 0, 6},
+                                   {0, 0, 0, 0, 0},
+                                   {0, 0, 3, 0, 0}}}));
 
 }  // namespace spu::kernel::hlo
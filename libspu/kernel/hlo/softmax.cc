@@ -0,0 +1,64 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/kernel/hlo/softmax.h"
+
+#include "libspu/core/context.h"
+#include "libspu/kernel/hal/constants.h"
+#include "libspu/kernel/hal/fxp_approx.h"
+#include "libspu/kernel/hal/fxp_base.h"
+#include "libspu/kernel/hal/shape_ops.h"
+#include "libspu/kernel/hlo/reduce.h"
+
+namespace spu::kernel::hlo {
+
+spu::Value Softmax(SPUContext *ctx, const spu::Value &x, int64_t axis) {
+  SPU_ENFORCE(x.isFxp(), "softmax expects a fixed point input, got {}",
+              x.dtype());
+  SPU_ENFORCE(axis >= 0 && axis < static_cast<int64_t>(x.shape().size()),
+              "invalid softmax axis {} for shape {}", axis, x.shape());
+
+  if (x.numel() == 0) {
+    return x;
+  }
+
+  // Shifted inputs are <= 0, so exp(shifted) is in (0, 1] and the row sum is
+  // in [1, n].
+  auto row_max = ArgReduce(ctx, x, {axis}, /*is_max*/ true,
+                           /*with_index*/ false)
+                     .first;
+  auto shifted =
+      hal::f_sub(ctx, x, hal::broadcast_to(ctx, row_max, x.shape()));
+  auto e = hal::f_exp_nonpositive(ctx, shifted);
+
+  auto row_sum =
+      Reduce(
+          ctx, {e}, {spu::Value()}, {axis},
+          [&](absl::Span<const spu::Value> lhs,
+              absl::Span<const spu::Value> rhs) {
+            return std::vector<spu::Value>{hal::f_add(ctx, lhs[0], rhs[0])};
+          },
+          /*ignore_init_values*/ true)[0];
+
+  // One reciprocal per row instead of one per element of the broadcast
+  // denominator, the sum is positive so the sign handling is skipped.
+  auto reci = row_sum.isPublic()
+                  ? hal::f_reciprocal(ctx, row_sum)
+                  : hal::detail::reciprocal_goldschmidt_positive(ctx, row_sum);
+
+  return hal::f_mul(ctx, e, hal::broadcast_to(ctx, reci, x.shape()),
+                    SignType::Positive);
+}
+
+}  // namespace spu::kernel::hlo
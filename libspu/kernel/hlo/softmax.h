@@ -0,0 +1,34 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "libspu/core/value.h"
+
+namespace spu {
+class SPUContext;
+}
+
+namespace spu::kernel::hlo {
+
+// Fused exp(x - max(x)) / sum(exp(x - max(x))) along axis.
+//
+// The row max comes from the round-optimal ArgReduce, exp only clamps the
+// lower end of the shifted (non-positive) inputs, and the row sum (>= 1) gets
+// one sign-free reciprocal per row that is applied with a single truncation.
+spu::Value Softmax(SPUContext *ctx, const spu::Value &x, int64_t axis);
+
+}  // namespace spu::kernel::hlo
@@ -0,0 +1,145 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/kernel/hlo/softmax.h"
+
+#include <numeric>
+
+#include "gtest/gtest.h"
+#include "xtensor/xmath.hpp"
+
+#include "libspu/core/context.h"
+#include "libspu/core/value.h"
+#include "libspu/kernel/hal/public_helper.h"
+#include "libspu/kernel/hlo/basic_binary.h"
+#include "libspu/kernel/hlo/basic_unary.h"
+#include "libspu/kernel/hlo/casting.h"
+#include "libspu/kernel/hlo/geometrical.h"
+#include "libspu/kernel/hlo/reduce.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::kernel::hlo {
+
+namespace {
+
+xt::xarray<float> expectedSoftmax(const xt::xarray<float> &x, size_t axis) {
+  xt::xarray<float> e = xt::exp(x - xt::amax(x, {axis}, xt::keep_dims));
+  return e / xt::sum(e, {axis}, xt::keep_dims);
+}
+
+// The lowering of the jax softmax idiom without the fused kernel.
+spu::Value unfusedSoftmax(SPUContext *ctx, const spu::Value &x,
+                          int64_t axis) {
+  Axes dims(x.shape().size());
+  std::iota(dims.begin(), dims.end(), 0);
+
+  auto row_max = ArgReduce(ctx, x, {axis}, true, false).first;
+  auto e = Exp(ctx, Sub(ctx, x, Broadcast(ctx, row_max, x.shape(), dims)));
+  auto row_sum = Reduce(
+      ctx, {e}, {spu::Value()}, {axis},
+      [&](absl::Span<const spu::Value> lhs, absl::Span<const spu::Value> rhs) {
+        return std::vector<spu::Value>{Add(ctx, lhs[0], rhs[0])};
+      },
+      true)[0];
+  return Div(ctx, e, Broadcast(ctx, row_sum, x.shape(), dims));
+}
+
+}  // namespace
+
+class SoftmaxTest
+    : public ::testing::TestWithParam<std::tuple<ProtocolKind, FieldType>> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Softmax, SoftmaxTest,
+    testing::Combine(testing::Values(ProtocolKind::SEMI2K,
+                                     ProtocolKind::ABY3),
+                     testing::Values(FieldType::FM64, FieldType::FM128)),
+    [](const testing::TestParamInfo<SoftmaxTest::ParamType> &p) {
+      return fmt::format("{}x{}", std::get<0>(p.param), std::get<1>(p.param));
+    });
+
+TEST_P(SoftmaxTest, Accuracy) {
+  xt::xarray<float> x = test::xt_random<float>({4, 6}, -5, 5);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(std::get<0>(GetParam()),
+                                               std::get<1>(GetParam()), lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        for (int64_t axis : {0, 1}) {
+          auto ret = Softmax(&sctx, in, axis);
+          EXPECT_EQ(ret.shape(), in.shape());
+          EXPECT_EQ(ret.dtype(), in.dtype());
+
+          auto p_ret = hal::dump_public_as<float>(&sctx, Reveal(&sctx, ret));
+          auto expected = expectedSoftmax(x, axis);
+          EXPECT_TRUE(xt::allclose(p_ret, expected, 0.01, 0.001))
+              << p_ret << std::endl
+              << expected << std::endl;
+        }
+      });
+}
+
+TEST_P(SoftmaxTest, MaskedEntries) {
+  // Attention masks push entries far below the exp approximation range.
+  xt::xarray<float> x = {{1.0, -1000.0, 2.0, 0.5},
+                         {-1000.0, 3.0, -1000.0, 3.0}};
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(std::get<0>(GetParam()),
+                                               std::get<1>(GetParam()), lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+
+        auto ret = Softmax(&sctx, in, 1);
+        auto p_ret = hal::dump_public_as<float>(&sctx, Reveal(&sctx, ret));
+        auto expected = expectedSoftmax(x, 1);
+        EXPECT_TRUE(xt::allclose(p_ret, expected, 0.01, 0.001))
+            << p_ret << std::endl
+            << expected << std::endl;
+      });
+}
+
+TEST_P(SoftmaxTest, CheaperThanUnfused) {
+  xt::xarray<float> x = test::xt_random<float>({8, 64}, -5, 5);
+
+  mpc::utils::simulate(
+      3, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext sctx = test::makeSPUContext(std::get<0>(GetParam()),
+                                               std::get<1>(GetParam()), lctx);
+        auto in = test::makeValue(&sctx, x, VIS_SECRET);
+        auto expected = expectedSoftmax(x, 1);
+
+        auto bytes_before = lctx->GetStats()->sent_bytes.load();
+        auto unfused = unfusedSoftmax(&sctx, in, 1);
+        auto unfused_bytes = lctx->GetStats()->sent_bytes - bytes_before;
+
+        bytes_before = lctx->GetStats()->sent_bytes.load();
+        auto fused = Softmax(&sctx, in, 1);
+        auto fused_bytes = lctx->GetStats()->sent_bytes - bytes_before;
+
+        EXPECT_LT(fused_bytes, unfused_bytes);
+
+        // Not less accurate than the unfused lowering.
+        auto p_unfused =
+            hal::dump_public_as<float>(&sctx, Reveal(&sctx, unfused));
+        auto p_fused = hal::dump_public_as<float>(&sctx, Reveal(&sctx, fused));
+        EXPECT_LE(xt::amax(xt::abs(p_fused - expected))(),
+                  xt::amax(xt::abs(p_unfused - expected))() + 1e-3);
+      });
+}
+
+}  // namespace spu::kernel::hlo
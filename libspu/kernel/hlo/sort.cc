@@ -24,10 +24,10 @@ std::vector<spu::Value> Sort(SPUContext *ctx,
                              const hal::CompFn &comparator_body,
                              Visibility comparator_ret_vis) {
   auto sort_fn = [&](absl::Span<const spu::Value> input) {
-    return hal::sort1d(ctx, input, comparator_body, comparator_ret_vis,
+    return hal::sort2d(ctx, input, comparator_body, comparator_ret_vis,
                        is_stable);
   };
-  return hal::permute(ctx, inputs, sort_dim, sort_fn);
+  return hal::batch_permute(ctx, inputs, sort_dim, sort_fn);
 }
 
 std::vector<spu::Value> SimpleSort(SPUContext *ctx,
@@ -36,9 +36,9 @@ std::vector<spu::Value> SimpleSort(SPUContext *ctx,
                                    hal::SortDirection direction,
                                    int64_t num_keys, int64_t valid_bits) {
   auto sort_fn = [&](absl::Span<const spu::Value> input) {
-    return hal::simple_sort1d(ctx, input, direction, num_keys, valid_bits);
+    return hal::simple_sort2d(ctx, input, direction, num_keys, valid_bits);
   };
-  return hal::permute(ctx, inputs, sort_dim, sort_fn);
+  return hal::batch_permute(ctx, inputs, sort_dim, sort_fn);
 }
 
 }  // namespace spu::kernel::hlo
@@ -18,6 +18,7 @@
 #include <random>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xsort.hpp>
+#include <xtensor/xview.hpp>
 
 #include "gtest/gtest.h"
 #include "xtensor/xio.hpp"
@@ -235,6 +236,46 @@ TEST(SortTest, LargeNumel) {
   }
 }
 
+TEST(SortTest, MultiRowsSameRounds) {
+  mpc::utils::simulate(
+      2, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        SPUContext ctx =
+            test::makeSPUContext(ProtocolKind::SEMI2K, FieldType::FM64, lctx);
+        auto cmp = [&](absl::Span<const spu::Value> inputs) {
+          return hal::less(&ctx, inputs[0], inputs[1]);
+        };
+
+        xt::xarray<float> x = xt::zeros<float>({16, 32});
+        for (size_t i = 0; i < x.shape(0); ++i) {
+          for (size_t j = 0; j < x.shape(1); ++j) {
+            x(i, j) = static_cast<float>((i * 7 + j * 13) % 37);
+          }
+        }
+        xt::xarray<float> row = xt::view(x, xt::range(0, 1), xt::all());
+
+        Value x_v = test::makeValue(&ctx, x, VIS_SECRET);
+        Value row_v = test::makeValue(&ctx, row, VIS_SECRET);
+
+        auto before = lctx->GetStats()->sent_actions.load();
+        Sort(&ctx, {row_v}, 1, false, cmp, Visibility::VIS_SECRET);
+        auto single = lctx->GetStats()->sent_actions - before;
+
+        before = lctx->GetStats()->sent_actions.load();
+        auto rets = Sort(&ctx, {x_v}, 1, false, cmp, Visibility::VIS_SECRET);
+        auto batched = lctx->GetStats()->sent_actions - before;
+
+        // all rows share the rounds of a single row.
+        EXPECT_EQ(single, batched);
+
+        xt::xarray<float> sorted_x = xt::sort(x, 1);
+        auto sorted_x_hat =
+            hal::dump_public_as<float>(&ctx, hal::reveal(&ctx, rets[0]));
+        EXPECT_TRUE(xt::allclose(sorted_x, sorted_x_hat, 0.01, 0.001))
+            << sorted_x << std::endl
+            << sorted_x_hat << std::endl;
+      });
+}
+
 class SimpleSortTest
     : public ::testing::TestWithParam<std::tuple<
           size_t, FieldType, ProtocolKind, RuntimeConfig::SortMethod>> {};
@@ -327,6 +368,88 @@ TEST_P(SimpleSortTest, SingleKeyWithPayload) {
       });
 }
 
+TEST_P(SimpleSortTest, ValidBits) {
+  size_t npc = std::get<0>(GetParam());
+  FieldType field = std::get<1>(GetParam());
+  ProtocolKind prot = std::get<2>(GetParam());
+  RuntimeConfig::SortMethod method = std::get<3>(GetParam());
+
+  mpc::utils::simulate(
+      npc, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        RuntimeConfig cfg;
+        cfg.set_protocol(prot);
+        cfg.set_field(field);
+        cfg.set_enable_action_trace(false);
+        cfg.set_sort_method(method);
+        SPUContext ctx = test::makeSPUContext(cfg, lctx);
+
+        // 5 bits with sign, not a multiple of any radix digit width but 1.
+        xt::xarray<int32_t> k = {7, -6, 15, -16, 0, 3, -1, 12, -9, 2, 1};
+        xt::xarray<int32_t> sorted_k = xt::sort(k);
+
+        Value k_v = test::makeValue(&ctx, k, VIS_SECRET);
+
+        std::vector<spu::Value> rets =
+            SimpleSort(&ctx, {k_v}, 0, hal::SortDirection::Ascending, 1, 5);
+
+        EXPECT_EQ(rets.size(), 1);
+
+        auto sorted_k_hat =
+            hal::dump_public_as<int32_t>(&ctx, hal::reveal(&ctx, rets[0]));
+
+        EXPECT_EQ(sorted_k, sorted_k_hat) << sorted_k << std::endl
+                                          << sorted_k_hat << std::endl;
+      });
+}
+
+TEST_P(SimpleSortTest, MultiRows) {
+  size_t npc = std::get<0>(GetParam());
+  FieldType field = std::get<1>(GetParam());
+  ProtocolKind prot = std::get<2>(GetParam());
+  RuntimeConfig::SortMethod method = std::get<3>(GetParam());
+
+  mpc::utils::simulate(
+      npc, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        RuntimeConfig cfg;
+        cfg.set_protocol(prot);
+        cfg.set_field(field);
+        cfg.set_enable_action_trace(false);
+        cfg.set_sort_method(method);
+        SPUContext ctx = test::makeSPUContext(cfg, lctx);
+
+        xt::xarray<float> k = {{7, 6, 5, 4, 1, 3, 2},
+                               {2, 9, 8, 1, 4, 3, 0},
+                               {5, 6, 3, 2, 7, 1, 4}};
+        xt::xarray<float> p = k * 10;
+
+        xt::xarray<float> sorted_k = {{7, 6, 5, 4, 3, 2, 1},
+                                      {9, 8, 4, 3, 2, 1, 0},
+                                      {7, 6, 5, 4, 3, 2, 1}};
+        xt::xarray<float> sorted_p = sorted_k * 10;
+
+        Value k_v = test::makeValue(&ctx, k, VIS_SECRET);
+        Value p_v = test::makeValue(&ctx, p, VIS_SECRET);
+
+        std::vector<spu::Value> rets =
+            SimpleSort(&ctx, {k_v, p_v}, 1, hal::SortDirection::Descending, 1);
+
+        EXPECT_EQ(rets.size(), 2);
+
+        auto sorted_k_hat =
+            hal::dump_public_as<float>(&ctx, hal::reveal(&ctx, rets[0]));
+        auto sorted_p_hat =
+            hal::dump_public_as<float>(&ctx, hal::reveal(&ctx, rets[1]));
+
+        EXPECT_TRUE(xt::allclose(sorted_k, sorted_k_hat, 0.01, 0.001))
+            << sorted_k << std::endl
+            << sorted_k_hat << std::endl;
+
+        EXPECT_TRUE(xt::allclose(sorted_p, sorted_p_hat, 0.01, 0.001))
+            << sorted_p << std::endl
+            << sorted_p_hat << std::endl;
+      });
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SimpleSort2PCTestInstances, SimpleSortTest,
     testing::Combine(
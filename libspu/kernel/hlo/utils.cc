@@ -35,9 +35,9 @@ xt::xarray<int64_t> getIndices(SPUContext *ctx, const spu::Value &value) {
   return kernel::hal::dump_public_as<int64_t>(ctx, value);
 }
 
-spu::Value expandWindow(SPUContext *ctx, const spu::Value &base,
-                        const Shape &window_shape,
-                        const Strides &window_strides) {
+static spu::Value expandWindow(const spu::Value &base,
+                               const Shape &window_shape,
+                               const Strides &window_strides) {
   const size_t ndim = base.shape().size();
 
   // sanity check.
@@ -57,33 +57,26 @@ spu::Value expandWindow(SPUContext *ctx, const spu::Value &base,
     N[dim] = (B[dim] - W[dim]) / S[dim] + 1;
   }
 
-  // sample all windows.
-  std::vector<spu::Value> windows;
-  {
-    Index window_index(ndim, 0);
-    do {
-      // for each window_index, find the corresponding window.
-      Index start(ndim);
-      Index end(ndim);
-      for (size_t dim = 0; dim < ndim; dim++) {
-        start[dim] = window_index[dim] * S[dim];
-        end[dim] = start[dim] + W[dim];
-      }
-      auto window = hal::slice(ctx, base, start, end, {});
-
-      windows.emplace_back(hal::unsqueeze(ctx, window));
-    } while (bumpIndices(N, absl::MakeSpan(window_index)));
-  }
-
-  // concatenate windows.
-  auto res = hal::concatenate(ctx, windows, 0);
-  SPU_ENFORCE_EQ(static_cast<int64_t>(windows.size()), N.numel());
-
-  // reshape to tiled layout.
-  // res_shape = (N0, N1, ..., Nn, W0, W1, ..., Wn)
+  // Every window is a strided view of base, so all of them together are one
+  // view too: window count axis i walks base axis i by Si elements and window
+  // axis i walks it by one. Windows overlap when Si < Wi, so nothing is copied
+  // here, the consumer materializes the expansion once when it needs it.
   Shape res_shape = N;
   res_shape.insert(res_shape.end(), W.begin(), W.end());
-  return hal::reshape(ctx, res, res_shape);
+  auto view = [&](const NdArrayRef &arr) {
+    Strides res_strides(2 * ndim);
+    for (size_t dim = 0; dim < ndim; dim++) {
+      res_strides[dim] = arr.strides()[dim] * S[dim];
+      res_strides[ndim + dim] = arr.strides()[dim];
+    }
+    return NdArrayRef(arr.buf(), arr.eltype(), res_shape, res_strides,
+                      arr.offset());
+  };
+
+  if (base.isComplex()) {
+    return Value(view(base.data()), view(*base.imag()), base.dtype());
+  }
+  return Value(view(base.data()), base.dtype());
 }
 
 spu::Value expandWindow(SPUContext *ctx, const spu::Value &base,
@@ -107,10 +100,10 @@ spu::Value expandWindow(SPUContext *ctx, const spu::Value &base,
   if (need_pad) {
     Value padded =
         hal::pad(ctx, base, init_val, padding_lo, padding_hi, padding_in);
-    return expandWindow(ctx, padded, window_shape, window_strides);
+    return expandWindow(padded, window_shape, window_strides);
   }
 
-  return expandWindow(ctx, base, window_shape, window_strides);
+  return expandWindow(base, window_shape, window_strides);
 }
 
 }  // namespace spu::kernel
@@ -455,8 +455,7 @@ Value carry_a2b(SPUContext* ctx, const Value& x, const Value& y, size_t k) {
   auto G = and_bb(ctx, x, y);
 
   // Use kogge stone layout.
-  //    Theoreticall: k + k/2 + k/4 + ... + 1 = 2k
-  //    Actually: K + k/2 + k/4 + ... + 8 (8) + 8 (4) + 8 (2) + 8 (1) = 2k + 16
+  //    k + k/2 + k/4 + ... + 1 = 2k, narrow rounds are bit packed on the wire.
   while (k > 1) {
     if (k % 2 != 0) {
       k += 1;
@@ -231,8 +231,8 @@ NdArrayRef A2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
     auto out_ty = makeType<Priv2kTy>(field, rank);
 
     if (comm->getRank() == rank) {
-      auto x3 = comm->recv<ashr_el_t>(comm->nextRank(), "a2v");  // comm => 1, k
-                                                                 //
+      auto x3 =
+          comm->recvBuffer<ashr_el_t>(comm->nextRank(), "a2v");  // comm => 1, k
       NdArrayRef out(out_ty, in.shape());
       NdArrayView<vshr_el_t> _out(out);
 
@@ -283,13 +283,15 @@ NdArrayRef V2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
         _out[idx][1] = _s1[idx];
       });
     } else if (comm->getRank() == (owner_rank + 1) % 3) {
-      auto x0 = comm->recv<ashr_el_t>(comm->prevRank(), "v2a");  // comm => 1, k
+      auto x0 =
+          comm->recvBuffer<ashr_el_t>(comm->prevRank(), "v2a");  // comm => 1, k
       pforeach(0, in.numel(), [&](int64_t idx) {
         _out[idx][0] = x0[idx];
         _out[idx][1] = 0;
       });
     } else {
-      auto x1 = comm->recv<ashr_el_t>(comm->nextRank(), "v2a");  // comm => 1, k
+      auto x1 =
+          comm->recvBuffer<ashr_el_t>(comm->nextRank(), "v2a");  // comm => 1, k
       pforeach(0, in.numel(), [&](int64_t idx) {
         _out[idx][0] = 0;
         _out[idx][1] = x1[idx];
@@ -647,7 +649,12 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
     auto z1 = ring_sum({t0, t2.get(), r.get()});
 
     auto f = std::async([&] { ring_assign(o1, z1); });
-    ring_assign(o2, comm->rotate(z1, kBindName()));  // comm => 1, k
+    // o2 is filled chunk by chunk while the rest of the peer's z1 is in flight.
+    comm->rotateStream(  // comm => 1, k
+        z1, kBindName(), [&](int64_t offset, const NdArrayRef& chunk) {
+          o2.copy_slice(chunk, {0}, unflattenIndex(offset, o2.shape()),
+                        chunk.numel());
+        });
     f.get();
 #ifdef CUDA_ENABLED
   } else {
@@ -739,7 +746,7 @@ template <typename T>
 std::vector<T> openWith(Communicator* comm, size_t peer_rank,
                         absl::Span<T const> in) {
   comm->sendAsync(peer_rank, in, "_");
-  auto peer = comm->recv<T>(peer_rank, "_");
+  auto peer = comm->recvBuffer<T>(peer_rank, "_");
   SPU_ENFORCE(peer.size() == in.size());
   std::vector<T> out(in.size());
 
@@ -811,7 +818,7 @@ NdArrayRef TruncAPr::proc(KernelEvalContext* ctx, const NdArrayRef& in,
       // get correlated randomness from P2
       // let rb = r{k-1},
       //     rc = sum(r{i-m}<<(i-m)) for i in range(m, k-2)
-      auto cr = comm->recv<el_t>(P2, "cr0");
+      auto cr = comm->recvBuffer<el_t>(P2, "cr0");
       auto rb = absl::MakeSpan(cr).subspan(0, numel);
       auto rc = absl::MakeSpan(cr).subspan(numel, numel);
 
@@ -843,7 +850,7 @@ NdArrayRef TruncAPr::proc(KernelEvalContext* ctx, const NdArrayRef& in,
       });
 
       comm->sendAsync<el_t>(P1, y2, "2to3");
-      auto tmp = comm->recv<el_t>(P1, "2to3");
+      auto tmp = comm->recvBuffer<el_t>(P1, "2to3");
 
       // rebuild the final result.
       pforeach(0, numel, [&](int64_t idx) {
@@ -867,7 +874,7 @@ NdArrayRef TruncAPr::proc(KernelEvalContext* ctx, const NdArrayRef& in,
       // get correlated randomness from P2
       // let rb = r{k-1},
       //     rc = sum(r{i-m}<<(i-m)) for i in range(m, k-2)
-      auto cr = comm->recv<el_t>(P2, "cr1");
+      auto cr = comm->recvBuffer<el_t>(P2, "cr1");
       auto rb = absl::MakeSpan(cr).subspan(0, numel);
       auto rc = absl::MakeSpan(cr).subspan(numel, numel);
 
@@ -889,7 +896,7 @@ NdArrayRef TruncAPr::proc(KernelEvalContext* ctx, const NdArrayRef& in,
         y2[idx] -= y3[idx];
       });
       comm->sendAsync<el_t>(P0, y2, "2to3");
-      auto tmp = comm->recv<el_t>(P0, "2to3");
+      auto tmp = comm->recvBuffer<el_t>(P0, "2to3");
 
       // rebuild the final result.
       pforeach(0, numel, [&](int64_t idx) {
@@ -175,8 +175,8 @@ NdArrayRef B2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
       auto out_ty = makeType<Priv2kTy>(field, rank);
 
       if (comm->getRank() == rank) {
-        auto x3 =
-            comm->recv<bshr_el_t>(comm->nextRank(), "b2v");  // comm => 1, k
+        auto x3 = comm->recvBuffer<bshr_el_t>(comm->nextRank(),
+                                              "b2v");  // comm => 1, k
 
         NdArrayRef out(out_ty, in.shape());
         NdArrayView<vshr_scalar_t> _out(out);
@@ -273,15 +273,25 @@ NdArrayRef AndBB::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
         prg_state->fillPrssPair(r0.data(), r1.data(), r0.size(),
                                 PrgState::GenPrssCtrl::Both);
 
+        // Only the low out_nbits are valid and go through the wire, clear the
+        // rest so both copies of the replicated share agree.
+        const size_t wire_nbits =
+            out_nbits == 0 ? sizeof(out_el_t) * 8 : out_nbits;
+        const out_el_t mask = wire_nbits == sizeof(out_el_t) * 8
+                                  ? ~out_el_t(0)
+                                  : (out_el_t(1) << wire_nbits) - 1;
+
         // z1 = (x1 & y1) ^ (x1 & y2) ^ (x2 & y1) ^ (r0 ^ r1);
         pforeach(0, lhs.numel(), [&](int64_t idx) {
           const auto& l = _lhs[idx];
           const auto& r = _rhs[idx];
-          r0[idx] = (l[0] & r[0]) ^ (l[0] & r[1]) ^ (l[1] & r[0]) ^
-                    (r0[idx] ^ r1[idx]);
+          r0[idx] = ((l[0] & r[0]) ^ (l[0] & r[1]) ^ (l[1] & r[0]) ^
+                     (r0[idx] ^ r1[idx])) &
+                    mask;
         });
 
-        r1 = comm->rotate<out_el_t>(r0, "andbb");  // comm => 1, k
+        r1 = comm->rotate<out_el_t>(r0, wire_nbits,
+                                    "andbb");  // comm => 1, k
 
         NdArrayView<out_shr_t> _out(out);
         pforeach(0, lhs.numel(), [&](int64_t idx) {
@@ -219,9 +219,9 @@ NdArrayRef B2AByPPA::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
       NdArrayView<ashr_t> _x_plus_r(x_plus_r);
 
       // reveal
-      std::vector<ashr_el_t> x_plus_r_2(numel);
+      CommBuffer<ashr_el_t> x_plus_r_2;
       if (comm->getRank() == 0) {
-        x_plus_r_2 = comm->recv<ashr_el_t>(2, "reveal.x_plus_r.to.P0");
+        x_plus_r_2 = comm->recvBuffer<ashr_el_t>(2, "reveal.x_plus_r.to.P0");
       } else if (comm->getRank() == 2) {
         std::vector<ashr_el_t> x_plus_r_0(numel);
         pforeach(0, numel,
@@ -383,7 +383,7 @@ NdArrayRef B2AByOT::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
         comm->sendAsync<ashr_el_t>(P1, m0, "mc");
 
         auto c1 = bitCompose<ashr_el_t>(r0, in_nbits);
-        auto c2 = comm->recv<ashr_el_t>(P1, "c2");
+        auto c2 = comm->recvBuffer<ashr_el_t>(P1, "c2");
 
         pforeach(0, numel, [&](int64_t idx) {
           _out[idx][0] = c1[idx];
@@ -394,9 +394,9 @@ NdArrayRef B2AByOT::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
         auto b2 = bitDecompose<bshr_el_t>(getShare(in, 0), in_nbits);
 
         // ot.recv
-        auto mc = comm->recv<ashr_el_t>(P0, "mc");
-        auto m0 = comm->recv<ashr_el_t>(P2, "m0");
-        auto m1 = comm->recv<ashr_el_t>(P2, "m1");
+        auto mc = comm->recvBuffer<ashr_el_t>(P0, "mc");
+        auto m0 = comm->recvBuffer<ashr_el_t>(P2, "m0");
+        auto m1 = comm->recvBuffer<ashr_el_t>(P2, "m1");
 
         // rebuild c2 = (b1^b2^b3)-c1-c3
         pforeach(0, total_nbits, [&](int64_t idx) {
@@ -441,6 +441,7 @@ NdArrayRef B2AByOT::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
           m1[idx] ^= r1[idx];
         });
 
+        Communicator::Epoch epoch(comm);
         comm->sendAsync<ashr_el_t>(P1, m0, "m0");
         comm->sendAsync<ashr_el_t>(P1, m1, "m1");
 
@@ -610,7 +611,7 @@ NdArrayRef MsbA2B::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto wrap_m = WrapValue(m);
   auto wrap_n = WrapValue(n);
   {
-    // 2. 2k + 16 * 2 bits
+    // 2. 3k - 2 bits
     auto carry = carry_a2b(sctx, wrap_m, wrap_n, nbits);
 
     // Compute the k'th bit.
@@ -681,6 +682,8 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
         pforeach(0, numel, [&](int64_t idx) {
           r_arith_1[idx] = r[idx] - r_arith_0[idx];
         });
+        // r_arith and r_bool go to P2 together.
+        Communicator::Epoch epoch(comm);
         comm->sendAsync<ashr_el_t>(P2, r_arith_1, "r_arith");
 
         std::vector<bshr_el_t> r_bool_1(numel);
@@ -723,7 +726,7 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
 
         std::vector<bshr_el_t> zero_flag_2pc(numel);
         if (comm->getRank() == P1) {
-          auto c_p = comm->recv<ashr_el_t>(P2, "c_s");
+          auto c_p = comm->recvBuffer<ashr_el_t>(P2, "c_s");
 
           // reveal c
           pforeach(0, numel,
@@ -748,7 +751,7 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
           pforeach(0, numel,
                    [&](int64_t idx) { zero_flag_3pc_1[idx] = r_bool[idx]; });
 
-          auto flag_split = comm->recv<bshr_el_t>(P1, "flag_split");
+          auto flag_split = comm->recvBuffer<bshr_el_t>(P1, "flag_split");
           pforeach(0, numel, [&](int64_t idx) {
             zero_flag_3pc_0[idx] = flag_split[idx];
           });
@@ -848,6 +851,61 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
   return out;
 }
 
+NdArrayRef RingCastS::proc(KernelEvalContext*, const NdArrayRef& in,
+                           const Type& to_type) const {
+  const auto to_field = to_type.as<Ring2k>()->field();
+  const size_t to_bits = SizeOf(to_field) * 8;
+
+  if (in.eltype().isa<BShrTy>()) {
+    // boolean shares are not bound to a ring, only drop the high bits.
+    const size_t nbits = in.eltype().as<BShrTy>()->nbits();
+    if (nbits <= to_bits) {
+      return in;
+    }
+    const PtType out_btype = calcBShareBacktype(to_bits);
+    NdArrayRef out(makeType<BShrTy>(out_btype, to_bits), in.shape());
+    DISPATCH_UINT_PT_TYPES(in.eltype().as<BShrTy>()->getBacktype(), [&]() {
+      using in_shr_t = std::array<ScalarT, 2>;
+      NdArrayView<in_shr_t> _in(in);
+
+      DISPATCH_UINT_PT_TYPES(out_btype, [&]() {
+        using out_el_t = ScalarT;
+        using out_shr_t = std::array<out_el_t, 2>;
+        NdArrayView<out_shr_t> _out(out);
+
+        pforeach(0, in.numel(), [&](int64_t idx) {
+          _out[idx][0] = static_cast<out_el_t>(_in[idx][0]);
+          _out[idx][1] = static_cast<out_el_t>(_in[idx][1]);
+        });
+      });
+    });
+    return out;
+  }
+
+  const auto field = in.eltype().as<AShrTy>()->field();
+  SPU_ENFORCE(SizeOf(to_field) <= SizeOf(field),
+              "arithmetic share could only be narrowed, from={}, to={}", field,
+              to_field);
+
+  NdArrayRef out(makeType<AShrTy>(to_field), in.shape());
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    using in_shr_t = std::array<ring2k_t, 2>;
+    NdArrayView<in_shr_t> _in(in);
+
+    DISPATCH_ALL_FIELDS(to_field, [&]() {
+      using out_shr_t = std::array<ring2k_t, 2>;
+      NdArrayView<out_shr_t> _out(out);
+
+      pforeach(0, in.numel(), [&](int64_t idx) {
+        _out[idx][0] = static_cast<ring2k_t>(_in[idx][0]);
+        _out[idx][1] = static_cast<ring2k_t>(_in[idx][1]);
+      });
+    });
+  });
+
+  return out;
+}
+
 NdArrayRef EqualAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                          const NdArrayRef& rhs) const {
   const auto* lhs_ty = lhs.eltype().as<AShrTy>();
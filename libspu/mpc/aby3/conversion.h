@@ -110,14 +110,26 @@ class MsbA2B : public UnaryKernel {
   }
 
   ce::CExpr comm() const override {
-    // 1 * carry : k + 2 * k + 16 * 2
+    // 1 * carry : k + 2 * (k/2 + k/4 + ... + 1)
     // 1 * rotate: k
-    return ce::K() + 2 * ce::K() + ce::K() + 32;
+    return ce::K() + 2 * (ce::K() - 1) + ce::K();
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& in) const override;
 };
 
+class RingCastS : public CastTypeKernel {
+ public:
+  static constexpr const char* kBindName() { return "ring_cast_s"; }
+
+  ce::CExpr latency() const override { return ce::Const(0); }
+
+  ce::CExpr comm() const override { return ce::Const(0); }
+
+  NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& in,
+                  const Type& to_type) const override;
+};
+
 class EqualAA : public BinaryKernel {
  public:
   static constexpr const char* kBindName() { return "equal_aa"; }
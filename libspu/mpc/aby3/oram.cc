@@ -15,6 +15,7 @@
 #include "libspu/mpc/aby3/oram.h"
 
 #include <future>
+#include <memory>
 
 #include "yacl/crypto/rand/rand.h"
 
@@ -28,14 +29,15 @@
 namespace spu::mpc::aby3 {
 
 // [TODO] divide into blocks when s is large
-// generate 3 * 2pc-dpf, e0 e1 e2
+// generate 3 * 2pc-dpf, e0 e1 e2 for every target point
 // p0 holds(e01, e10), p1 holds(e11, e20), p2 holds(e21, e00)
 NdArrayRef OramOneHotAA::proc(KernelEvalContext *ctx, const NdArrayRef &in,
                               int64_t s) const {
   auto *comm = ctx->getState<Communicator>();
   const auto eltype = in.eltype();
   const auto field = eltype.as<AShrTy>()->field();
-  NdArrayRef out(makeType<OShrTy>(field), {s});
+  const auto numel = in.numel();
+  NdArrayRef out(makeType<OShrTy>(field), {numel, s});
 
   DISPATCH_ALL_FIELDS(field, [&]() {
     using el_t = ring2k_t;
@@ -46,32 +48,35 @@ NdArrayRef OramOneHotAA::proc(KernelEvalContext *ctx, const NdArrayRef &in,
     NdArrayView<shr_t> target_idxs_(in_b);
 
     // generate aeskey for dpf
-    auto [self_aes_keys, next_aes_keys] = oram::genAesKey(ctx, 1);
+    auto [self_aes_keys, next_aes_keys] = oram::genAesKey(ctx, numel);
 
-    auto octx = oram::OramContext<el_t>(s);
+    auto octx = oram::OramContext<el_t>(s, numel);
 
     for (int64_t j = 0; j < 3; j++) {
       // in round (rank - 1), as helper
       if ((j + 1) % 3 == static_cast<int64_t>(comm->getRank())) {
         // beaver for dpf gen
-        oram::genOramBeaverHelper<oram::DpfKeyT>(ctx, Log2Ceil(s) * 2,
+        oram::genOramBeaverHelper<oram::DpfKeyT>(ctx, Log2Ceil(s) * 2 * numel,
                                                  oram::OpKind::And);
         // beaver for B2A convert
-        oram::genOramBeaverHelper<el_t>(ctx, 1, oram::OpKind::Mul);
+        oram::genOramBeaverHelper<el_t>(ctx, numel, oram::OpKind::Mul);
       } else {
         auto dpf_rank = comm->getRank() == static_cast<size_t>(j);
-        auto aes_key = dpf_rank ? self_aes_keys[0] : next_aes_keys[0];
-        auto target_point = dpf_rank ? target_idxs_[0][0] ^ target_idxs_[0][1]
-                                     : target_idxs_[0][0];
+        const auto &aes_keys = dpf_rank ? self_aes_keys : next_aes_keys;
+        std::vector<uint128_t> target_points(numel);
+        for (int64_t k = 0; k < numel; k++) {
+          target_points[k] = dpf_rank ? target_idxs_[k][0] ^ target_idxs_[k][1]
+                                      : target_idxs_[k][0];
+        }
         // dpf gen
-        octx.genDpf(ctx, static_cast<oram::DpfGenCtrl>(j), aes_key,
-                    target_point);
+        octx.genDpf(ctx, static_cast<oram::DpfGenCtrl>(j), aes_keys,
+                    target_points);
         // B2A
         octx.onehotB2A(ctx, static_cast<oram::DpfGenCtrl>(j));
       }
     }
 
-    pforeach(0, s, [&](int64_t k) {
+    pforeach(0, numel * s, [&](int64_t k) {
       for (int64_t j = 0; j < 2; j++) {
         out_[k][j] = octx.dpf_e[j][k];
       }
@@ -81,7 +86,7 @@ NdArrayRef OramOneHotAA::proc(KernelEvalContext *ctx, const NdArrayRef &in,
   return out;
 };
 
-// generate 1 * 2pc-dpf, e
+// generate 1 * 2pc-dpf, e for every target point
 // p0 holds(e0), p1 holds(e1)
 NdArrayRef OramOneHotAP::proc(KernelEvalContext *ctx, const NdArrayRef &in,
                               int64_t s) const {
@@ -89,7 +94,7 @@ NdArrayRef OramOneHotAP::proc(KernelEvalContext *ctx, const NdArrayRef &in,
   const auto eltype = in.eltype();
   const auto field = eltype.as<AShrTy>()->field();
   const auto numel = in.numel();
-  NdArrayRef out(makeType<OPShrTy>(field), {s});
+  NdArrayRef out(makeType<OPShrTy>(field), {numel, s});
 
   DISPATCH_ALL_FIELDS(field, [&]() {
     using el_t = ring2k_t;
@@ -99,9 +104,9 @@ NdArrayRef OramOneHotAP::proc(KernelEvalContext *ctx, const NdArrayRef &in,
     auto in_b = UnwrapValue(a2b(ctx->sctx(), WrapValue(in)));
 
     if (comm->getRank() == 2) {
-      oram::genOramBeaverHelper<oram::DpfKeyT>(ctx, Log2Ceil(s) * 2,
+      oram::genOramBeaverHelper<oram::DpfKeyT>(ctx, Log2Ceil(s) * 2 * numel,
                                                oram::OpKind::And);
-      oram::genOramBeaverHelper<el_t>(ctx, 1, oram::OpKind::Mul);
+      oram::genOramBeaverHelper<el_t>(ctx, numel, oram::OpKind::Mul);
     } else {
       auto dst_rank = comm->getRank() == 0 ? 1 : 0;
       // 3->2
@@ -119,21 +124,29 @@ NdArrayRef OramOneHotAP::proc(KernelEvalContext *ctx, const NdArrayRef &in,
       }
 
       // generate aeskey for dpf
-      auto aes_key = yacl::crypto::SecureRandSeed();
+      std::vector<uint128_t> aes_keys(numel);
+      std::vector<uint128_t> target_points(numel);
+      for (int64_t k = 0; k < numel; k++) {
+        aes_keys[k] = yacl::crypto::SecureRandSeed();
+        target_points[k] = target_point_2pc_[k];
+      }
 
-      comm->sendAsync<uint128_t>(dst_rank, {aes_key}, "aes_key");
-      aes_key += comm->recv<uint128_t>(dst_rank, "aes_key")[0];
+      comm->sendAsync<uint128_t>(dst_rank, aes_keys, "aes_key");
+      auto peer_aes_keys = comm->recvBuffer<uint128_t>(dst_rank, "aes_key");
+      for (int64_t k = 0; k < numel; k++) {
+        aes_keys[k] += peer_aes_keys[k];
+      }
 
-      auto octx = oram::OramContext<el_t>(s);
+      auto octx = oram::OramContext<el_t>(s, numel);
 
       // dpf gen
-      octx.genDpf(ctx, static_cast<oram::DpfGenCtrl>(1), aes_key,
-                  target_point_2pc_[0]);
+      octx.genDpf(ctx, static_cast<oram::DpfGenCtrl>(1), aes_keys,
+                  target_points);
       // B2A
       octx.onehotB2A(ctx, static_cast<oram::DpfGenCtrl>(1));
 
       int64_t j = comm->getRank() == 0 ? 1 : 0;
-      pforeach(0, s, [&](int64_t k) { out_[k] = octx.dpf_e[j][k]; });
+      pforeach(0, numel * s, [&](int64_t k) { out_[k] = octx.dpf_e[j][k]; });
     }
   });
 
@@ -147,16 +160,17 @@ NdArrayRef OramReadOA::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
 
   const auto field = db.eltype().as<AShrTy>()->field();
   int64_t index_times = db.shape()[1];
-  int64_t db_numel = onehot.numel();
+  int64_t num_onehots = onehot.shape()[0];
+  int64_t db_numel = onehot.shape()[1];
 
-  NdArrayRef out(makeType<AShrTy>(field), {1, index_times});
+  NdArrayRef out(makeType<AShrTy>(field), {num_onehots, index_times});
 
   DISPATCH_ALL_FIELDS(field, [&]() {
     using el_t = ring2k_t;
     using shr_t = std::array<el_t, 2>;
 
     auto r = std::async([&] {
-      auto [r0, r1] = prg->genPrssPair(field, {1, index_times},
+      auto [r0, r1] = prg->genPrssPair(field, {num_onehots, index_times},
                                        PrgState::GenPrssCtrl::Both);
       return ring_sub(r0, r1);
     });
@@ -166,8 +180,10 @@ NdArrayRef OramReadOA::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
     NdArrayRef shifted_onehot(makeType<OShrTy>(field), onehot.shape());
     NdArrayView<shr_t> shifted_onehot_(shifted_onehot);
     if (offset != 0) {
-      pforeach(0, db_numel, [&](int64_t idx) {
-        shifted_onehot_[idx] = onehot_[(idx - offset + db_numel) % db_numel];
+      pforeach(0, num_onehots * db_numel, [&](int64_t idx) {
+        int64_t row = idx - idx % db_numel;
+        shifted_onehot_[idx] =
+            onehot_[row + (idx - row - offset + db_numel) % db_numel];
       });
     } else {
       shifted_onehot = onehot;
@@ -204,34 +220,38 @@ NdArrayRef OramReadOP::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
   if (db.shape().size() == 2) {
     index_times = db.shape()[1];
   }
-  NdArrayRef out(makeType<AShrTy>(field), {1, index_times});
+  int64_t num_onehots = onehot.shape()[0];
+  int64_t db_numel = onehot.shape()[1];
+  NdArrayRef out(makeType<AShrTy>(field), {num_onehots, index_times});
   auto o1 = getFirstShare(out);
   auto o2 = getSecondShare(out);
-  int64_t db_numel = onehot.numel();
 
   DISPATCH_ALL_FIELDS(field, [&]() {
     using el_t = ring2k_t;
     using shr_t = std::array<el_t, 2>;
 
     NdArrayView<shr_t> out_(out);
-    NdArrayRef out2pc(makeType<RingTy>(field), {1, index_times});
+    NdArrayRef out2pc(makeType<RingTy>(field), {num_onehots, index_times});
     NdArrayView<el_t> out2pc_(out2pc);
 
     auto r = std::async([&] {
-      auto [r0, r1] = prg->genPrssPair(field, {1, index_times},
+      auto [r0, r1] = prg->genPrssPair(field, {num_onehots, index_times},
                                        PrgState::GenPrssCtrl::Both);
       return ring_sub(r0, r1);
     });
 
     if (comm->getRank() == 2) {
-      pforeach(0, index_times, [&](int64_t idx) { out2pc_[idx] = 0; });
+      pforeach(0, num_onehots * index_times,
+               [&](int64_t idx) { out2pc_[idx] = 0; });
     } else {
       NdArrayView<el_t> onehot_(onehot);
       NdArrayRef shifted_onehot(makeType<OPShrTy>(field), onehot.shape());
       NdArrayView<el_t> shifted_onehot_(shifted_onehot);
       if (offset != 0) {
-        pforeach(0, db_numel, [&](int64_t idx) {
-          shifted_onehot_[idx] = onehot_[(idx - offset + db_numel) % db_numel];
+        pforeach(0, num_onehots * db_numel, [&](int64_t idx) {
+          int64_t row = idx - idx % db_numel;
+          shifted_onehot_[idx] =
+              onehot_[row + (idx - row - offset + db_numel) % db_numel];
         });
       } else {
         shifted_onehot = onehot;
@@ -301,7 +321,7 @@ Triple<std::vector<T>> genOramBeaverPrim(KernelEvalContext *ctx, int64_t num,
 
   // adjust
   if (comm->getRank() == adjust_rank) {
-    auto adjust_c = comm->recv<T>(comm->nextRank(), "adjusted_c");
+    auto adjust_c = comm->recvBuffer<T>(comm->nextRank(), "adjusted_c");
     if (op == OpKind::And) {
       pforeach(0, num, [&](int64_t i) { c[i] ^= adjust_c[i]; });
     } else {
@@ -348,40 +368,49 @@ void genOramBeaverHelper(KernelEvalContext *ctx, int64_t num, OpKind op) {
   comm->sendAsync<T>(adjust_rank, absl::MakeSpan(adjusted_c), "adjusted_c");
 };
 
-DpfKeyT computecw(KernelEvalContext *ctx, DpfKeyT target_bit, DpfKeyT suml,
-                  DpfKeyT sumr, std::array<DpfKeyT, 3> &oram_and_beaver_l,
-                  std::array<DpfKeyT, 3> &oram_and_beaver_r, DpfGenCtrl ctrl) {
+// compute the local share of cw for every dpf, in one round
+std::vector<DpfKeyT> computecw(
+    KernelEvalContext *ctx, absl::Span<const DpfKeyT> target_bits,
+    absl::Span<const DpfKeyT> suml, absl::Span<const DpfKeyT> sumr,
+    absl::Span<const std::array<DpfKeyT, 3>> oram_and_beaver_l,
+    absl::Span<const std::array<DpfKeyT, 3>> oram_and_beaver_r,
+    DpfGenCtrl ctrl) {
   auto *comm = ctx->getState<Communicator>();
   auto dpf_rank = comm->getRank() == static_cast<size_t>(ctrl);
   size_t dst_rank = dpf_rank ? comm->prevRank() : comm->nextRank();
-
-  std::array<DpfKeyT, 4> mask;
-  mask[0] = target_bit ^ oram_and_beaver_l[0];
-  mask[1] = suml ^ oram_and_beaver_l[1];
-  mask[2] = dpf_rank ? target_bit ^ -1 ^ oram_and_beaver_r[0]
-                     : target_bit ^ oram_and_beaver_r[0];
-  mask[3] = sumr ^ oram_and_beaver_r[1];
+  const size_t num = target_bits.size();
+
+  std::vector<DpfKeyT> mask(num * 4);
+  for (size_t k = 0; k < num; k++) {
+    mask[k * 4] = target_bits[k] ^ oram_and_beaver_l[k][0];
+    mask[k * 4 + 1] = suml[k] ^ oram_and_beaver_l[k][1];
+    mask[k * 4 + 2] = dpf_rank ? target_bits[k] ^ -1 ^ oram_and_beaver_r[k][0]
+                               : target_bits[k] ^ oram_and_beaver_r[k][0];
+    mask[k * 4 + 3] = sumr[k] ^ oram_and_beaver_r[k][1];
+  }
 
   comm->sendAsync<DpfKeyT>(dst_rank, absl::MakeSpan(mask), "open(x^a,y^b)");
-  auto temp = comm->recv<DpfKeyT>(dst_rank, "open(x^a,y^b)");
-  for (uint64_t i = 0; i < mask.size(); i++) {
+  auto temp = comm->recvBuffer<DpfKeyT>(dst_rank, "open(x^a,y^b)");
+  for (size_t i = 0; i < mask.size(); i++) {
     mask[i] ^= temp[i];
   }
 
-  std::vector<DpfKeyT> z(2);
-  z[0] = oram_and_beaver_l[2];
-  z[0] ^= mask[0] & oram_and_beaver_l[1];
-  z[0] ^= mask[1] & oram_and_beaver_l[0];
-
-  z[1] = oram_and_beaver_r[2];
-  z[1] ^= mask[2] & oram_and_beaver_r[1];
-  z[1] ^= mask[3] & oram_and_beaver_r[0];
-  if (dpf_rank) {
-    z[0] ^= mask[0] & mask[1];
-    z[1] ^= mask[2] & mask[3];
+  std::vector<DpfKeyT> cw(num);
+  for (size_t k = 0; k < num; k++) {
+    const auto *m = &mask[k * 4];
+    const auto &bl = oram_and_beaver_l[k];
+    const auto &br = oram_and_beaver_r[k];
+
+    DpfKeyT z0 = bl[2] ^ (m[0] & bl[1]) ^ (m[1] & bl[0]);
+    DpfKeyT z1 = br[2] ^ (m[2] & br[1]) ^ (m[3] & br[0]);
+    if (dpf_rank) {
+      z0 ^= m[0] & m[1];
+      z1 ^= m[2] & m[3];
+    }
+    cw[k] = z0 ^ z1;
   }
 
-  return z[0] ^ z[1];
+  return cw;
 };
 
 template <typename T>
@@ -408,7 +437,7 @@ std::vector<T> mul2pc(KernelEvalContext *ctx, absl::Span<T const> x,
 
   comm->sendAsync<T>(dst_rank, absl::MakeSpan(eu), "open(x-a, y-b)");
 
-  auto temp_eu = comm->recv<T>(dst_rank, "open(x-a, y-b)");
+  auto temp_eu = comm->recvBuffer<T>(dst_rank, "open(x-a, y-b)");
   pforeach(0, numel * 2, [&](int64_t idx) { eu[idx] += temp_eu[idx]; });
 
   // Zi = Ci + (X - A) * Bi + (Y - B) * Ai + <(X - A) * (Y - B)>
@@ -431,34 +460,51 @@ void OramContext<T>::onehotB2A(KernelEvalContext *ctx, DpfGenCtrl ctrl) {
   size_t dst_rank = dpf_rank ? comm->prevRank() : comm->nextRank();
   int64_t dpf_idx = comm->getRank() == static_cast<size_t>(ctrl) ? 0 : 1;
 
-  T pm = 0;
-  T F = 0;
-  std::vector<T> r(1);
+  std::vector<T> pm(num_, 0);
+  std::vector<T> F(num_, 0);
+  std::vector<T> r(num_);
   prg->fillPriv(absl::MakeSpan(r));
 
-  const std::vector<T> e = dpf_e[dpf_idx];
-  const std::vector<T> v = convert_help_v[dpf_idx];
-  std::for_each(e.begin(), e.end(), [&](T ele) { pm += ele; });
-  std::for_each(v.begin(), v.end(), [&](T ele) { F -= ele; });
-  T blinded_pm = pm + r[0];
+  const std::vector<T> &e = dpf_e[dpf_idx];
+  const std::vector<T> &v = convert_help_v[dpf_idx];
+  for (int64_t k = 0; k < num_; k++) {
+    for (int64_t idx = k * dpf_size_; idx < (k + 1) * dpf_size_; idx++) {
+      pm[k] += e[idx];
+      F[k] -= v[idx];
+    }
+  }
+  std::vector<T> blinded_pm(num_);
+  for (int64_t k = 0; k < num_; k++) {
+    blinded_pm[k] = pm[k] + r[k];
+  }
 
   // open blinded_pm
-  comm->sendAsync<T>(dst_rank, {blinded_pm}, "open(blinded_pm)");
-  blinded_pm += comm->recv<T>(dst_rank, "open(blinded_pm)")[0];
+  comm->sendAsync<T>(dst_rank, absl::MakeSpan(blinded_pm), "open(blinded_pm)");
+  auto peer_pm = comm->recvBuffer<T>(dst_rank, "open(blinded_pm)");
+  for (int64_t k = 0; k < num_; k++) {
+    blinded_pm[k] += peer_pm[k];
+  }
 
-  auto pm_mul_F = mul2pc<T>(ctx, {pm}, {F}, static_cast<size_t>(ctrl));
-  T blinded_F = pm_mul_F[0] + r[0];
+  auto pm_mul_F = mul2pc<T>(ctx, pm, F, static_cast<size_t>(ctrl));
+  std::vector<T> blinded_F(num_);
+  for (int64_t k = 0; k < num_; k++) {
+    blinded_F[k] = pm_mul_F[k] + r[k];
+  }
 
   // open blinded_F
-  comm->sendAsync<T>(dst_rank, {blinded_F}, "open(blinded_F)");
-  blinded_F += comm->recv<T>(dst_rank, "open(blinded_F)")[0];
+  comm->sendAsync<T>(dst_rank, absl::MakeSpan(blinded_F), "open(blinded_F)");
+  auto peer_F = comm->recvBuffer<T>(dst_rank, "open(blinded_F)");
+  for (int64_t k = 0; k < num_; k++) {
+    blinded_F[k] += peer_F[k];
+  }
 
-  std::vector<T> e_a(dpf_size_);
-  pforeach(0, dpf_size_, [&](int64_t idx) {
-    e_a[idx] = e[idx] * blinded_pm - v[idx] - e[idx] * blinded_F;
+  std::vector<T> e_a(dpf_size_ * num_);
+  pforeach(0, dpf_size_ * num_, [&](int64_t idx) {
+    const int64_t k = idx / dpf_size_;
+    e_a[idx] = e[idx] * blinded_pm[k] - v[idx] - e[idx] * blinded_F[k];
   });
 
-  dpf_e[dpf_idx] = e_a;
+  dpf_e[dpf_idx] = std::move(e_a);
 };
 
 std::pair<std::vector<uint128_t>, std::vector<uint128_t>> genAesKey(
@@ -478,12 +524,21 @@ std::pair<std::vector<uint128_t>, std::vector<uint128_t>> genAesKey(
 
 template <typename T>
 void OramContext<T>::genDpf(KernelEvalContext *ctx, DpfGenCtrl ctrl,
-                            uint128_t aes_key, uint128_t target_point) {
+                            absl::Span<const uint128_t> aes_keys,
+                            absl::Span<const uint128_t> target_points) {
   auto *comm = ctx->getState<Communicator>();
-
-  auto odpf = OramDpf(dpf_size_, yacl::crypto::SecureRandU128(), aes_key,
-                      static_cast<uint128_t>(target_point));
-  odpf.gen(ctx, ctrl);
+  SPU_ENFORCE(static_cast<int64_t>(aes_keys.size()) == num_ &&
+              static_cast<int64_t>(target_points.size()) == num_);
+
+  std::vector<std::unique_ptr<OramDpf>> odpfs;
+  std::vector<OramDpf *> odpf_ptrs;
+  for (int64_t k = 0; k < num_; k++) {
+    odpfs.push_back(std::make_unique<OramDpf>(
+        dpf_size_, yacl::crypto::SecureRandU128(), aes_keys[k],
+        static_cast<uint128_t>(target_points[k])));
+    odpf_ptrs.push_back(odpfs.back().get());
+  }
+  OramDpf::gen(ctx, ctrl, odpf_ptrs);
 
   auto dpf_rank = comm->getRank() == static_cast<size_t>(ctrl);
   int64_t dpf_idx = dpf_rank ? 0 : 1;
@@ -491,12 +546,15 @@ void OramContext<T>::genDpf(KernelEvalContext *ctx, DpfGenCtrl ctrl,
 
   // cast e and v to T type and convert v to arith
   // leave convert e outside
-  std::transform(odpf.final_e.begin(), odpf.final_e.begin() + dpf_size_,
-                 dpf_e[dpf_idx].begin(),
-                 [&](uint8_t x) { return neg_flag * static_cast<T>(x); });
-  std::transform(odpf.final_v.begin(), odpf.final_v.begin() + dpf_size_,
-                 convert_help_v[dpf_idx].begin(),
-                 [&](uint128_t x) { return neg_flag * static_cast<T>(x); });
+  for (int64_t k = 0; k < num_; k++) {
+    const auto &odpf = *odpfs[k];
+    std::transform(odpf.final_e.begin(), odpf.final_e.begin() + dpf_size_,
+                   dpf_e[dpf_idx].begin() + k * dpf_size_,
+                   [&](uint8_t x) { return neg_flag * static_cast<T>(x); });
+    std::transform(odpf.final_v.begin(), odpf.final_v.begin() + dpf_size_,
+                   convert_help_v[dpf_idx].begin() + k * dpf_size_,
+                   [&](uint128_t x) { return neg_flag * static_cast<T>(x); });
+  }
 };
 
 std::vector<DpfKeyT> OramDpf::lengthDoubling(
@@ -519,83 +577,124 @@ std::vector<DpfKeyT> OramDpf::lengthDoubling(
   return cipher_text;
 };
 
-void OramDpf::gen(KernelEvalContext *ctx, DpfGenCtrl ctrl) {
+void OramDpf::gen(KernelEvalContext *ctx, DpfGenCtrl ctrl,
+                  absl::Span<OramDpf *const> dpfs) {
   auto *comm = ctx->getState<Communicator>();
   auto dpf_rank = comm->getRank() == static_cast<size_t>(ctrl);
   size_t dst_rank = dpf_rank ? comm->prevRank() : comm->nextRank();
 
-  // generate 2*depth beaver triple
-  auto [a, b, c] = genOramBeaverPrim<DpfKeyT>(ctx, depth_ * 2, OpKind::And,
+  const auto num = static_cast<int64_t>(dpfs.size());
+  SPU_ENFORCE(num > 0);
+  const int64_t depth = dpfs[0]->depth_;
+  const int64_t numel = dpfs[0]->numel_;
+  for (const auto *dpf : dpfs) {
+    SPU_ENFORCE(dpf->numel_ == numel, "dpfs of a batch must share numel");
+  }
+
+  // generate 2*depth beaver triple per dpf
+  auto [a, b, c] = genOramBeaverPrim<DpfKeyT>(ctx, depth * 2 * num,
+                                              OpKind::And,
                                               static_cast<size_t>(ctrl));
-  // set lsb of root seed
-  root_seed_ = setLsb(root_seed_, dpf_rank ? 0 : 1);
-  // break target point into bit vectors
-  std::vector<DpfKeyT> target_point_bits =
-      bitDecomposeToDpfKeyT(target_point_, depth_);
-  std::vector<DpfKeyT> prev_v = {root_seed_};
-  std::vector<CorrectionFlagT> prev_e = {
-      static_cast<uint8_t>(dpf_rank ? 0 : 1)};
+
+  std::vector<std::vector<DpfKeyT>> target_point_bits(num);
+  std::vector<std::vector<DpfKeyT>> prev_v(num);
+  std::vector<std::vector<CorrectionFlagT>> prev_e(num);
+  for (int64_t k = 0; k < num; k++) {
+    auto *dpf = dpfs[k];
+    // set lsb of root seed
+    dpf->root_seed_ = setLsb(dpf->root_seed_, dpf_rank ? 0 : 1);
+    // break target point into bit vectors
+    target_point_bits[k] = bitDecomposeToDpfKeyT(dpf->target_point_, depth);
+    prev_v[k] = {dpf->root_seed_};
+    prev_e[k] = {static_cast<uint8_t>(dpf_rank ? 0 : 1)};
+  }
   int64_t half_layer_numel = 1;
 
-  for (int64_t l = 0; l < depth_; l++) {
+  std::vector<std::vector<DpfKeyT>> cur_v(num);
+  std::vector<DpfKeyT> layer_bits(num);
+  std::vector<DpfKeyT> sumL(num);
+  std::vector<DpfKeyT> sumR(num);
+  std::vector<std::array<DpfKeyT, 3>> oram_and_beaver_l(num);
+  std::vector<std::array<DpfKeyT, 3>> oram_and_beaver_r(num);
+  std::vector<CorrectionFlagT> cwt(num * 2);
+
+  for (int64_t l = 0; l < depth; l++) {
     // last layer, reduce keynum
-    if (l == depth_ - 1) {
-      half_layer_numel = numel_ / 2 + static_cast<int64_t>(numel_ % 2 != 0);
-      prev_v.resize(half_layer_numel);
+    if (l == depth - 1) {
+      half_layer_numel = numel / 2 + static_cast<int64_t>(numel % 2 != 0);
+      for (auto &v : prev_v) {
+        v.resize(half_layer_numel);
+      }
     }
-    // generate key on ith level, [2*i] for left child, [2*i+1] for right child
-    std::vector<DpfKeyT> cur_v(half_layer_numel * 2);
-    std::vector<CorrectionFlagT> cur_e(half_layer_numel * 2);
 
-    DpfKeyT sumL = 0;
-    DpfKeyT sumR = 0;
+    for (int64_t k = 0; k < num; k++) {
+      // generate key on ith level, [2*i] for left child, [2*i+1] for right
+      // child
+      cur_v[k] = dpfs[k]->lengthDoubling(prev_v[k]);
 
-    cur_v = lengthDoubling(prev_v);
+      sumL[k] = 0;
+      sumR[k] = 0;
+      for (int64_t i = 0; i < half_layer_numel; i++) {
+        sumL[k] ^= cur_v[k][2 * i];
+        sumR[k] ^= cur_v[k][2 * i + 1];
+      }
 
-    for (int64_t i = 0; i < half_layer_numel; i++) {
-      sumL ^= cur_v[2 * i];
-      sumR ^= cur_v[2 * i + 1];
+      const int64_t beaver_idx = (k * depth + l) * 2;
+      layer_bits[k] = target_point_bits[k][l];
+      oram_and_beaver_l[k] = {a[beaver_idx], b[beaver_idx], c[beaver_idx]};
+      oram_and_beaver_r[k] = {a[beaver_idx + 1], b[beaver_idx + 1],
+                              c[beaver_idx + 1]};
     }
 
     // compute (target_point_bits[i] & L) ^ (1 ^ target_point_bits[i] & R)
-    std::array<DpfKeyT, 3> oram_and_beaver_l = {a[l * 2], b[l * 2], c[l * 2]};
-    std::array<DpfKeyT, 3> oram_and_beaver_r = {a[l * 2 + 1], b[l * 2 + 1],
-                                                c[l * 2 + 1]};
-
-    cw[l] = computecw(ctx, target_point_bits[l], sumL, sumR, oram_and_beaver_l,
-                      oram_and_beaver_r, ctrl);
+    auto cw = computecw(ctx, layer_bits, sumL, sumR, oram_and_beaver_l,
+                        oram_and_beaver_r, ctrl);
 
-    std::vector<DpfKeyT> exchanged_cw = {cw[l]};
-    comm->sendAsync<DpfKeyT>(dst_rank, absl::MakeSpan(exchanged_cw), "open_cw");
-    exchanged_cw = comm->recv<DpfKeyT>(dst_rank, "open_cw");
-    cw[l] ^= exchanged_cw[0];
-
-    cwt[l][0] = getLsb(sumL) ^ getLsb(target_point_bits[l]);
-    cwt[l][1] = getLsb(sumR) ^ getLsb(target_point_bits[l]);
+    for (int64_t k = 0; k < num; k++) {
+      cwt[k * 2] = getLsb(sumL[k]) ^ getLsb(layer_bits[k]);
+      cwt[k * 2 + 1] = getLsb(sumR[k]) ^ getLsb(layer_bits[k]);
+    }
 
-    comm->sendAsync<CorrectionFlagT>(dst_rank, absl::MakeSpan(cwt[l]),
+    // cw and cwt are opened in the same round
+    comm->sendAsync<DpfKeyT>(dst_rank, absl::MakeSpan(cw), "open_cw");
+    comm->sendAsync<CorrectionFlagT>(dst_rank, absl::MakeSpan(cwt),
                                      "open_cwt");
-    auto exchanged_cwt = comm->recv<CorrectionFlagT>(dst_rank, "open_cwt");
-
-    cwt[l][0] ^= exchanged_cwt[0] ^ 1;
-    cwt[l][1] ^= exchanged_cwt[1];
+    auto exchanged_cw = comm->recvBuffer<DpfKeyT>(dst_rank, "open_cw");
+    auto exchanged_cwt =
+        comm->recvBuffer<CorrectionFlagT>(dst_rank, "open_cwt");
+
+    for (int64_t k = 0; k < num; k++) {
+      auto *dpf = dpfs[k];
+      dpf->cw[l] = cw[k] ^ exchanged_cw[k];
+      dpf->cwt[l][0] = cwt[k * 2] ^ exchanged_cwt[k * 2] ^ 1;
+      dpf->cwt[l][1] = cwt[k * 2 + 1] ^ exchanged_cwt[k * 2 + 1];
+
+      auto &v = cur_v[k];
+      const auto &pe = prev_e[k];
+      std::vector<CorrectionFlagT> cur_e(half_layer_numel * 2);
+      pforeach(0, half_layer_numel, [&](int64_t i) {
+        cur_e[i * 2] = getLsb(v[i * 2]) ^ (pe[i] & dpf->cwt[l][0]);
+        cur_e[i * 2 + 1] = getLsb(v[i * 2 + 1]) ^ (pe[i] & dpf->cwt[l][1]);
+        DpfKeyT extended_e = pe[i] == 0 ? 0 : -1;
+        v[i * 2] ^= extended_e & dpf->cw[l];
+        v[i * 2 + 1] ^= extended_e & dpf->cw[l];
+      });
 
-    pforeach(0, half_layer_numel, [&](int64_t i) {
-      cur_e[i * 2] = getLsb(cur_v[i * 2]) ^ (prev_e[i] & cwt[l][0]);
-      cur_e[i * 2 + 1] = getLsb(cur_v[i * 2 + 1]) ^ (prev_e[i] & cwt[l][1]);
-      DpfKeyT extended_e = prev_e[i] == 0 ? 0 : -1;
-      cur_v[i * 2] ^= extended_e & cw[l];
-      cur_v[i * 2 + 1] ^= extended_e & cw[l];
-    });
+      prev_e[k] = std::move(cur_e);
+      prev_v[k] = std::move(v);
+    }
 
     half_layer_numel *= 2;
-    prev_e.assign(cur_e.begin(), cur_e.end());
-    prev_v.assign(cur_v.begin(), cur_v.end());
   }
 
-  std::copy(prev_e.begin(), prev_e.begin() + numel_, final_e.begin());
-  // use v for conversion, instead of spliting to (int64, int64) in DUORAM
-  std::copy(prev_v.begin(), prev_v.begin() + numel_, final_v.begin());
+  for (int64_t k = 0; k < num; k++) {
+    auto *dpf = dpfs[k];
+    std::copy(prev_e[k].begin(), prev_e[k].begin() + numel,
+              dpf->final_e.begin());
+    // use v for conversion, instead of spliting to (int64, int64) in DUORAM
+    std::copy(prev_v[k].begin(), prev_v[k].begin() + numel,
+              dpf->final_v.begin());
+  }
 };
 
 }  // namespace spu::mpc::oram
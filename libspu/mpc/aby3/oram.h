@@ -53,9 +53,10 @@ class OramReadOA : public OramReadKernel {
   }
 
   ce::CExpr comm() const override {
-    // 1 * rotate: k
+    // 1 * rotate: k * m * n
+    auto m = ce::Variable("m", "number of onehots");
     auto n = ce::Variable("n", "cols of database");
-    return ce::K() * n;
+    return ce::K() * m * n;
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& onehot,
@@ -72,9 +73,10 @@ class OramReadOP : public OramReadKernel {
   }
 
   ce::CExpr comm() const override {
-    // 1 * rotate: k
+    // 1 * rotate: k * m * n
+    auto m = ce::Variable("m", "number of onehots");
     auto n = ce::Variable("n", "cols of database");
-    return ce::K() * n;
+    return ce::K() * m * n;
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& onehot,
@@ -117,8 +119,11 @@ class OramDpf {
                     aes_key, 1) {};
   // clang-format on
 
-  // genrate 2pc-dpf according to 'ctrl'
-  void gen(KernelEvalContext* ctx, DpfGenCtrl ctrl);
+  // genrate 2pc-dpfs according to 'ctrl', all dpfs must share numel. The
+  // dpfs walk the tree layer by layer together, so the rounds do not depend
+  // on the number of dpfs.
+  static void gen(KernelEvalContext* ctx, DpfGenCtrl ctrl,
+                  absl::Span<OramDpf* const> dpfs);
   std::vector<DpfKeyT> lengthDoubling(const std::vector<DpfKeyT>& input);
 
  private:
@@ -129,6 +134,8 @@ class OramDpf {
   yacl::crypto::SymmetricCrypto aes_crypto_;
 };
 
+// Holds `num` one-hot vectors of `dpf_size`, one-hot k lives in
+// [k * dpf_size, (k + 1) * dpf_size).
 template <typename T>
 class OramContext {
  public:
@@ -140,14 +147,16 @@ class OramContext {
   OramContext() = default;
 
   // clang-format off
-  explicit OramContext(int64_t dpf_size)
-      : dpf_e(2, std::vector<T>(dpf_size)),
-        convert_help_v(2, std::vector<T>(dpf_size)),
-        dpf_size_(dpf_size) {};
+  explicit OramContext(int64_t dpf_size, int64_t num = 1)
+      : dpf_e(2, std::vector<T>(dpf_size * num)),
+        convert_help_v(2, std::vector<T>(dpf_size * num)),
+        dpf_size_(dpf_size),
+        num_(num) {};
   // clang-format on
 
-  void genDpf(KernelEvalContext* ctx, DpfGenCtrl ctrl, uint128_t aes_key,
-              uint128_t target_point);
+  void genDpf(KernelEvalContext* ctx, DpfGenCtrl ctrl,
+              absl::Span<const uint128_t> aes_keys,
+              absl::Span<const uint128_t> target_points);
 
   // ref: Duoram: A Bandwidth-Efficient Distributed ORAM for 2- and 3-Party
   // Computation
@@ -157,6 +166,7 @@ class OramContext {
 
  private:
   int64_t dpf_size_;
+  int64_t num_;
 };
 
 std::pair<std::vector<uint128_t>, std::vector<uint128_t>> genAesKey(
@@ -99,6 +99,8 @@ void Ot3::send(const NdArrayRef& m0, const NdArrayRef& m1) {
   auto masked_m0 = ring_xor(m0, w0);
   auto masked_m1 = ring_xor(m1, w1);
 
+  // Both go to the receiver, one message when sends are coalesced.
+  Communicator::Epoch epoch(comm_);
   comm_->sendAsync(roles_.receiver, masked_m0, "m0");
   comm_->sendAsync(roles_.receiver, masked_m1, "m1");
 }
@@ -97,7 +97,7 @@ NdArrayRef PermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
         });
 
       } else if (comm->getRank() == 1) {
-        auto gama = comm->recv<el_t>(2, "gama");
+        auto gama = comm->recvBuffer<el_t>(2, "gama");
         std::vector<el_t> tmp(numel);
         std::vector<el_t> beta(numel);
 
@@ -114,11 +114,11 @@ NdArrayRef PermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
         pforeach(0, numel, [&](int64_t idx) { beta[idx] -= r0[idx]; });
 
         comm->sendAsync<el_t>(2, beta, "2to3");
-        tmp = comm->recv<el_t>(2, "2to3");
+        auto beta_2 = comm->recvBuffer<el_t>(2, "2to3");
 
         pforeach(0, numel, [&](int64_t idx) {
           _out[idx][0] = r0[idx];
-          _out[idx][1] = beta[idx] + tmp[idx];
+          _out[idx][1] = beta[idx] + beta_2[idx];
         });
 
       } else if (comm->getRank() == 2) {
@@ -128,7 +128,7 @@ NdArrayRef PermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
           gama[idx] = _in[_pv_next[idx]][0] + a1[idx];
         });
         comm->sendAsync<el_t>(1, gama, "gama");
-        auto delta = comm->recv<el_t>(0, "delta");
+        auto delta = comm->recvBuffer<el_t>(0, "delta");
         pforeach(0, numel,
                  [&](int64_t idx) { beta[idx] = delta[_pv_self[idx]]; });
 
@@ -140,7 +140,7 @@ NdArrayRef PermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
           beta[idx] -= r1[idx];
         });
         comm->sendAsync<el_t>(1, beta, "2to3");
-        auto tmp = comm->recv<el_t>(1, "2to3");
+        auto tmp = comm->recvBuffer<el_t>(1, "2to3");
 
         // rebuild the final result.
         pforeach(0, numel, [&](int64_t idx) {
@@ -208,7 +208,7 @@ NdArrayRef InvPermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
       if (comm->getRank() == 0) {
         std::vector<el_t> beta(numel);
         std::vector<el_t> tmp(numel);
-        auto gama = comm->recv<el_t>(2, "gama");
+        auto gama = comm->recvBuffer<el_t>(2, "gama");
 
         pforeach(0, numel, [&](int64_t idx) {
           tmp[_pv_next[idx]] = gama[idx] + a1[_pv_next[idx]];
@@ -224,11 +224,11 @@ NdArrayRef InvPermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
           beta[idx] -= r1[idx];
         });
         comm->sendAsync<el_t>(2, beta, "2to3");
-        tmp = comm->recv<el_t>(2, "2to3");
+        auto beta_2 = comm->recvBuffer<el_t>(2, "2to3");
 
         // rebuild the final result.
         pforeach(0, numel, [&](int64_t idx) {
-          _out[idx][0] = beta[idx] + tmp[idx];
+          _out[idx][0] = beta[idx] + beta_2[idx];
           _out[idx][1] = r1[idx];
         });
       } else if (comm->getRank() == 1) {
@@ -260,7 +260,7 @@ NdArrayRef InvPermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
           gama[_pv_self[idx]] = _in[idx][1] + a0[_pv_self[idx]];
         });
         comm->sendAsync<el_t>(0, gama, "gama");
-        auto delta = comm->recv<el_t>(1, "delta");
+        auto delta = comm->recvBuffer<el_t>(1, "delta");
         pforeach(0, numel,
                  [&](int64_t idx) { beta[_pv_next[idx]] = delta[idx]; });
 
@@ -273,7 +273,7 @@ NdArrayRef InvPermAM::proc(KernelEvalContext* ctx, const NdArrayRef& in,
         });
 
         comm->sendAsync<el_t>(0, beta, "2to3");
-        auto tmp = comm->recv<el_t>(0, "2to3");
+        auto tmp = comm->recvBuffer<el_t>(0, "2to3");
 
         pforeach(0, numel, [&](int64_t idx) {
           _out[idx][0] = r0[idx];
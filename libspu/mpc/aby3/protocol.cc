@@ -36,10 +36,14 @@ void regAby3Protocol(SPUContext* ctx,
   ctx->prot()->addState<Z2kState>(ctx->config().field());
 
   // add communicator
-  ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->addState<Communicator>(
+      lctx, ctx->config().experimental_enable_comm_coalescing());
+  ctx->prot()->getState<Communicator>()->setRecorder(
+      openCommTranscript(ctx->config(), *lctx));
 
   // register random states & kernels.
-  ctx->prot()->addState<PrgState>(lctx);
+  ctx->prot()->addState<PrgState>(
+      lctx, ctx->config().experimental_enable_prg_prefetch());
 
   // register public kernels.
   regPV2kKernels(ctx->prot());
@@ -53,7 +57,7 @@ void regAby3Protocol(SPUContext* ctx,
           aby3::P2A, aby3::V2A, aby3::A2P, aby3::A2V,           // Conversions
           aby3::B2P, aby3::P2B, aby3::A2B,                      // Conversion2
           aby3::B2ASelector, /*aby3::B2AByOT, aby3::B2AByPPA*/  // B2A
-          aby3::CastTypeB,                                      // Cast
+          aby3::CastTypeB, aby3::RingCastS,                     // Cast
           aby3::NegateA,                                        // Negate
           aby3::AddAP, aby3::AddAA,                             // Add
           aby3::MulAP, aby3::MulAA, aby3::MulA1B,               // Mul
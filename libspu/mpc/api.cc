@@ -262,6 +262,11 @@ Value cast_type_s(SPUContext* ctx, const Value& frm, const Type& to_type) {
   }
 }
 
+Value ring_cast_s(SPUContext* ctx, const Value& x, FieldType to_field) {
+  SPU_TRACE_MPC_DISP(ctx, x);
+  FORCE_DISPATCH(ctx, x, makeType<RingTy>(to_field));
+}
+
 Value make_p(SPUContext* ctx, uint128_t init, const Shape& shape) {
   FORCE_DISPATCH(ctx, init, shape);
 }
@@ -324,8 +329,9 @@ Value msb_s(SPUContext* ctx, const Value& x) {
   SPU_TRACE_MPC_DISP(ctx, x);
   TRY_DISPATCH(ctx, x);
 
-  // TODO: this is buggy.
-  const auto field = ctx->getField();
+  // TODO: this is buggy for BShare.
+  const auto field = IsA(x) ? x.storage_type().as<Ring2k>()->field()
+                            : ctx->getField();
 
   if (ctx->hasKernel("msb_a2b")) {
     if (IsB(x)) {
@@ -82,6 +82,13 @@ Type common_type_s(SPUContext* ctx, const Type& a, const Type& b);
 Type common_type_v(SPUContext* ctx, const Type& a, const Type& b);
 Value cast_type_s(SPUContext* ctx, const Value& frm, const Type& to_type);
 
+// Move a secret to another ring, locally.
+//
+// Narrowing keeps the low bits of each share, which preserves the value only
+// when it is representable on the target ring. Widening is only supported for
+// BShare, which zero-extends each share.
+Value ring_cast_s(SPUContext* ctx, const Value& x, FieldType to_field);
+
 // Make a public variable with given plaintext input.
 //
 // All parties knowns the value.
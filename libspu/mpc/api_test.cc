@@ -273,6 +273,57 @@ TEST_P(ApiTest, MsbS) {
   });
 }
 
+TEST_P(ApiTest, RingCastS) {
+  const auto factory = std::get<0>(GetParam());
+  const RuntimeConfig& conf = std::get<1>(GetParam());
+  const size_t npc = std::get<2>(GetParam());
+
+  if (conf.field() == FieldType::FM32) {
+    return;
+  }
+  const auto to_field =
+      conf.field() == FieldType::FM128 ? FieldType::FM64 : FieldType::FM32;
+  const size_t to_bits = SizeOf(to_field) * 8;
+
+  utils::simulate(npc, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+    auto sctx = factory(conf, lctx);
+    if (!sctx->hasKernel("ring_cast_s")) {
+      return;
+    }
+
+    // Random values that fit the narrow ring, plus both ends of its range.
+    auto r_p = arshift_p(sctx.get(), rand_p(sctx.get(), kShape),
+                         {static_cast<int64_t>(SizeOf(conf.field()) * 8 -
+                                               to_bits)});
+    auto arr = r_p.data().clone();
+    DISPATCH_ALL_FIELDS(conf.field(), [&]() {
+      NdArrayView<ring2k_t> _arr(arr);
+      const auto max = (ring2k_t(1) << (to_bits - 1)) - 1;
+      _arr[0] = max;
+      _arr[1] = max - 1;
+      _arr[2] = ~max;
+      _arr[3] = ~max + 1;
+      _arr[4] = ~ring2k_t(0);
+      _arr[5] = 0;
+      _arr[6] = 1;
+    });
+    Value x_p(arr, r_p.dtype());
+    auto x_s = p2s(sctx.get(), x_p);
+
+    /* WHEN */
+    auto n_s = ring_cast_s(sctx.get(), x_s, to_field);
+    auto m_s = ring_cast_s(sctx.get(), msb_s(sctx.get(), n_s), conf.field());
+
+    /* THEN */
+    EXPECT_EQ(n_s.storage_type().as<Ring2k>()->field(), to_field);
+    auto n_p = s2p(sctx.get(), n_s);
+    EXPECT_TRUE(ring_all_equal(n_p.data().as(makeType<RingTy>(to_field)),
+                               ring_cast(x_p.data(), to_field)));
+    // The msb on the narrow ring is the sign on the full ring.
+    EXPECT_VALUE_EQ(s2p(sctx.get(), m_s), msb_p(sctx.get(), x_p));
+  });
+}
+
 #define TEST_UNARY_OP_WITH_BIT_S(OP)                                          \
   TEST_P(ApiTest, OP##S) {                                                    \
     const auto factory = std::get<0>(GetParam());                             \
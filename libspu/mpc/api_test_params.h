@@ -14,9 +14,15 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
+#include <string_view>
+
+#include "fmt/format.h"
 #include "yacl/link/link.h"
 
 #include "libspu/core/context.h"
+#include "libspu/mpc/utils/network_emulator.h"
 
 namespace spu::mpc::test {
 
@@ -40,4 +46,42 @@ using CreateObjectFn = NamedFunction<std::unique_ptr<SPUContext>(
 
 using OpTestParams = std::tuple<CreateObjectFn, RuntimeConfig, size_t>;
 
+// Creates objects whose links are emulated by `network`, so any protocol suite
+// can be instantiated under a LAN or WAN profile, e.g.
+//   withNetwork(CreateObjectFn(makeSemi2kProtocol, "tfp"),
+//               utils::NetworkProfile::parse("wan"), "wan")
+// The name gets `label` appended. Parties of the same world size share one
+// emulated world across tests.
+inline CreateObjectFn withNetwork(const CreateObjectFn& fn,
+                                  const utils::NetworkProfile& network,
+                                  std::string_view label) {
+  const auto name = fmt::format("{}_{}", fn.name(), label);
+  if (!network.enabled()) {
+    return CreateObjectFn(fn, name);
+  }
+
+  struct Worlds {
+    std::mutex mutex;
+    std::map<size_t, std::shared_ptr<utils::EmulatedNetwork>> by_size;
+  };
+  auto worlds = std::make_shared<Worlds>();
+  return CreateObjectFn(
+      [fn, network, worlds](const RuntimeConfig& conf,
+                            const std::shared_ptr<yacl::link::Context>& lctx) {
+        std::shared_ptr<utils::EmulatedNetwork> world;
+        {
+          std::lock_guard<std::mutex> guard(worlds->mutex);
+          auto& entry = worlds->by_size[lctx->WorldSize()];
+          if (entry == nullptr) {
+            entry = std::make_shared<utils::EmulatedNetwork>(
+                network, lctx->WorldSize());
+          }
+          world = entry;
+        }
+        utils::EmulatedNetwork::Scope scope(world);
+        return fn(conf, lctx);
+      },
+      name);
+}
+
 }  // namespace spu::mpc::test
@@ -37,6 +37,8 @@ void regCheetahProtocol(SPUContext* ctx,
 
   // add communicator
   ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->getState<Communicator>()->setRecorder(
+      openCommTranscript(ctx->config(), *lctx));
 
   // register random states & kernels.
   ctx->prot()->addState<PrgState>(lctx);
@@ -0,0 +1,159 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/common/comm_profiler.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+#include "libspu/core/bit_utils.h"
+
+namespace spu::mpc {
+namespace {
+
+using CounterMap = std::map<std::string, CommCounter, std::less<>>;
+
+CounterMap subtract(const CounterMap& lhs, const CounterMap& rhs) {
+  CounterMap res;
+  for (const auto& [key, counter] : lhs) {
+    const auto itr = rhs.find(key);
+    auto diff = itr == rhs.end() ? counter : counter - itr->second;
+    if (diff.msgs != 0 || diff.bytes != 0 || diff.rounds != 0) {
+      res.emplace(key, diff);
+    }
+  }
+  return res;
+}
+
+std::string formatHistogram(const CommCounter& counter) {
+  std::string res;
+  for (size_t idx = 0; idx < CommCounter::kNumBuckets; idx++) {
+    if (counter.size_hist[idx] == 0) {
+      continue;
+    }
+    const size_t upper = size_t(1) << idx;
+    if (idx == 0) {
+      res += fmt::format(" 0:{}", counter.size_hist[idx]);
+    } else if (idx + 1 == CommCounter::kNumBuckets) {
+      res += fmt::format(" >={}:{}", upper / 2, counter.size_hist[idx]);
+    } else {
+      res += fmt::format(" <{}:{}", upper, counter.size_hist[idx]);
+    }
+  }
+  return res;
+}
+
+void appendSection(std::string* out, std::string_view title,
+                   const CounterMap& counters) {
+  std::vector<const CounterMap::value_type*> sorted;
+  for (const auto& item : counters) {
+    sorted.push_back(&item);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->second.bytes > rhs->second.bytes;
+  });
+
+  *out += fmt::format("{}:\n", title);
+  for (const auto* item : sorted) {
+    const auto& counter = item->second;
+    *out += fmt::format("- {}, bytes {}, rounds {}, msgs {}, sizes{}\n",
+                        item->first.empty() ? "<none>" : item->first,
+                        counter.bytes, counter.rounds, counter.msgs,
+                        formatHistogram(counter));
+  }
+}
+
+}  // namespace
+
+size_t CommCounter::getBucket(size_t msg_bytes) {
+  if (msg_bytes == 0) {
+    return 0;
+  }
+  return std::min<size_t>(Log2Floor(msg_bytes) + 1, kNumBuckets - 1);
+}
+
+CommCounter& CommCounter::operator+=(const CommCounter& rhs) {
+  bytes += rhs.bytes;
+  rounds += rhs.rounds;
+  msgs += rhs.msgs;
+  for (size_t idx = 0; idx < kNumBuckets; idx++) {
+    size_hist[idx] += rhs.size_hist[idx];
+  }
+  return *this;
+}
+
+CommCounter CommCounter::operator-(const CommCounter& rhs) const {
+  CommCounter res = *this;
+  res.bytes -= rhs.bytes;
+  res.rounds -= rhs.rounds;
+  res.msgs -= rhs.msgs;
+  for (size_t idx = 0; idx < kNumBuckets; idx++) {
+    res.size_hist[idx] -= rhs.size_hist[idx];
+  }
+  return res;
+}
+
+CommProfile CommProfile::operator-(const CommProfile& rhs) const {
+  return {subtract(by_tag, rhs.by_tag), subtract(by_kernel, rhs.by_kernel)};
+}
+
+CommCounter CommProfile::total() const {
+  CommCounter res;
+  for (const auto& [_, counter] : by_tag) {
+    res += counter;
+  }
+  return res;
+}
+
+std::vector<std::string> CommProfile::getTinyMessageHotSpots(
+    size_t min_msgs, size_t max_avg_bytes) const {
+  std::vector<std::string> res;
+  for (const auto& [tag, counter] : by_tag) {
+    if (counter.msgs >= min_msgs &&
+        counter.bytes <= counter.msgs * max_avg_bytes) {
+      res.push_back(tag);
+    }
+  }
+  return res;
+}
+
+std::string CommProfile::toString() const {
+  std::string res;
+  appendSection(&res, "Communication by kernel", by_kernel);
+  appendSection(&res, "Communication by tag", by_tag);
+  return res;
+}
+
+void CommProfiler::add(std::string_view kernel, std::string_view tag,
+                       const CommCounter& counter) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto add_to = [&](CounterMap& counters, std::string_view key) {
+    auto itr = counters.find(key);
+    if (itr == counters.end()) {
+      itr = counters.emplace(std::string(key), CommCounter()).first;
+    }
+    itr->second += counter;
+  };
+  add_to(profile_.by_tag, tag);
+  add_to(profile_.by_kernel, kernel);
+}
+
+CommProfile CommProfiler::snapshot() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return profile_;
+}
+
+}  // namespace spu::mpc
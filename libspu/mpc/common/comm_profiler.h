@@ -0,0 +1,81 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spu::mpc {
+
+// Communication of one tag or one kernel.
+struct CommCounter {
+  // Message sizes by power of two, bucket 0 holds empty messages and bucket i
+  // sizes in [2^(i-1), 2^i), the last one everything larger.
+  static constexpr size_t kNumBuckets = 34;
+
+  // Same definitions as Communicator::Stats.
+  size_t bytes = 0;
+  size_t rounds = 0;
+  size_t msgs = 0;
+  std::array<size_t, kNumBuckets> size_hist = {};
+
+  static size_t getBucket(size_t msg_bytes);
+
+  CommCounter& operator+=(const CommCounter& rhs);
+  CommCounter operator-(const CommCounter& rhs) const;
+};
+
+// A snapshot of CommProfiler, differences of snapshots give the breakdown of
+// a period.
+struct CommProfile {
+  std::map<std::string, CommCounter, std::less<>> by_tag;
+  std::map<std::string, CommCounter, std::less<>> by_kernel;
+
+  CommProfile operator-(const CommProfile& rhs) const;
+
+  CommCounter total() const;
+
+  // Tags that send many messages of at most `max_avg_bytes` on average. Their
+  // cost is per message overhead, they are candidates for coalescing.
+  std::vector<std::string> getTinyMessageHotSpots(size_t min_msgs = 1000,
+                                                  size_t max_avg_bytes = 64)
+      const;
+
+  // Multi line report, tags and kernels sorted by bytes.
+  std::string toString() const;
+};
+
+// Breakdown of the communication by tag and by the innermost kernel that was
+// running, shared by a Communicator and all of its forks so parallel runs add
+// up in one place. Thread safe.
+class CommProfiler {
+ public:
+  void add(std::string_view kernel, std::string_view tag,
+           const CommCounter& counter);
+
+  CommProfile snapshot() const;
+
+ private:
+  mutable std::mutex mutex_;
+  CommProfile profile_;
+};
+
+}  // namespace spu::mpc
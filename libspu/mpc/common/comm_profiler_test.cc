@@ -0,0 +1,86 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/common/comm_profiler.h"
+
+#include "gtest/gtest.h"
+
+namespace spu::mpc {
+
+namespace {
+
+CommCounter makeMessage(size_t bytes) {
+  CommCounter counter;
+  counter.bytes = bytes;
+  counter.rounds = 1;
+  counter.msgs = 1;
+  counter.size_hist[CommCounter::getBucket(bytes)] = 1;
+  return counter;
+}
+
+}  // namespace
+
+TEST(CommProfiler, Bucket) {
+  EXPECT_EQ(CommCounter::getBucket(0), 0U);
+  EXPECT_EQ(CommCounter::getBucket(1), 1U);
+  EXPECT_EQ(CommCounter::getBucket(2), 2U);
+  EXPECT_EQ(CommCounter::getBucket(3), 2U);
+  EXPECT_EQ(CommCounter::getBucket(1024), 11U);
+  EXPECT_EQ(CommCounter::getBucket(~size_t(0)), CommCounter::kNumBuckets - 1);
+}
+
+TEST(CommProfiler, Snapshot) {
+  CommProfiler profiler;
+  profiler.add("mul_aa", "mul", makeMessage(800));
+  const auto before = profiler.snapshot();
+
+  profiler.add("mul_aa", "mul", makeMessage(800));
+  profiler.add("a2b", "ppa", makeMessage(8));
+  profiler.add("a2b", "mul", makeMessage(16));
+  const auto diff = profiler.snapshot() - before;
+
+  ASSERT_EQ(diff.by_tag.size(), 2U);
+  EXPECT_EQ(diff.by_tag.at("mul").bytes, 816U);
+  EXPECT_EQ(diff.by_tag.at("mul").msgs, 2U);
+  EXPECT_EQ(diff.by_tag.at("mul").size_hist[CommCounter::getBucket(800)], 1U);
+  EXPECT_EQ(diff.by_tag.at("ppa").rounds, 1U);
+  EXPECT_EQ(diff.by_kernel.at("mul_aa").bytes, 800U);
+  EXPECT_EQ(diff.by_kernel.at("a2b").msgs, 2U);
+
+  const auto total = diff.total();
+  EXPECT_EQ(total.bytes, 824U);
+  EXPECT_EQ(total.msgs, 3U);
+
+  const auto report = diff.toString();
+  EXPECT_NE(report.find("mul_aa"), std::string::npos);
+  EXPECT_NE(report.find("ppa"), std::string::npos);
+}
+
+TEST(CommProfiler, TinyMessageHotSpots) {
+  CommProfiler profiler;
+  for (int i = 0; i < 2000; i++) {
+    profiler.add("a2b", "tiny", makeMessage(4));
+    profiler.add("a2b", "mixed", makeMessage(4));
+    profiler.add("a2b", "large", makeMessage(1024));
+    if (i >= 10) {
+      profiler.add("a2b", "mixed", makeMessage(1 << 20));
+    }
+  }
+
+  const auto hot = profiler.snapshot().getTinyMessageHotSpots();
+  ASSERT_EQ(hot.size(), 1U);
+  EXPECT_EQ(hot[0], "tiny");
+}
+
+}  // namespace spu::mpc
@@ -14,6 +14,15 @@
 
 #include "libspu/mpc/common/communicator.h"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "libspu/core/bit_utils.h"
+#include "libspu/core/context.h"
 #include "libspu/mpc/utils/gfmp_ops.h"
 #include "libspu/mpc/utils/ring_ops.h"
 
@@ -35,50 +44,565 @@ NdArrayRef getOrCreateCompactArray(const NdArrayRef& in) {
   return in;
 }
 
+// Number of bits of every element that go through the wire, boolean shares
+// only carry their low nbits.
+size_t getWireNbits(const Type& eltype) {
+  const size_t width = eltype.size() * 8;
+  if (eltype.isa<BShare>() && eltype.isa<Ring2k>() &&
+      eltype.size() == SizeOf(eltype.as<Ring2k>()->field())) {
+    const size_t nbits = eltype.as<BShare>()->nbits();
+    if (nbits > 0 && nbits < width) {
+      return nbits;
+    }
+  }
+  return width;
+}
+
+// Ring and tree collectives trade rounds for bandwidth, below this payload the
+// single round of a plain gather is faster.
+constexpr size_t kBandwidthOptimalMinBytes = 1024 * 1024;
+
+// Flat element range of segment `idx % world_size` in the ring collectives.
+std::pair<int64_t, int64_t> getSegment(int64_t numel, size_t world_size,
+                                       size_t idx) {
+  const int64_t n = static_cast<int64_t>(world_size);
+  const int64_t i = static_cast<int64_t>(idx % world_size);
+  return {numel * i / n, numel * (i + 1) / n};
+}
+
+void reduceInplace(ReduceOp op, NdArrayRef& acc, const NdArrayRef& arr) {
+  if (op == ReduceOp::ADD) {
+    if (acc.eltype().isa<GfmpTy>()) {
+      gfmp_add_mod_(acc, arr);
+    } else {
+      ring_add_(acc, arr);
+    }
+  } else if (op == ReduceOp::XOR) {
+    ring_xor_(acc, arr);
+  } else {
+    SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
+  }
+}
+
+// Elements per streamed chunk, a multiple of 8 so packed chunks stay byte
+// aligned and their sizes add up to the size of the whole packed array.
+int64_t getChunkNumel(int64_t elsize, int64_t chunk_bytes) {
+  SPU_ENFORCE(chunk_bytes > 0, "invalid chunk_bytes={}", chunk_bytes);
+  return std::max<int64_t>(chunk_bytes / elsize / 8, 1) * 8;
+}
+
+// Elements are coded in groups of 8, which always start on a byte boundary.
+constexpr int64_t kGroupSize = 8;
+
+// Bits move in chunks of at most 32, so the 64 bit accumulator never
+// overflows.
+constexpr size_t kChunkBits = 32;
+
+void loadElement(const uint8_t* src, size_t elsize, uint64_t words[2]) {
+  words[0] = words[1] = 0;
+  std::memcpy(words, src, elsize);
+}
+
+// Tag of the link messages that carry coalesced batches.
+constexpr std::string_view kBatchTag = "comm.batch";
+
+// A batch is a sequence of records
+//   [u32 tag size][tag][u64 payload size][payload]
+template <typename T>
+void appendPod(std::string* out, T v) {
+  out->append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+T readPod(const uint8_t*& pos, const uint8_t* end) {
+  SPU_ENFORCE(pos + sizeof(T) <= end, "truncated batch");
+  T v;
+  std::memcpy(&v, pos, sizeof(T));
+  pos += sizeof(T);
+  return v;
+}
+
+std::vector<yacl::ByteContainerView> viewsOf(
+    const std::vector<yacl::Buffer>& bufs) {
+  std::vector<yacl::ByteContainerView> res;
+  for (const auto& buf : bufs) {
+    res.emplace_back(buf.data<uint8_t>(), buf.size());
+  }
+  return res;
+}
+
+NdArrayRef unpackArray(const yacl::Buffer& buf, const Type& eltype,
+                       const Shape& shape, size_t nbits) {
+  NdArrayRef res(eltype, shape);
+  wire::unpack(buf, eltype.size(), shape.numel(), nbits, res.data());
+  return res;
+}
+
 }  // namespace
 
+namespace wire {
+
+size_t packedSize(int64_t numel, size_t nbits) {
+  return (numel * nbits + 7) / 8;
+}
+
+yacl::Buffer pack(const void* in, size_t elsize, int64_t numel, size_t nbits) {
+  SPU_ENFORCE(elsize <= 16 && nbits > 0 && nbits <= elsize * 8,
+              "elsize={}, nbits={}", elsize, nbits);
+  yacl::Buffer buf(packedSize(numel, nbits));
+  const auto* src = static_cast<const uint8_t*>(in);
+  auto* dst = buf.data<uint8_t>();
+
+  if (nbits == elsize * 8) {
+    std::memcpy(dst, src, buf.size());
+    return buf;
+  }
+
+  if (nbits % 8 == 0) {
+    const size_t nbytes = nbits / 8;
+    pforeach(0, numel, [&](int64_t idx) {
+      std::memcpy(dst + idx * nbytes, src + idx * elsize, nbytes);
+    });
+    return buf;
+  }
+
+  const int64_t num_groups = (numel + kGroupSize - 1) / kGroupSize;
+  pforeach(0, num_groups, [&](int64_t begin, int64_t end) {
+    // A group of 8 elements takes exactly nbits bytes.
+    uint8_t* out = dst + begin * nbits;
+    uint64_t acc = 0;
+    size_t filled = 0;
+    for (int64_t idx = begin * kGroupSize;
+         idx < std::min(end * kGroupSize, numel); ++idx) {
+      uint64_t words[2];
+      loadElement(src + idx * elsize, elsize, words);
+      for (size_t bit = 0; bit < nbits; bit += kChunkBits) {
+        const size_t n = std::min(kChunkBits, nbits - bit);
+        const uint64_t chunk =
+            (words[bit / 64] >> (bit % 64)) & ((uint64_t(1) << n) - 1);
+        acc |= chunk << filled;
+        filled += n;
+        while (filled >= 8) {
+          *out++ = static_cast<uint8_t>(acc);
+          acc >>= 8;
+          filled -= 8;
+        }
+      }
+    }
+    if (filled > 0) {
+      *out = static_cast<uint8_t>(acc);
+    }
+  });
+  return buf;
+}
+
+void unpack(const yacl::Buffer& in, size_t elsize, int64_t numel, size_t nbits,
+            void* out) {
+  SPU_ENFORCE(elsize <= 16 && nbits > 0 && nbits <= elsize * 8,
+              "elsize={}, nbits={}", elsize, nbits);
+  SPU_ENFORCE(static_cast<size_t>(in.size()) == packedSize(numel, nbits),
+              "packed size mismatch, got={}, numel={}, nbits={}", in.size(),
+              numel, nbits);
+  const auto* src = in.data<uint8_t>();
+  auto* dst = static_cast<uint8_t*>(out);
+
+  if (nbits == elsize * 8) {
+    std::memcpy(dst, src, in.size());
+    return;
+  }
+
+  if (nbits % 8 == 0) {
+    const size_t nbytes = nbits / 8;
+    pforeach(0, numel, [&](int64_t idx) {
+      std::memcpy(dst + idx * elsize, src + idx * nbytes, nbytes);
+      std::memset(dst + idx * elsize + nbytes, 0, elsize - nbytes);
+    });
+    return;
+  }
+
+  const int64_t num_groups = (numel + kGroupSize - 1) / kGroupSize;
+  pforeach(0, num_groups, [&](int64_t begin, int64_t end) {
+    const uint8_t* pos = src + begin * nbits;
+    uint64_t acc = 0;
+    size_t filled = 0;
+    for (int64_t idx = begin * kGroupSize;
+         idx < std::min(end * kGroupSize, numel); ++idx) {
+      uint64_t words[2] = {0, 0};
+      for (size_t bit = 0; bit < nbits; bit += kChunkBits) {
+        const size_t n = std::min(kChunkBits, nbits - bit);
+        while (filled < n) {
+          acc |= static_cast<uint64_t>(*pos++) << filled;
+          filled += 8;
+        }
+        words[bit / 64] |= (acc & ((uint64_t(1) << n) - 1)) << (bit % 64);
+        acc >>= n;
+        filled -= n;
+      }
+      std::memcpy(dst + idx * elsize, words, elsize);
+    }
+  });
+}
+
+}  // namespace wire
+
+Communicator::Communicator(std::shared_ptr<yacl::link::Context> lctx,
+                           bool coalescing)
+    : Communicator(std::move(lctx), coalescing,
+                   std::make_shared<CommProfiler>(), nullptr, nullptr,
+                   utils::EmulatedNetwork::current(), "") {}
+
+Communicator::Communicator(std::shared_ptr<yacl::link::Context> lctx,
+                           std::shared_ptr<utils::CommTranscriptReader> replay,
+                           bool coalescing)
+    : Communicator(std::move(lctx), coalescing,
+                   std::make_shared<CommProfiler>(), nullptr,
+                   std::move(replay), nullptr, "") {
+  SPU_ENFORCE(replay_ != nullptr);
+  SPU_ENFORCE(replay_->rank() == getRank() &&
+                  replay_->worldSize() == getWorldSize(),
+              "transcript of rank {} in {} parties, got rank {} in {}",
+              replay_->rank(), replay_->worldSize(), getRank(),
+              getWorldSize());
+}
+
+Communicator::Communicator(
+    std::shared_ptr<yacl::link::Context> lctx, bool coalescing,
+    std::shared_ptr<CommProfiler> profiler,
+    std::shared_ptr<utils::CommTranscriptWriter> recorder,
+    std::shared_ptr<utils::CommTranscriptReader> replay,
+    std::shared_ptr<utils::EmulatedNetwork> network, std::string channel)
+    : profiler_(std::move(profiler)),
+      lctx_(std::move(lctx)),
+      coalescing_(coalescing),
+      network_(std::move(network)),
+      channel_(std::move(channel)),
+      recorder_(std::move(recorder)),
+      replay_(std::move(replay)) {}
+
+std::unique_ptr<State> Communicator::fork() {
+  // Stats stay per fork so the costs of a kernel can be told apart, the
+  // profile is shared. Forks are numbered in creation order, which a replay
+  // has to follow.
+  return std::unique_ptr<Communicator>(new Communicator(
+      lctx_->Spawn(), coalescing_, profiler_, recorder_, replay_, network_,
+      fmt::format("{}/{}", channel_, num_forks_++)));
+}
+
+void Communicator::addCost(std::string_view tag, size_t latency, size_t comm) {
+  stats_.latency += latency;
+  stats_.comm += comm;
+
+  CommCounter counter;
+  counter.rounds = latency;
+  counter.bytes = comm;
+  profiler_->add(getCurrentKernelName(), tag, counter);
+}
+
+void Communicator::addMessage(std::string_view tag, size_t bytes) {
+  CommCounter counter;
+  counter.msgs = 1;
+  counter.size_hist[CommCounter::getBucket(bytes)] = 1;
+  profiler_->add(getCurrentKernelName(), tag, counter);
+}
+
+void Communicator::sendPhysical(size_t dst_rank, yacl::ByteContainerView bv,
+                                std::string_view tag) {
+  if (replay_) {
+    const auto bufs =
+        replay_->next(channel_, utils::CommEvent::kSend, dst_rank, tag);
+    SPU_ENFORCE(bufs.size() == 1 &&
+                    static_cast<size_t>(bufs[0].size()) == bv.size(),
+                "transcript diverged on channel '{}', send of {} bytes to {}",
+                channel_, bv.size(), dst_rank);
+    return;
+  }
+  record(utils::CommEvent::kSend, dst_rank, tag, {bv});
+
+  // The deadline is booked before the message can be received.
+  if (network_) {
+    network_->send(lctx_->Id(), getRank(), dst_rank, tag, bv.size());
+  }
+  lctx_->SendAsync(dst_rank, bv, tag);
+}
+
+yacl::Buffer Communicator::recvPhysical(size_t src_rank, std::string_view tag) {
+  if (replay_) {
+    auto bufs =
+        replay_->next(channel_, utils::CommEvent::kRecv, src_rank, tag);
+    SPU_ENFORCE(bufs.size() == 1);
+    return std::move(bufs[0]);
+  }
+
+  auto buf = lctx_->Recv(src_rank, tag);
+  if (network_) {
+    network_->recv(lctx_->Id(), src_rank, getRank(), tag);
+  }
+  record(utils::CommEvent::kRecv, src_rank, tag,
+         {yacl::ByteContainerView(buf.data<uint8_t>(), buf.size())});
+  return buf;
+}
+
+std::vector<yacl::Buffer> Communicator::allGatherBytes(
+    yacl::ByteContainerView bv, std::string_view tag) {
+  addMessage(tag, bv.size());
+  if (replay_) {
+    return replay_->next(channel_, utils::CommEvent::kCollective,
+                         utils::kNoPeer, tag);
+  }
+  flush();
+  auto bufs = yacl::link::AllGather(lctx_, bv, tag);
+  emulateCollective(bv.size() * (getWorldSize() - 1));
+  record(utils::CommEvent::kCollective, utils::kNoPeer, tag, viewsOf(bufs));
+  return bufs;
+}
+
+std::vector<yacl::Buffer> Communicator::gatherBytes(yacl::ByteContainerView bv,
+                                                    size_t root,
+                                                    std::string_view tag) {
+  addMessage(tag, bv.size());
+  if (replay_) {
+    return replay_->next(channel_, utils::CommEvent::kCollective, root, tag);
+  }
+  flush();
+  auto bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  emulateCollective(bv.size() * (getRank() == root ? getWorldSize() - 1 : 1));
+  record(utils::CommEvent::kCollective, root, tag, viewsOf(bufs));
+  return bufs;
+}
+
+yacl::Buffer Communicator::broadcastBytes(yacl::ByteContainerView bv,
+                                          size_t root, std::string_view tag) {
+  addMessage(tag, bv.size());
+  if (replay_) {
+    auto bufs =
+        replay_->next(channel_, utils::CommEvent::kCollective, root, tag);
+    SPU_ENFORCE(bufs.size() == 1);
+    return std::move(bufs[0]);
+  }
+  flush();
+  auto buf = yacl::link::Broadcast(lctx_, bv, root, tag);
+  emulateCollective(getRank() == root ? bv.size() * (getWorldSize() - 1)
+                                      : buf.size());
+  record(utils::CommEvent::kCollective, root, tag,
+         {yacl::ByteContainerView(buf.data<uint8_t>(), buf.size())});
+  return buf;
+}
+
+void Communicator::sendBytes(size_t dst_rank, yacl::ByteContainerView bv,
+                             std::string_view tag) {
+  stats_.logical_msgs += 1;
+  addMessage(tag, bv.size());
+  if (!coalescing_) {
+    stats_.physical_msgs += 1;
+    sendPhysical(dst_rank, bv, tag);
+    return;
+  }
+
+  auto& batch = outbox_[dst_rank];
+  appendPod(&batch, static_cast<uint32_t>(tag.size()));
+  batch.append(tag);
+  appendPod(&batch, static_cast<uint64_t>(bv.size()));
+  batch.append(reinterpret_cast<const char*>(bv.data()), bv.size());
+
+  if (epoch_depth_ == 0) {
+    flush();
+  }
+}
+
+void Communicator::flush() {
+  for (auto& [dst_rank, batch] : outbox_) {
+    if (batch.empty()) {
+      continue;
+    }
+    stats_.physical_msgs += 1;
+    sendPhysical(dst_rank, {batch.data(), batch.size()}, kBatchTag);
+    batch.clear();
+  }
+}
+
+yacl::Buffer Communicator::recvBytes(size_t src_rank, std::string_view tag) {
+  if (!coalescing_) {
+    return recvPhysical(src_rank, tag);
+  }
+
+  // This party is about to wait, peers may be waiting for us as well.
+  flush();
+
+  const auto key = std::make_pair(src_rank, std::string(tag));
+  while (true) {
+    auto itr = inbox_.find(key);
+    if (itr != inbox_.end() && !itr->second.empty()) {
+      auto buf = std::move(itr->second.front());
+      itr->second.pop_front();
+      return buf;
+    }
+
+    // Demultiplex the next batch of this peer by tag.
+    auto batch = recvPhysical(src_rank, kBatchTag);
+    const auto* pos = batch.data<uint8_t>();
+    const auto* end = pos + batch.size();
+    while (pos < end) {
+      const auto tag_size = readPod<uint32_t>(pos, end);
+      SPU_ENFORCE(pos + tag_size <= end, "truncated batch");
+      std::string msg_tag(reinterpret_cast<const char*>(pos), tag_size);
+      pos += tag_size;
+      const auto size = readPod<uint64_t>(pos, end);
+      SPU_ENFORCE(pos + size <= end, "truncated batch");
+      inbox_[{src_rank, std::move(msg_tag)}].emplace_back(pos, size);
+      pos += size;
+    }
+  }
+}
+
 NdArrayRef Communicator::allReduce(ReduceOp op, const NdArrayRef& in,
                                    std::string_view tag) {
+  const size_t nbits = getWireNbits(in.eltype());
+  const bool packed = nbits < in.elsize() * 8;
+  const size_t world_size = getWorldSize();
+
+  if (!packed && world_size > 2 && in.numel() >= int64_t(world_size) &&
+      in.numel() * in.elsize() >= kBandwidthOptimalMinBytes) {
+    auto acc = in.clone().reshape({in.numel()});
+    size_t sent = ringReduceScatter(op, acc, tag);
+
+    // All-gather, pass the fully reduced segments around the ring.
+    const size_t rank = getRank();
+    const int64_t elsize = in.elsize();
+    auto* data = acc.data<std::byte>();
+    for (size_t step = 0; step + 1 < world_size; step++) {
+      const auto [send_begin, send_end] =
+          getSegment(in.numel(), world_size, rank + world_size - step);
+      const auto [recv_begin, recv_end] =
+          getSegment(in.numel(), world_size, rank + world_size - step - 1);
+      sendBytes(lctx_->NextRank(),
+                {reinterpret_cast<uint8_t const*>(data + send_begin * elsize),
+                 static_cast<size_t>((send_end - send_begin) * elsize)},
+                tag);
+      auto buf = recvBytes(lctx_->PrevRank(), tag);
+      SPU_ENFORCE(buf.size() == (recv_end - recv_begin) * elsize);
+      std::memcpy(data + recv_begin * elsize, buf.data(), buf.size());
+      sent += (send_end - send_begin) * elsize;
+    }
+
+    addCost(tag, 2 * (world_size - 1), sent);
+    return acc.reshape(in.shape());
+  }
+
   const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             in.numel() * in.elsize());
-  std::vector<yacl::Buffer> bufs = yacl::link::AllGather(lctx_, bv, tag);
+  yacl::Buffer wire_buf;
+  if (packed) {
+    wire_buf = wire::pack(array.data(), in.elsize(), in.numel(), nbits);
+  }
+  yacl::ByteContainerView bv =
+      packed ? yacl::ByteContainerView(wire_buf.data<uint8_t>(),
+                                       wire_buf.size())
+             : yacl::ByteContainerView(
+                   reinterpret_cast<uint8_t const*>(array.data()),
+                   in.numel() * in.elsize());
+  std::vector<yacl::Buffer> bufs = allGatherBytes(bv, tag);
 
   SPU_ENFORCE(bufs.size() == getWorldSize());
-  auto res = in.clone();
+  // Start from the local share as the peers see it, so the high bits agree.
+  auto res = packed ? unpackArray(wire_buf, in.eltype(), in.shape(), nbits)
+                    : in.clone();
   for (size_t idx = 0; idx < bufs.size(); idx++) {
     if (idx == getRank()) {
       continue;
     }
 
-    auto arr = NdArrayRef(stealBuffer(std::move(bufs[idx])), in.eltype(),
-                          in.shape(), makeCompactStrides(in.shape()), kOffset);
-    if (op == ReduceOp::ADD) {
-      if (in.eltype().isa<GfmpTy>()) {
-        gfmp_add_mod_(res, arr);
-      } else {
-        ring_add_(res, arr);
-      }
-    } else if (op == ReduceOp::XOR) {
-      ring_xor_(res, arr);
-    } else {
-      SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
-    }
+    auto arr = packed ? unpackArray(bufs[idx], in.eltype(), in.shape(), nbits)
+                      : NdArrayRef(stealBuffer(std::move(bufs[idx])),
+                                   in.eltype(), in.shape(),
+                                   makeCompactStrides(in.shape()), kOffset);
+    reduceInplace(op, res, arr);
   }
 
-  stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize() * (lctx_->WorldSize() - 1);
+  addCost(tag, 1, bv.size() * (lctx_->WorldSize() - 1));
 
   return res;
 }
 
+size_t Communicator::ringReduceScatter(ReduceOp op, NdArrayRef& acc,
+                                       std::string_view tag) {
+  const size_t world_size = getWorldSize();
+  const size_t rank = getRank();
+  const int64_t numel = acc.numel();
+  const int64_t elsize = acc.elsize();
+
+  // Segment i starts at party i + 1 and collects one more share at every hop,
+  // after N-1 steps it is fully reduced at party i.
+  size_t sent = 0;
+  for (size_t step = 0; step + 1 < world_size; step++) {
+    const auto [send_begin, send_end] =
+        getSegment(numel, world_size, rank + 2 * world_size - step - 1);
+    const auto [recv_begin, recv_end] =
+        getSegment(numel, world_size, rank + 2 * world_size - step - 2);
+    sendBytes(lctx_->NextRank(),
+              {acc.data<uint8_t>() + send_begin * elsize,
+               static_cast<size_t>((send_end - send_begin) * elsize)},
+              tag);
+    sent += (send_end - send_begin) * elsize;
+
+    auto buf = recvBytes(lctx_->PrevRank(), tag);
+    const int64_t n = recv_end - recv_begin;
+    SPU_ENFORCE(buf.size() == n * elsize);
+    auto segment = acc.slice({recv_begin}, {recv_end}, {1});
+    reduceInplace(op, segment,
+                  NdArrayRef(stealBuffer(std::move(buf)), acc.eltype(), {n},
+                             {1}, kOffset));
+  }
+  return sent;
+}
+
+NdArrayRef Communicator::reduceScatter(ReduceOp op, const NdArrayRef& in,
+                                       std::string_view tag) {
+  SPU_ENFORCE(getWireNbits(in.eltype()) == in.elsize() * 8,
+              "packed shares are not supported, type={}", in.eltype());
+  auto acc = in.clone().reshape({in.numel()});
+  const size_t sent = ringReduceScatter(op, acc, tag);
+
+  addCost(tag, getWorldSize() - 1, sent);
+
+  const auto [begin, end] = getSegment(in.numel(), getWorldSize(), getRank());
+  return acc.slice({begin}, {end}, {1});
+}
+
 NdArrayRef Communicator::reduce(ReduceOp op, const NdArrayRef& in, size_t root,
                                 std::string_view tag) {
   SPU_ENFORCE(root < lctx_->WorldSize());
+  const size_t world_size = getWorldSize();
+
+  if (world_size >= 4 &&
+      in.numel() * in.elsize() >= kBandwidthOptimalMinBytes) {
+    // Binomial tree on ranks relative to root, at round k a party with bit k
+    // set hands its partial sum down and leaves.
+    const size_t rel = (getRank() + world_size - root) % world_size;
+    auto acc = in.clone();
+    for (size_t mask = 1; mask < world_size; mask <<= 1) {
+      if ((rel & mask) != 0) {
+        sendBytes((rel - mask + root) % world_size,
+                  {acc.data<uint8_t>(),
+                   static_cast<size_t>(acc.numel() * acc.elsize())},
+                  tag);
+        addCost(tag, 0, acc.numel() * acc.elsize());
+        break;
+      }
+      if (rel + mask < world_size) {
+        auto buf = recvBytes((rel + mask + root) % world_size, tag);
+        reduceInplace(op, acc,
+                      NdArrayRef(stealBuffer(std::move(buf)), in.eltype(),
+                                 in.shape(), makeCompactStrides(in.shape()),
+                                 kOffset));
+      }
+    }
+    addCost(tag, Log2Ceil(world_size), 0);
+    return getRank() == root ? acc : in.clone();
+  }
+
   const auto array = getOrCreateCompactArray(in);
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
                              in.numel() * in.elsize());
-  std::vector<yacl::Buffer> bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  std::vector<yacl::Buffer> bufs = gatherBytes(bv, root, tag);
 
   auto res = in.clone();
   if (getRank() == root) {
@@ -90,35 +614,34 @@ NdArrayRef Communicator::reduce(ReduceOp op, const NdArrayRef& in, size_t root,
       auto arr =
           NdArrayRef(stealBuffer(std::move(bufs[idx])), in.eltype(), in.shape(),
                      makeCompactStrides(in.shape()), kOffset);
-      if (op == ReduceOp::ADD) {
-        if (in.eltype().isa<GfmpTy>()) {
-          gfmp_add_mod_(res, arr);
-        } else {
-          ring_add_(res, arr);
-        }
-      } else if (op == ReduceOp::XOR) {
-        ring_xor_(res, arr);
-      } else {
-        SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
-      }
+      reduceInplace(op, res, arr);
     }
   }
-  stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize();
+  addCost(tag, 1, in.numel() * in.elsize());
 
   return res;
 }
 
 NdArrayRef Communicator::rotate(const NdArrayRef& in, std::string_view tag) {
+  const size_t nbits = getWireNbits(in.eltype());
   const auto array = getOrCreateCompactArray(in);
+  if (nbits < in.elsize() * 8) {
+    auto buf = wire::pack(array.data(), in.elsize(), in.numel(), nbits);
+    addCost(tag, 1, buf.size());
+
+    sendBytes(lctx_->PrevRank(),
+              {buf.data<uint8_t>(), static_cast<size_t>(buf.size())}, tag);
+    auto res_buf = recvBytes(lctx_->NextRank(), tag);
+    return unpackArray(res_buf, in.eltype(), in.shape(), nbits);
+  }
+
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
                              in.numel() * in.elsize());
-  lctx_->SendAsync(lctx_->PrevRank(), bv, tag);
+  sendBytes(lctx_->PrevRank(), bv, tag);
 
-  auto res_buf = lctx_->Recv(lctx_->NextRank(), tag);
+  auto res_buf = recvBytes(lctx_->NextRank(), tag);
 
-  stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize();
+  addCost(tag, 1, in.numel() * in.elsize());
 
   return NdArrayRef(stealBuffer(std::move(res_buf)), in.eltype(), in.shape(),
                     makeCompactStrides(in.shape()), kOffset);
@@ -129,10 +652,9 @@ std::vector<NdArrayRef> Communicator::gather(const NdArrayRef& in, size_t root,
   const auto array = getOrCreateCompactArray(in);
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
                              array.numel() * array.elsize());
-  auto bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  auto bufs = gatherBytes(bv, root, tag);
 
-  stats_.latency += 1;
-  stats_.comm += array.numel() * array.elsize();
+  addCost(tag, 1, array.numel() * array.elsize());
 
   auto res = std::vector<NdArrayRef>(getWorldSize());
   if (root == getRank()) {
@@ -149,22 +671,21 @@ std::vector<NdArrayRef> Communicator::gather(const NdArrayRef& in, size_t root,
 NdArrayRef Communicator::broadcast(const NdArrayRef& in, size_t root,
                                    const Type& eltype, const Shape& shape,
                                    std::string_view tag) {
-  stats_.latency += 1;
-  stats_.comm += in.elsize() * in.numel();
+  addCost(tag, 1, in.elsize() * in.numel());
 
   yacl::Buffer buf;
   if (lctx_->Rank() == root) {
     const auto array = getOrCreateCompactArray(in);
     yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
                                array.elsize() * array.numel());
-    auto buf = yacl::link::Broadcast(lctx_, bv, root, tag);
+    auto buf = broadcastBytes(bv, root, tag);
     return NdArrayRef(stealBuffer(std::move(buf)), in.eltype(), in.shape(),
                       makeCompactStrides(in.shape()), kOffset);
   } else {
     // for yacl::link::Broadcast need a legal ByteContainerView
     // But the data is not actually used
     std::array<uint8_t, 1> dummy;
-    auto buf = yacl::link::Broadcast(lctx_, dummy, root, tag);
+    auto buf = broadcastBytes(dummy, root, tag);
     SPU_ENFORCE(static_cast<size_t>(buf.size()) ==
                 shape.numel() * eltype.size());
     return NdArrayRef(stealBuffer(std::move(buf)), eltype, shape,
@@ -177,15 +698,121 @@ void Communicator::sendAsync(size_t dst_rank, const NdArrayRef& in,
   const auto array = getOrCreateCompactArray(in);
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
                              in.numel() * in.elsize());
-  lctx_->SendAsync(dst_rank, bv, tag);
+  sendBytes(dst_rank, bv, tag);
 }
 
 NdArrayRef Communicator::recv(size_t src_rank, const Type& eltype,
                               std::string_view tag) {
-  auto buf = lctx_->Recv(src_rank, tag);
+  auto buf = recvBytes(src_rank, tag);
 
   int64_t numel = buf.size() / eltype.size();
   return NdArrayRef(stealBuffer(std::move(buf)), eltype, {numel}, {1}, kOffset);
 }
 
+size_t Communicator::sendChunks(size_t dst_rank, const NdArrayRef& in,
+                                std::string_view tag, int64_t chunk_bytes) {
+  const size_t nbits = getWireNbits(in.eltype());
+  const bool packed = nbits < in.elsize() * 8;
+  const int64_t elsize = in.elsize();
+  const int64_t numel = in.numel();
+  const int64_t chunk_numel = getChunkNumel(elsize, chunk_bytes);
+
+  // Staging buffer for one chunk of a strided input.
+  std::vector<std::byte> staging;
+  if (!in.isCompact()) {
+    staging.resize(std::min(chunk_numel, numel) * elsize);
+  }
+
+  size_t sent = 0;
+  for (int64_t begin = 0; begin < numel; begin += chunk_numel) {
+    const int64_t n = std::min(chunk_numel, numel - begin);
+
+    const std::byte* src = nullptr;
+    if (in.isCompact()) {
+      src = static_cast<const std::byte*>(in.data()) + begin * elsize;
+    } else {
+      pforeach(0, n, [&](int64_t b, int64_t e) {
+        NdArrayRef::Iterator itr(in, begin + b);
+        for (int64_t idx = b; idx < e; ++idx, ++itr) {
+          std::memcpy(staging.data() + idx * elsize, itr.getRawPtr(), elsize);
+        }
+      });
+      src = staging.data();
+    }
+
+    if (packed) {
+      auto buf = wire::pack(src, elsize, n, nbits);
+      sendBytes(dst_rank,
+                {buf.data<uint8_t>(), static_cast<size_t>(buf.size())}, tag);
+      sent += buf.size();
+    } else {
+      sendBytes(dst_rank,
+                {reinterpret_cast<uint8_t const*>(src),
+                 static_cast<size_t>(n * elsize)},
+                tag);
+      sent += n * elsize;
+    }
+  }
+  return sent;
+}
+
+void Communicator::recvChunks(size_t src_rank, const Type& eltype,
+                              int64_t numel, std::string_view tag,
+                              const ChunkConsumer& consumer,
+                              int64_t chunk_bytes) {
+  const size_t nbits = getWireNbits(eltype);
+  const bool packed = nbits < eltype.size() * 8;
+  const int64_t chunk_numel = getChunkNumel(eltype.size(), chunk_bytes);
+
+  for (int64_t begin = 0; begin < numel; begin += chunk_numel) {
+    const int64_t n = std::min(chunk_numel, numel - begin);
+    auto buf = recvBytes(src_rank, tag);
+    if (packed) {
+      consumer(begin, unpackArray(buf, eltype, {n}, nbits));
+    } else {
+      SPU_ENFORCE(static_cast<size_t>(buf.size()) == n * eltype.size(),
+                  "chunk size mismatch, got={}, expect={}", buf.size(),
+                  n * eltype.size());
+      consumer(begin, NdArrayRef(stealBuffer(std::move(buf)), eltype, {n}, {1},
+                                 kOffset));
+    }
+  }
+}
+
+void Communicator::rotateStream(const NdArrayRef& in, std::string_view tag,
+                                const ChunkConsumer& consumer,
+                                int64_t chunk_bytes) {
+  // Every chunk is on its way before the first one is waited for, the
+  // consumer then runs while the tail is still in flight.
+  const size_t sent = sendChunks(lctx_->PrevRank(), in, tag, chunk_bytes);
+  recvChunks(lctx_->NextRank(), in.eltype(), in.numel(), tag, consumer,
+             chunk_bytes);
+
+  addCost(tag, 1, sent);
+}
+
+void Communicator::sendAsyncStream(size_t dst_rank, const NdArrayRef& in,
+                                   std::string_view tag, int64_t chunk_bytes) {
+  sendChunks(dst_rank, in, tag, chunk_bytes);
+}
+
+void Communicator::recvStream(size_t src_rank, const Type& eltype,
+                              int64_t numel, std::string_view tag,
+                              const ChunkConsumer& consumer,
+                              int64_t chunk_bytes) {
+  recvChunks(src_rank, eltype, numel, tag, consumer, chunk_bytes);
+}
+
+std::shared_ptr<utils::CommTranscriptWriter> openCommTranscript(
+    const RuntimeConfig& conf, const yacl::link::Context& lctx) {
+  if (conf.experimental_comm_transcript_prefix().empty()) {
+    return nullptr;
+  }
+  return std::make_shared<utils::CommTranscriptWriter>(
+      fmt::format("{}.{}", conf.experimental_comm_transcript_prefix(),
+                  lctx.Rank()),
+      lctx.Rank(), lctx.WorldSize(),
+      !conf.experimental_comm_transcript_size_only());
+}
+
 }  // namespace spu::mpc
\ No newline at end of file
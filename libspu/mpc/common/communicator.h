@@ -15,6 +15,10 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <type_traits>
@@ -30,18 +34,84 @@
 #include "libspu/core/object.h"
 #include "libspu/core/parallel_utils.h"
 #include "libspu/core/prelude.h"
+#include "libspu/mpc/common/comm_profiler.h"
+#include "libspu/mpc/utils/comm_transcript.h"
+#include "libspu/mpc/utils/network_emulator.h"
+#include "libspu/spu.pb.h"
 
 // This module defines the protocol comm pattern used for all
 // protocols.
 
 namespace spu::mpc {
 
+// Wire codec of narrow values, only the low `nbits` of every `elsize` bytes
+// little endian element are sent, densely packed into a bit stream.
+namespace wire {
+
+size_t packedSize(int64_t numel, size_t nbits);
+
+yacl::Buffer pack(const void* in, size_t elsize, int64_t numel, size_t nbits);
+
+// The high bits of every unpacked element are zero.
+void unpack(const yacl::Buffer& in, size_t elsize, int64_t numel, size_t nbits,
+            void* out);
+
+}  // namespace wire
+
 enum class ReduceOp {
   INVALID = 0,
   ADD = 1,
   XOR = 2,
 };
 
+// Elements received by the typed Communicator APIs. It takes over the
+// received buffer instead of copying the elements out, copies share the
+// buffer like NdArrayRef does.
+template <typename T>
+class CommBuffer {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  CommBuffer() = default;
+
+  explicit CommBuffer(yacl::Buffer&& buf)
+      : buf_(std::make_shared<yacl::Buffer>(std::move(buf))) {
+    SPU_ENFORCE(buf_->size() % sizeof(T) == 0,
+                "buffer size {} is not a multiple of element size {}",
+                buf_->size(), sizeof(T));
+  }
+
+  size_t size() const { return buf_ ? buf_->size() / sizeof(T) : 0; }
+
+  bool empty() const { return size() == 0; }
+
+  T* data() { return buf_ ? buf_->data<T>() : nullptr; }
+  const T* data() const { return buf_ ? buf_->data<T>() : nullptr; }
+
+  T& operator[](size_t idx) { return data()[idx]; }
+  const T& operator[](size_t idx) const { return data()[idx]; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size(); }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size(); }
+
+  operator absl::Span<T const>() const { return {data(), size()}; }
+
+  // The elements as a compact array of `shape`, sharing the buffer.
+  NdArrayRef asNdArray(const Type& eltype, const Shape& shape) const {
+    SPU_ENFORCE(buf_ != nullptr, "nothing received");
+    SPU_ENFORCE(static_cast<size_t>(eltype.size()) == sizeof(T),
+                "type {} does not match element size {}", eltype, sizeof(T));
+    SPU_ENFORCE(shape.numel() == static_cast<int64_t>(size()),
+                "shape {} does not match {} received elements", shape, size());
+    return NdArrayRef(buf_, eltype, shape, makeCompactStrides(shape), 0);
+  }
+
+ private:
+  std::shared_ptr<yacl::Buffer> buf_;
+};
+
 // yacl::link does not make assumption on data types, (it works on buffer),
 // which means it's hard to write algorithms which depends on data arithmetics
 // like reduce/AllReduce.
@@ -62,35 +132,184 @@ class Communicator : public State {
     // TODO(jint) add formal definition for asymmetric algorithms.
     size_t comm = 0;
 
+    // Point to point messages issued by protocols, and messages actually
+    // written to the link. They differ when sends are coalesced.
+    size_t logical_msgs = 0;
+    size_t physical_msgs = 0;
+
     Stats operator-(const Stats& rhs) const {
-      return {latency - rhs.latency, comm - rhs.comm};
+      return {latency - rhs.latency, comm - rhs.comm,
+              logical_msgs - rhs.logical_msgs,
+              physical_msgs - rhs.physical_msgs};
     }
   };
 
+  // Called with the received chunks of a streamed array in order. `chunk` is a
+  // compact 1-d array holding flat elements [offset, offset + chunk.numel())
+  // of the peer's array.
+  using ChunkConsumer =
+      std::function<void(int64_t offset, const NdArrayRef& chunk)>;
+
+  static constexpr int64_t kDefaultChunkBytes = 4 * 1024 * 1024;
+
+  // Holds back point to point sends of a burst. Inside an epoch, messages to
+  // the same peer leave as one framed batch right before this party blocks on
+  // a receive or a collective, or when the outermost epoch ends. Every kernel
+  // dispatch runs in an epoch. Without coalescing enabled it does nothing.
+  class Epoch {
+   public:
+    explicit Epoch(Communicator* comm) : comm_(comm) { ++comm_->epoch_depth_; }
+    ~Epoch() {
+      if (--comm_->epoch_depth_ == 0) {
+        comm_->flush();
+      }
+    }
+
+    Epoch(const Epoch&) = delete;
+    Epoch& operator=(const Epoch&) = delete;
+
+   private:
+    Communicator* comm_;
+  };
+
  private:
   mutable Stats stats_;
 
+  // Shared with all forks.
+  std::shared_ptr<CommProfiler> profiler_;
+
+  // Charges `latency` rounds and `comm` bytes to stats_ and the profiler.
+  void addCost(std::string_view tag, size_t latency, size_t comm);
+
+  // Counts one message of `bytes` in the profiler.
+  void addMessage(std::string_view tag, size_t bytes);
+
   const std::shared_ptr<yacl::link::Context> lctx_;
 
+  // With coalescing, every point to point message is framed with its tag and
+  // travels inside a batch, the peers must agree on this flag.
+  const bool coalescing_ = false;
+  int64_t epoch_depth_ = 0;
+  std::map<size_t, std::string> outbox_;
+  std::map<std::pair<size_t, std::string>, std::deque<yacl::Buffer>> inbox_;
+
+  // Set when this party runs in an emulated world, shared with all forks.
+  std::shared_ptr<utils::EmulatedNetwork> network_;
+
+  // Transcript of this communicator and its forks, by channel. A replaying
+  // communicator takes every message from replay_ and never touches lctx_.
+  std::string channel_;
+  size_t num_forks_ = 0;
+  std::shared_ptr<utils::CommTranscriptWriter> recorder_;
+  std::shared_ptr<utils::CommTranscriptReader> replay_;
+
+  Communicator(std::shared_ptr<yacl::link::Context> lctx, bool coalescing,
+               std::shared_ptr<CommProfiler> profiler,
+               std::shared_ptr<utils::CommTranscriptWriter> recorder,
+               std::shared_ptr<utils::CommTranscriptReader> replay,
+               std::shared_ptr<utils::EmulatedNetwork> network,
+               std::string channel);
+
+  void record(utils::CommEvent event, size_t peer, std::string_view tag,
+              absl::Span<const yacl::ByteContainerView> bufs) {
+    if (recorder_) {
+      recorder_->append(channel_, event, peer, tag, bufs);
+    }
+  }
+
+  void sendPhysical(size_t dst_rank, yacl::ByteContainerView bv,
+                    std::string_view tag);
+
+  yacl::Buffer recvPhysical(size_t src_rank, std::string_view tag);
+
+  // Charges a collective that went through yacl::link directly, `bytes` is
+  // what passed this party's link.
+  void emulateCollective(int64_t bytes) {
+    if (network_) {
+      network_->delay(getRank(), bytes);
+    }
+  }
+
+  // yacl::link collectives, pending batches go out first and the transfer is
+  // emulated, recorded or replayed.
+  std::vector<yacl::Buffer> allGatherBytes(yacl::ByteContainerView bv,
+                                           std::string_view tag);
+
+  std::vector<yacl::Buffer> gatherBytes(yacl::ByteContainerView bv,
+                                        size_t root, std::string_view tag);
+
+  yacl::Buffer broadcastBytes(yacl::ByteContainerView bv, size_t root,
+                              std::string_view tag);
+
+  void sendBytes(size_t dst_rank, yacl::ByteContainerView bv,
+                 std::string_view tag);
+
+  yacl::Buffer recvBytes(size_t src_rank, std::string_view tag);
+
+  // Runs the ring reduce-scatter in place on the compact flat array `acc`,
+  // returns the number of bytes put on the wire.
+  size_t ringReduceScatter(ReduceOp op, NdArrayRef& acc,
+                           std::string_view tag);
+
+  // Returns the number of bytes put on the wire.
+  size_t sendChunks(size_t dst_rank, const NdArrayRef& in,
+                    std::string_view tag, int64_t chunk_bytes);
+
+  void recvChunks(size_t src_rank, const Type& eltype, int64_t numel,
+                  std::string_view tag, const ChunkConsumer& consumer,
+                  int64_t chunk_bytes);
+
  public:
-  explicit Communicator(std::shared_ptr<yacl::link::Context> lctx)
-      : lctx_(std::move(lctx)) {}
+  explicit Communicator(std::shared_ptr<yacl::link::Context> lctx,
+                        bool coalescing = false);
+
+  // Replays one party offline, e.g. to profile its computation alone. Every
+  // message comes from `replay`, recorded by a party of the same rank with the
+  // same coalescing. `lctx` only provides the rank, world size and forks, e.g.
+  //   auto lctx = yacl::link::test::SetupWorld(reader->worldSize())[rank];
+  // Without recorded payloads, received bytes are zero.
+  Communicator(std::shared_ptr<yacl::link::Context> lctx,
+               std::shared_ptr<utils::CommTranscriptReader> replay,
+               bool coalescing = false);
 
   bool hasLowCostFork() const override { return true; }
 
-  std::unique_ptr<State> fork() override {
-    // TODO: share the same statistics.
-    return std::make_unique<Communicator>(lctx_->Spawn());
+  std::unique_ptr<State> fork() override;
+
+  // Every dispatched kernel is an epoch.
+  void beginKernel() override { ++epoch_depth_; }
+  void endKernel() override {
+    if (--epoch_depth_ == 0) {
+      flush();
+    }
+  }
+
+  // Raw users of the link may block, pending batches go out first.
+  const std::shared_ptr<yacl::link::Context>& lctx() {
+    SPU_ENFORCE(replay_ == nullptr, "raw link traffic can not be replayed");
+    flush();
+    return lctx_;
+  }
+
+  // Records this communicator and forks created afterwards to `recorder`.
+  void setRecorder(std::shared_ptr<utils::CommTranscriptWriter> recorder) {
+    recorder_ = std::move(recorder);
   }
 
-  const std::shared_ptr<yacl::link::Context>& lctx() { return lctx_; }
+  bool isCoalescing() const { return coalescing_; }
+
+  // Writes all pending batches to the link.
+  void flush();
 
+  // Costs of this communicator alone, forks count their own.
   Stats getStats() const { return stats_; }
 
+  // Costs of this communicator and all forks of its root, by tag and kernel.
+  CommProfile getProfile() const { return profiler_->snapshot(); }
+
   // only use when you're 100% sure what you are doing
   void addCommStatsManually(size_t latency, size_t comm) {
-    stats_.latency += latency;
-    stats_.comm += comm;
+    addCost("", latency, comm);
   }
 
   size_t getWorldSize() const { return lctx_->WorldSize(); }
@@ -101,14 +320,25 @@ class Communicator : public State {
 
   size_t nextRank() const { return lctx_->NextRank(); }
 
+  // Large payloads among more than two parties go through a ring
+  // reduce-scatter and all-gather, every party then sends 2(N-1)/N copies of
+  // the array in 2(N-1) rounds instead of N-1 copies in one round.
   NdArrayRef allReduce(ReduceOp op, const NdArrayRef& in, std::string_view tag);
 
+  // Ring reduce-scatter over the flattened array, returns this party's
+  // reduced segment, i.e. flat elements [numel * rank / N,
+  // numel * (rank + 1) / N) as a compact 1-d array.
+  NdArrayRef reduceScatter(ReduceOp op, const NdArrayRef& in,
+                           std::string_view tag);
+
   std::vector<NdArrayRef> gather(const NdArrayRef& in, size_t root,
                                  std::string_view tag);
 
   NdArrayRef broadcast(const NdArrayRef& in, size_t root, const Type& eltype,
                        const Shape& shape, std::string_view tag);
 
+  // Large payloads among four or more parties are reduced along a binomial
+  // tree, so the root receives log2(N) arrays instead of N-1.
   NdArrayRef reduce(ReduceOp op, const NdArrayRef& in, size_t root,
                     std::string_view tag);
 
@@ -118,6 +348,23 @@ class Communicator : public State {
 
   NdArrayRef recv(size_t src_rank, const Type& eltype, std::string_view tag);
 
+  // Streaming variants for very large arrays. The flattened array goes out in
+  // chunks of about `chunk_bytes`, each gathered straight from `in` so strided
+  // inputs are never compacted as a whole, and the receiver hands every chunk
+  // to `consumer` as soon as it arrives. Both ends must use the same
+  // `chunk_bytes`.
+  void rotateStream(const NdArrayRef& in, std::string_view tag,
+                    const ChunkConsumer& consumer,
+                    int64_t chunk_bytes = kDefaultChunkBytes);
+
+  void sendAsyncStream(size_t dst_rank, const NdArrayRef& in,
+                       std::string_view tag,
+                       int64_t chunk_bytes = kDefaultChunkBytes);
+
+  void recvStream(size_t src_rank, const Type& eltype, int64_t numel,
+                  std::string_view tag, const ChunkConsumer& consumer,
+                  int64_t chunk_bytes = kDefaultChunkBytes);
+
   template <typename T>
   std::vector<T> rotate(absl::Span<T const> in, std::string_view tag);
 
@@ -130,6 +377,25 @@ class Communicator : public State {
   template <typename T, template <typename> typename FN>
   std::vector<T> allReduce(absl::Span<T const> in, std::string_view tag);
 
+  // Bit packed variants, only the low `nbits` of every element go through the
+  // wire and the high bits of the results are zero. Boolean share arrays get
+  // the same treatment in the NdArrayRef APIs above from their type's nbits.
+  template <typename T>
+  std::vector<T> rotate(absl::Span<T const> in, size_t nbits,
+                        std::string_view tag);
+
+  template <typename T>
+  void sendAsync(size_t dst_rank, absl::Span<T const> in, size_t nbits,
+                 std::string_view tag);
+
+  template <typename T>
+  std::vector<T> recv(size_t src_rank, int64_t numel, size_t nbits,
+                      std::string_view tag);
+
+  template <typename T, template <typename> typename FN>
+  std::vector<T> allReduce(absl::Span<T const> in, size_t nbits,
+                           std::string_view tag);
+
   // TODO: test me
   template <typename T>
   std::vector<T> bcast(absl::Span<T const> in, size_t root,
@@ -138,18 +404,36 @@ class Communicator : public State {
   template <typename T>
   std::vector<std::vector<T>> gather(absl::Span<T const> in, size_t root,
                                      std::string_view tag);
+
+  // Zero copy variants of recv, bcast and gather above, the results take over
+  // the received buffers. Parties other than `root` get no gathered buffers.
+  template <typename T>
+  CommBuffer<T> recvBuffer(size_t src_rank, std::string_view tag);
+
+  template <typename T>
+  CommBuffer<T> bcastBuffer(absl::Span<T const> in, size_t root,
+                            std::string_view tag);
+
+  template <typename T>
+  std::vector<CommBuffer<T>> gatherBuffers(absl::Span<T const> in, size_t root,
+                                           std::string_view tag);
 };
 
+// Opens the transcript `conf` asks this party to record, see
+// RuntimeConfig.experimental_comm_transcript_prefix. Returns null when it asks
+// for none.
+std::shared_ptr<utils::CommTranscriptWriter> openCommTranscript(
+    const RuntimeConfig& conf, const yacl::link::Context& lctx);
+
 template <typename T>
 std::vector<T> Communicator::rotate(absl::Span<T const> in,
                                     std::string_view tag) {
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
                              sizeof(T) * in.size());
-  lctx_->SendAsync(lctx_->PrevRank(), bv, tag);
-  auto buf = lctx_->Recv(lctx_->NextRank(), tag);
+  sendBytes(lctx_->PrevRank(), bv, tag);
+  auto buf = recvBytes(lctx_->NextRank(), tag);
 
-  stats_.latency += 1;
-  stats_.comm += in.size() * sizeof(T);
+  addCost(tag, 1, in.size() * sizeof(T));
 
   SPU_ENFORCE(buf.size() == static_cast<int64_t>(sizeof(T) * in.size()));
   return std::vector<T>(buf.data<T>(), buf.data<T>() + in.size());
@@ -160,16 +444,13 @@ void Communicator::sendAsync(size_t dst_rank, absl::Span<T const> in,
                              std::string_view tag) {
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
                              sizeof(T) * in.size());
-  lctx_->SendAsync(dst_rank, bv, tag);
+  sendBytes(dst_rank, bv, tag);
 }
 
 template <typename T>
 std::vector<T> Communicator::recv(size_t src_rank, std::string_view tag) {
-  auto buf = lctx_->Recv(src_rank, tag);
-  SPU_ENFORCE(buf.size() % sizeof(T) == 0);
-  auto numel = buf.size() / sizeof(T);
-  // TODO: use a container which memory could be stolen.
-  return std::vector<T>(buf.data<T>(), buf.data<T>() + numel);
+  const auto buf = recvBuffer<T>(src_rank, tag);
+  return std::vector<T>(buf.begin(), buf.end());
 }
 
 template <typename T, template <typename> typename FN>
@@ -177,7 +458,7 @@ std::vector<T> Communicator::allReduce(absl::Span<T const> in,
                                        std::string_view tag) {
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
                              sizeof(T) * in.size());
-  std::vector<yacl::Buffer> bufs = yacl::link::AllGather(lctx_, bv, tag);
+  std::vector<yacl::Buffer> bufs = allGatherBytes(bv, tag);
   SPU_ENFORCE(bufs.size() == getWorldSize());
 
   std::vector<T> res(in.size(), 0);
@@ -188,45 +469,121 @@ std::vector<T> Communicator::allReduce(absl::Span<T const> in,
     });
   }
 
-  stats_.latency += 1;
-  stats_.comm += in.size() * sizeof(T) * (lctx_->WorldSize() - 1);
+  addCost(tag, 1, in.size() * sizeof(T) * (lctx_->WorldSize() - 1));
 
   return res;
 }
 
 template <typename T>
-std::vector<T> Communicator::bcast(absl::Span<T const> in, size_t root,
-                                   std::string_view tag) {
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
-                             sizeof(T) * in.size());
-  yacl::Buffer buf = yacl::link::Broadcast(lctx_, bv, root, tag);
+std::vector<T> Communicator::rotate(absl::Span<T const> in, size_t nbits,
+                                    std::string_view tag) {
+  SPU_ENFORCE(nbits > 0 && nbits <= sizeof(T) * 8, "invalid nbits={}", nbits);
+  auto packed = wire::pack(in.data(), sizeof(T), in.size(), nbits);
+  addCost(tag, 1, packed.size());
+
+  sendBytes(lctx_->PrevRank(),
+            {packed.data<uint8_t>(), static_cast<size_t>(packed.size())}, tag);
+  auto buf = recvBytes(lctx_->NextRank(), tag);
+
+  std::vector<T> res(in.size());
+  wire::unpack(buf, sizeof(T), in.size(), nbits, res.data());
+  return res;
+}
 
-  stats_.latency += 1;
-  stats_.comm += in.size() * sizeof(T);
+template <typename T>
+void Communicator::sendAsync(size_t dst_rank, absl::Span<T const> in,
+                             size_t nbits, std::string_view tag) {
+  SPU_ENFORCE(nbits > 0 && nbits <= sizeof(T) * 8, "invalid nbits={}", nbits);
+  auto packed = wire::pack(in.data(), sizeof(T), in.size(), nbits);
+  sendBytes(dst_rank,
+            {packed.data<uint8_t>(), static_cast<size_t>(packed.size())}, tag);
+}
+
+template <typename T>
+std::vector<T> Communicator::recv(size_t src_rank, int64_t numel, size_t nbits,
+                                  std::string_view tag) {
+  SPU_ENFORCE(nbits > 0 && nbits <= sizeof(T) * 8, "invalid nbits={}", nbits);
+  auto buf = recvBytes(src_rank, tag);
+  std::vector<T> res(numel);
+  wire::unpack(buf, sizeof(T), numel, nbits, res.data());
+  return res;
+}
+
+template <typename T, template <typename> typename FN>
+std::vector<T> Communicator::allReduce(absl::Span<T const> in, size_t nbits,
+                                       std::string_view tag) {
+  SPU_ENFORCE(nbits > 0 && nbits <= sizeof(T) * 8, "invalid nbits={}", nbits);
+  auto packed = wire::pack(in.data(), sizeof(T), in.size(), nbits);
+  std::vector<yacl::Buffer> bufs = allGatherBytes(
+      {packed.data<uint8_t>(), static_cast<size_t>(packed.size())}, tag);
+  SPU_ENFORCE(bufs.size() == getWorldSize());
 
-  // TODO: steal the buffer.
+  // Sums may carry past nbits.
+  const T mask = nbits == sizeof(T) * 8 ? ~T(0) : (T(1) << nbits) - 1;
   std::vector<T> res(in.size(), 0);
-  std::memcpy(res.data(), buf.data(), in.size() * sizeof(T));
+  std::vector<T> peer(in.size());
+  const FN<T> fn;
+  for (const auto& buf : bufs) {
+    wire::unpack(buf, sizeof(T), in.size(), nbits, peer.data());
+    pforeach(0, in.size(),
+             [&](int64_t idx) { res[idx] = fn(res[idx], peer[idx]) & mask; });
+  }
+
+  addCost(tag, 1, packed.size() * (lctx_->WorldSize() - 1));
+
   return res;
 }
 
+template <typename T>
+std::vector<T> Communicator::bcast(absl::Span<T const> in, size_t root,
+                                   std::string_view tag) {
+  const auto buf = bcastBuffer<T>(in, root, tag);
+  return std::vector<T>(buf.begin(), buf.end());
+}
+
 template <typename T>
 std::vector<std::vector<T>> Communicator::gather(absl::Span<T const> in,
                                                  size_t root,
                                                  std::string_view tag) {
+  std::vector<std::vector<T>> res;
+  for (const auto& buf : gatherBuffers<T>(in, root, tag)) {
+    res.emplace_back(buf.begin(), buf.end());
+  }
+  return res;
+}
+
+template <typename T>
+CommBuffer<T> Communicator::recvBuffer(size_t src_rank, std::string_view tag) {
+  return CommBuffer<T>(recvBytes(src_rank, tag));
+}
+
+template <typename T>
+CommBuffer<T> Communicator::bcastBuffer(absl::Span<T const> in, size_t root,
+                                        std::string_view tag) {
   yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
                              sizeof(T) * in.size());
-  std::vector<yacl::Buffer> bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  CommBuffer<T> res(broadcastBytes(bv, root, tag));
 
-  stats_.latency += 1;
-  stats_.comm += in.size() * sizeof(T);
+  addCost(tag, 1, in.size() * sizeof(T));
 
-  // TODO: steal the buffer.
-  std::vector<std::vector<T>> res;
-  for (const auto& buf : bufs) {
-    std::vector<T> vi(in.size());
-    std::memcpy(vi.data(), buf.data(), in.size() * sizeof(T));
-    res.push_back(std::move(vi));
+  SPU_ENFORCE(res.size() == in.size());
+  return res;
+}
+
+template <typename T>
+std::vector<CommBuffer<T>> Communicator::gatherBuffers(absl::Span<T const> in,
+                                                       size_t root,
+                                                       std::string_view tag) {
+  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(in.data()),
+                             sizeof(T) * in.size());
+  std::vector<yacl::Buffer> bufs = gatherBytes(bv, root, tag);
+
+  addCost(tag, 1, in.size() * sizeof(T));
+
+  std::vector<CommBuffer<T>> res;
+  for (auto& buf : bufs) {
+    res.emplace_back(std::move(buf));
+    SPU_ENFORCE(res.back().size() == in.size());
   }
   return res;
 }
@@ -0,0 +1,63 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "yacl/link/test_util.h"
+
+#include "libspu/mpc/common/communicator.h"
+
+namespace spu::mpc {
+
+// Receiving a large message with and without copying it out of the received
+// buffer. Both parties live in this thread over the in-memory link, so the
+// time also covers the send, which is the same for both variants.
+template <bool kZeroCopy>
+static void BM_Recv(benchmark::State& state) {
+  const int64_t nbytes = state.range(0);
+  const std::vector<uint64_t> x(nbytes / sizeof(uint64_t), 1);
+  auto lctxs = yacl::link::test::SetupWorld(2);
+  Communicator sender(lctxs[0]);
+  Communicator receiver(lctxs[1]);
+
+  for (auto _ : state) {
+    sender.sendAsync<uint64_t>(1, x, "x");
+    if constexpr (kZeroCopy) {
+      auto res = receiver.recvBuffer<uint64_t>(0, "x");
+      benchmark::DoNotOptimize(res.data());
+    } else {
+      auto res = receiver.recv<uint64_t>(0, "x");
+      benchmark::DoNotOptimize(res.data());
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * nbytes);
+}
+
+static void makeRecvArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"bytes"})
+      ->Arg(int64_t(1) << 20)
+      ->Arg(int64_t(1) << 26)
+      ->Arg(int64_t(1) << 29)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+BENCHMARK(BM_Recv<false>)->Apply(makeRecvArgs);
+BENCHMARK(BM_Recv<true>)->Apply(makeRecvArgs);
+
+}  // namespace spu::mpc
+
+BENCHMARK_MAIN();
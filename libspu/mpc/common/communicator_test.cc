@@ -14,16 +14,31 @@
 
 #include "libspu/mpc/common/communicator.h"
 
+#include <chrono>
 #include <utility>
 
 #include "gtest/gtest.h"
 
+#include "libspu/core/context.h"
 #include "libspu/mpc/utils/ring_ops.h"
 #include "libspu/mpc/utils/simulate.h"
 
 namespace spu::mpc {
 namespace {
 
+class TestBShrTy : public TypeImpl<TestBShrTy, RingTy, Secret, BShare> {
+  using Base = TypeImpl<TestBShrTy, RingTy, Secret, BShare>;
+
+ public:
+  using Base::Base;
+  TestBShrTy(FieldType field, size_t nbits) {
+    field_ = field;
+    nbits_ = nbits;
+  }
+
+  static std::string_view getStaticId() { return "test.BShr"; }
+};
+
 class CommTest
     : public ::testing::TestWithParam<std::tuple<size_t, FieldType>> {};
 
@@ -87,6 +102,52 @@ TEST_P(CommTest, Reduce) {
   });
 }
 
+TEST_P(CommTest, LargeCollectives) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  // Above the payload where ring and tree algorithms take over.
+  const Shape kShape = {7, 42859};
+  const int64_t kNumel = kShape.numel();
+
+  std::vector<NdArrayRef> xs(kWorldSize);
+  auto sum_x = ring_zeros(kField, kShape);
+  auto xor_x = ring_zeros(kField, kShape);
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    xs[idx] = ring_rand(kField, kShape);
+    ring_add_(sum_x, xs[idx]);
+    ring_xor_(xor_x, xs[idx]);
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    const auto rank = com.getRank();
+    const auto& x = xs[rank];
+
+    // WHEN
+    auto sum_r = com.allReduce(ReduceOp::ADD, x, "_");
+    auto xor_r = com.allReduce(ReduceOp::XOR, x, "_");
+    const auto all_reduce_comm = com.getStats().comm;
+    auto scatter_r = com.reduceScatter(ReduceOp::ADD, x, "_");
+    const size_t root = kWorldSize - 1;
+    auto reduce_r = com.reduce(ReduceOp::ADD, x, root, "_");
+
+    // THEN
+    EXPECT_TRUE(ring_all_equal(sum_r, sum_x));
+    EXPECT_TRUE(ring_all_equal(xor_r, xor_x));
+    if (kWorldSize > 2) {
+      // Less than the N-1 full copies of an all-gather, for both calls.
+      EXPECT_LT(all_reduce_comm, 2 * kNumel * x.elsize() * (kWorldSize - 1));
+    }
+
+    const int64_t begin = kNumel * rank / kWorldSize;
+    const int64_t end = kNumel * (rank + 1) / kWorldSize;
+    EXPECT_TRUE(ring_all_equal(
+        scatter_r, sum_x.reshape({kNumel}).slice({begin}, {end}, {1})));
+
+    EXPECT_TRUE(ring_all_equal(reduce_r, rank == root ? sum_x : x));
+  });
+}
+
 TEST_P(CommTest, Rotate) {
   const Rank kWorldSize = std::get<0>(GetParam());
   const FieldType kField = std::get<1>(GetParam());
@@ -107,6 +168,357 @@ TEST_P(CommTest, Rotate) {
   });
 }
 
+TEST_P(CommTest, RotateStream) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  const int64_t kNumel = 1000;
+  // Small enough to split every array into several chunks.
+  const int64_t kChunkBytes = 1024;
+
+  std::vector<NdArrayRef> xs(kWorldSize);
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    // Strided views, which are streamed without being compacted first.
+    xs[idx] = ring_rand(kField, {2 * kNumel}).slice({0}, {2 * kNumel}, {2});
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    const auto& x = xs[com.getRank()];
+
+    // WHEN
+    NdArrayRef r(x.eltype(), x.shape());
+    int64_t expected_offset = 0;
+    com.rotateStream(
+        x, "_",
+        [&](int64_t offset, const NdArrayRef& chunk) {
+          EXPECT_EQ(offset, expected_offset);
+          EXPECT_LE(chunk.numel() * chunk.elsize(), kChunkBytes);
+          r.copy_slice(chunk, {0}, {offset}, chunk.numel());
+          expected_offset += chunk.numel();
+        },
+        kChunkBytes);
+
+    // THEN
+    EXPECT_EQ(expected_offset, kNumel);
+    EXPECT_TRUE(ring_all_equal(r, xs[(com.getRank() + 1) % kWorldSize]));
+    EXPECT_EQ(com.getStats().comm, kNumel * x.elsize());
+  });
+}
+
+TEST_P(CommTest, PackedBShare) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  const int64_t kNumel = 1001;
+
+  for (size_t nbits : {1, 7, 8, 13}) {
+    const auto ty = makeType<TestBShrTy>(kField, nbits);
+    const auto mask = ring_sub(
+        ring_lshift(ring_ones(kField, {kNumel}), {static_cast<int64_t>(nbits)}),
+        ring_ones(kField, {kNumel}));
+
+    std::vector<NdArrayRef> xs(kWorldSize);
+    auto xor_x = ring_zeros(kField, {kNumel});
+    for (size_t idx = 0; idx < kWorldSize; idx++) {
+      xs[idx] = ring_rand(kField, {kNumel}).as(ty);
+      ring_xor_(xor_x, xs[idx]);
+    }
+    ring_and_(xor_x, mask);
+
+    utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+      Communicator com(std::move(lctx));
+      const auto& x = xs[com.getRank()];
+
+      // WHEN
+      auto xor_r = com.allReduce(ReduceOp::XOR, x, "_");
+      auto rot_r = com.rotate(x, "_");
+
+      // THEN, high bits are dropped and only the packed bytes are sent.
+      const auto& next = xs[(com.getRank() + 1) % kWorldSize];
+      EXPECT_TRUE(ring_all_equal(xor_r, xor_x));
+      EXPECT_TRUE(ring_all_equal(rot_r, ring_and(next, mask)));
+      const size_t packed = (kNumel * nbits + 7) / 8;
+      EXPECT_EQ(com.getStats().comm, packed * kWorldSize);
+    });
+  }
+}
+
+TEST_P(CommTest, PackedSpan) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const int64_t kNumel = 1001;
+  const size_t kNbits = 5;
+
+  std::vector<std::vector<uint16_t>> xs(kWorldSize,
+                                        std::vector<uint16_t>(kNumel));
+  std::vector<uint16_t> sum_x(kNumel, 0);
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    for (int64_t i = 0; i < kNumel; i++) {
+      xs[idx][i] = static_cast<uint16_t>(idx * 7919 + i * 104729);
+      sum_x[i] = (sum_x[i] + xs[idx][i]) & ((1 << kNbits) - 1);
+    }
+  }
+  auto low = [&](uint16_t v) {
+    return static_cast<uint16_t>(v & ((1 << kNbits) - 1));
+  };
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    const auto rank = com.getRank();
+    absl::Span<uint16_t const> x = xs[rank];
+
+    // WHEN
+    auto sum_r = com.allReduce<uint16_t, std::plus>(x, kNbits, "_");
+    auto rot_r = com.rotate<uint16_t>(x, kNbits, "_");
+    com.sendAsync<uint16_t>(com.nextRank(), x, kNbits, "_");
+    auto recv_r = com.recv<uint16_t>(com.prevRank(), kNumel, kNbits, "_");
+
+    // THEN
+    const auto& next = xs[(rank + 1) % kWorldSize];
+    const auto& prev = xs[(rank + kWorldSize - 1) % kWorldSize];
+    for (int64_t i = 0; i < kNumel; i++) {
+      EXPECT_EQ(sum_r[i], sum_x[i]);
+      EXPECT_EQ(rot_r[i], low(next[i]));
+      EXPECT_EQ(recv_r[i], low(prev[i]));
+    }
+    const size_t packed = (kNumel * kNbits + 7) / 8;
+    EXPECT_EQ(com.getStats().comm, packed * kWorldSize);
+  });
+}
+
+TEST_P(CommTest, ZeroCopy) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  const int64_t kNumel = 1000;
+  const size_t kRoot = 1;
+
+  std::vector<std::vector<uint64_t>> xs(kWorldSize,
+                                        std::vector<uint64_t>(kNumel));
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    for (int64_t i = 0; i < kNumel; i++) {
+      xs[idx][i] = idx * 7919 + i * 104729;
+    }
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    const auto rank = com.getRank();
+    absl::Span<uint64_t const> x = xs[rank];
+
+    // WHEN
+    com.sendAsync<uint64_t>(com.nextRank(), x, "_");
+    auto recv_r = com.recvBuffer<uint64_t>(com.prevRank(), "_");
+    auto bcast_r = com.bcastBuffer<uint64_t>(x, kRoot, "_");
+    auto gather_r = com.gatherBuffers<uint64_t>(x, kRoot, "_");
+
+    // THEN
+    const auto& prev = xs[(rank + kWorldSize - 1) % kWorldSize];
+    ASSERT_EQ(recv_r.size(), size_t(kNumel));
+    ASSERT_EQ(bcast_r.size(), size_t(kNumel));
+    for (int64_t i = 0; i < kNumel; i++) {
+      EXPECT_EQ(recv_r[i], prev[i]);
+      EXPECT_EQ(bcast_r[i], xs[kRoot][i]);
+    }
+    if (rank == kRoot) {
+      ASSERT_EQ(gather_r.size(), kWorldSize);
+      for (size_t idx = 0; idx < kWorldSize; idx++) {
+        EXPECT_EQ(std::vector<uint64_t>(gather_r[idx].begin(),
+                                        gather_r[idx].end()),
+                  xs[idx]);
+      }
+    }
+
+    // The array views the received buffer.
+    if (SizeOf(kField) == sizeof(uint64_t)) {
+      auto arr = recv_r.asNdArray(makeType<RingTy>(kField), {10, 100});
+      EXPECT_EQ(arr.data(), recv_r.data());
+      EXPECT_EQ(arr.shape(), Shape({10, 100}));
+    }
+    EXPECT_ANY_THROW(recv_r.asNdArray(makeType<RingTy>(kField), {kNumel + 1}));
+  });
+}
+
+TEST_P(CommTest, Coalesce) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const int64_t kNumel = 100;
+
+  std::vector<std::vector<uint32_t>> xs(kWorldSize,
+                                        std::vector<uint32_t>(kNumel));
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    for (int64_t i = 0; i < kNumel; i++) {
+      xs[idx][i] = static_cast<uint32_t>(idx * 7919 + i);
+    }
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx), /*coalescing*/ true);
+    const auto rank = com.getRank();
+    absl::Span<uint32_t const> x = xs[rank];
+    std::vector<uint32_t> y(x.rbegin(), x.rend());
+
+    // WHEN
+    {
+      Communicator::Epoch epoch(&com);
+      com.sendAsync<uint32_t>(com.nextRank(), x, "x");
+      com.sendAsync<uint32_t>(com.nextRank(), y, "y");
+    }
+    // received in the other order, the batch is split by tag.
+    auto recv_y = com.recv<uint32_t>(com.prevRank(), "y");
+    auto recv_x = com.recv<uint32_t>(com.prevRank(), "x");
+    // outside an epoch every send leaves at once.
+    auto rot_r = com.rotate<uint32_t>(x, "_");
+    auto sum_r = com.allReduce<uint32_t, std::plus>(x, "_");
+
+    // THEN
+    const auto& next = xs[(rank + 1) % kWorldSize];
+    const auto& prev = xs[(rank + kWorldSize - 1) % kWorldSize];
+    for (int64_t i = 0; i < kNumel; i++) {
+      uint32_t sum = 0;
+      for (size_t idx = 0; idx < kWorldSize; idx++) {
+        sum += xs[idx][i];
+      }
+      EXPECT_EQ(recv_x[i], prev[i]);
+      EXPECT_EQ(recv_y[i], prev[kNumel - 1 - i]);
+      EXPECT_EQ(rot_r[i], next[i]);
+      EXPECT_EQ(sum_r[i], sum);
+    }
+    EXPECT_EQ(com.getStats().logical_msgs, 3U);
+    EXPECT_EQ(com.getStats().physical_msgs, 2U);
+  });
+}
+
+TEST(CommEmulationTest, Latency) {
+  const int64_t kNumel = 1000;
+  utils::NetworkProfile profile;
+  profile.latency_ms = 30;
+
+  auto x = ring_rand(FieldType::FM64, {kNumel});
+  utils::simulate(3, profile, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+
+    // WHEN
+    const auto start = std::chrono::steady_clock::now();
+    auto rot_r = com.rotate(x, "_");
+    const auto rotated = std::chrono::steady_clock::now();
+    auto sum_r = com.allReduce(ReduceOp::ADD, x, "_");
+    const auto reduced = std::chrono::steady_clock::now();
+
+    // THEN
+    EXPECT_TRUE(ring_all_equal(rot_r, x));
+    EXPECT_TRUE(ring_all_equal(sum_r, ring_mul(x, 3)));
+    EXPECT_GE(rotated - start, std::chrono::milliseconds(30));
+    EXPECT_GE(reduced - rotated, std::chrono::milliseconds(30));
+  });
+}
+
+TEST(CommProfileTest, SharedByForks) {
+  const int64_t kNumel = 1000;
+  auto x = ring_rand(FieldType::FM64, {kNumel});
+  utils::simulate(3, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    auto sub = com.fork();
+    auto* sub_com = dynamic_cast<Communicator*>(sub.get());
+
+    // WHEN
+    {
+      const std::string name = "test_kernel";
+      spu::detail::KernelNameGuard guard(name);
+      sub_com->rotate(x, "rot");
+    }
+    com.allReduce(ReduceOp::ADD, x, "sum");
+
+    // THEN
+    const size_t bytes = kNumel * sizeof(uint64_t);
+    EXPECT_EQ(com.getStats().comm, 2 * bytes);
+    EXPECT_EQ(sub_com->getStats().comm, bytes);
+
+    const auto profile = com.getProfile();
+    EXPECT_EQ(profile.total().bytes, 3 * bytes);
+    EXPECT_EQ(profile.by_tag.at("rot").bytes, bytes);
+    EXPECT_EQ(profile.by_tag.at("rot").msgs, 1U);
+    EXPECT_EQ(profile.by_tag.at("sum").rounds, 1U);
+    EXPECT_EQ(profile.by_kernel.at("test_kernel").bytes, bytes);
+    EXPECT_EQ(profile.by_kernel.at("").bytes, 2 * bytes);
+  });
+}
+
+TEST(CommTranscriptTest, Replay) {
+  const size_t kWorldSize = 3;
+  const int64_t kNumel = 1000;
+  const auto path = ::testing::TempDir() + "comm_replay_transcript";
+
+  std::vector<NdArrayRef> xs(kWorldSize);
+  for (auto& x : xs) {
+    x = ring_rand(FieldType::FM64, {kNumel});
+  }
+  auto run = [&](Communicator* com) {
+    auto sub = com->fork();
+    auto* sub_com = dynamic_cast<Communicator*>(sub.get());
+    const auto& x = xs[com->getRank()];
+    return std::vector<NdArrayRef>{
+        com->rotate(x, "rot"),
+        sub_com->allReduce(ReduceOp::ADD, x, "sum"),
+        com->broadcast(x, 1, x.eltype(), x.shape(), "bcast"),
+    };
+  };
+
+  std::vector<NdArrayRef> expected;
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(lctx);
+    if (lctx->Rank() == 0) {
+      com.setRecorder(std::make_shared<utils::CommTranscriptWriter>(
+          path, 0, kWorldSize));
+    }
+    auto res = run(&com);
+    if (lctx->Rank() == 0) {
+      expected = std::move(res);
+    }
+  });
+
+  // WHEN
+  auto reader = std::make_shared<utils::CommTranscriptReader>(path);
+  auto lctx = yacl::link::test::SetupWorld("replay", kWorldSize)[0];
+  std::vector<NdArrayRef> replayed;
+  {
+    Communicator com(lctx, reader);
+    replayed = run(&com);
+  }
+
+  // THEN
+  ASSERT_EQ(replayed.size(), expected.size());
+  for (size_t idx = 0; idx < expected.size(); idx++) {
+    EXPECT_TRUE(ring_all_equal(replayed[idx], expected[idx])) << idx;
+  }
+  EXPECT_EQ(reader->remaining(), 0U);
+
+  // A different message does not match the transcript.
+  Communicator diverged(lctx, std::make_shared<utils::CommTranscriptReader>(
+                                  path));
+  EXPECT_ANY_THROW(diverged.rotate(xs[0], "other"));
+}
+
+TEST(CommTranscriptTest, OpenFromConfig) {
+  const size_t kWorldSize = 2;
+  const auto prefix = ::testing::TempDir() + "comm_config_transcript";
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    RuntimeConfig conf;
+    EXPECT_EQ(openCommTranscript(conf, *lctx), nullptr);
+
+    conf.set_experimental_comm_transcript_prefix(prefix);
+    conf.set_experimental_comm_transcript_size_only(true);
+    Communicator com(lctx);
+    com.setRecorder(openCommTranscript(conf, *lctx));
+    com.allReduce(ReduceOp::ADD, ring_rand(FieldType::FM64, {10}), "sum");
+  });
+
+  for (size_t rank = 0; rank < kWorldSize; rank++) {
+    utils::CommTranscriptReader reader(fmt::format("{}.{}", prefix, rank));
+    EXPECT_EQ(reader.rank(), rank);
+    EXPECT_EQ(reader.worldSize(), kWorldSize);
+    EXPECT_FALSE(reader.hasPayload());
+    EXPECT_GT(reader.remaining(), 0U);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     CommTestInstances, CommTest,
     testing::Combine(testing::Values(4, 3, 2),
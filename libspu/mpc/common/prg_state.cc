@@ -14,6 +14,8 @@
 
 #include "libspu/mpc/common/prg_state.h"
 
+#include <cstring>
+
 #include "yacl/crypto/rand/rand.h"
 #include "yacl/crypto/tools/prg.h"
 #include "yacl/link/algorithm/allgather.h"
@@ -22,6 +24,121 @@
 #include "libspu/mpc/utils/permute.h"
 
 namespace spu::mpc {
+namespace {
+
+constexpr int64_t kBlockSize = 16;
+// Blocks computed per step of the producer.
+constexpr int64_t kProduceBlocks = 1 << 12;
+// Bounds of the buffered stream, which targets twice the recent demand.
+constexpr int64_t kMinPrefetchBlocks = 1 << 12;
+constexpr int64_t kMaxPrefetchBlocks = 1 << 19;
+
+int64_t toBlocks(int64_t nbytes) {
+  return (nbytes + kBlockSize - 1) / kBlockSize;
+}
+
+}  // namespace
+
+PrgPrefetcher::PrgPrefetcher(uint128_t seed, uint64_t count)
+    : seed_(seed), head_(count), tail_(count) {
+  thread_ = std::thread([this] { produce(); });
+}
+
+PrgPrefetcher::~PrgPrefetcher() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+int64_t PrgPrefetcher::targetBlocks() const {
+  return std::clamp(2 * toBlocks(demand_), kMinPrefetchBlocks,
+                    kMaxPrefetchBlocks);
+}
+
+void PrgPrefetcher::reset(uint64_t count) {
+  head_ = count;
+  tail_ = count;
+  ++epoch_;
+}
+
+uint64_t PrgPrefetcher::fill(uint64_t count, absl::Span<uint8_t> out) {
+  const int64_t nbytes = out.size();
+  const int64_t nblock = toBlocks(nbytes);
+
+  int64_t taken = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    demand_ = std::max(nbytes, demand_ - demand_ / 8);
+    if (count != head_) {
+      reset(count);
+    }
+    const int64_t capacity = targetBlocks() * kBlockSize;
+    if (static_cast<int64_t>(ring_.size()) < capacity) {
+      ring_.resize(capacity);
+      reset(count);
+    }
+
+    // The buffered blocks are whole, so a remainder starts on a block.
+    taken = std::min<int64_t>((tail_ - head_) * kBlockSize, nbytes);
+    const int64_t offset = (head_ * kBlockSize) % ring_.size();
+    const int64_t first = std::min<int64_t>(taken, ring_.size() - offset);
+    std::memcpy(out.data(), ring_.data() + offset, first);
+    std::memcpy(out.data() + first, ring_.data(), taken - first);
+
+    head_ += nblock;
+    if (head_ > tail_) {
+      tail_ = head_;
+      ++epoch_;
+    }
+  }
+  cv_.notify_all();
+
+  if (taken < nbytes) {
+    PrgState::fillPRand(seed_, count + taken / kBlockSize, out.subspan(taken));
+  }
+  return count + nblock;
+}
+
+void PrgPrefetcher::produce() {
+  std::vector<uint8_t> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [&] {
+      return stop_ ||
+             static_cast<int64_t>(tail_ - head_) <
+                 std::min<int64_t>(targetBlocks(), ring_.size() / kBlockSize);
+    });
+    if (stop_) {
+      return;
+    }
+
+    const uint64_t begin = tail_;
+    const uint64_t epoch = epoch_;
+    const int64_t nblock = std::min<int64_t>(
+        kProduceBlocks,
+        std::min<int64_t>(targetBlocks(), ring_.size() / kBlockSize) -
+            (tail_ - head_));
+
+    lock.unlock();
+    batch.resize(nblock * kBlockSize);
+    PrgState::fillPRand(seed_, begin, absl::MakeSpan(batch));
+    lock.lock();
+
+    // The consumer moved past or away from this batch meanwhile.
+    if (epoch != epoch_) {
+      continue;
+    }
+    const int64_t offset = (begin * kBlockSize) % ring_.size();
+    const int64_t first =
+        std::min<int64_t>(batch.size(), ring_.size() - offset);
+    std::memcpy(ring_.data() + offset, batch.data(), first);
+    std::memcpy(ring_.data(), batch.data() + first, batch.size() - first);
+    tail_ += nblock;
+  }
+}
 
 PrgState::PrgState() {
   pub_seed_ = 0;
@@ -32,7 +149,8 @@ PrgState::PrgState() {
   next_seed_ = 0;
 }
 
-PrgState::PrgState(const std::shared_ptr<yacl::link::Context>& lctx) {
+PrgState::PrgState(const std::shared_ptr<yacl::link::Context>& lctx,
+                   bool enable_prefetch) {
   // synchronize public state.
   {
     uint128_t self_pk = yacl::crypto::SecureRandSeed();
@@ -62,6 +180,12 @@ PrgState::PrgState(const std::shared_ptr<yacl::link::Context>& lctx) {
     next_seed_ =
         yacl::DeserializeUint128(lctx->Recv(lctx->NextRank(), kCommTag));
   }
+
+  if (enable_prefetch) {
+    priv_prefetcher_ = std::make_unique<PrgPrefetcher>(priv_seed_, 0);
+    r0_prefetcher_ = std::make_unique<PrgPrefetcher>(self_seed_, 0);
+    r1_prefetcher_ = std::make_unique<PrgPrefetcher>(next_seed_, 0);
+  }
 }
 
 std::unique_ptr<State> PrgState::fork() {
@@ -94,18 +218,18 @@ std::pair<NdArrayRef, NdArrayRef> PrgState::genPrssPair(FieldType field,
 
 NdArrayRef PrgState::genPriv(FieldType field, const Shape& shape) {
   NdArrayRef res(makeType<RingTy>(field), shape);
-  priv_counter_ = yacl::crypto::FillPRand(
-      kAesType, priv_seed_, 0, priv_counter_,
-      absl::MakeSpan(res.data<char>(), res.buf()->size()));
+  priv_counter_ =
+      fillPRand(priv_prefetcher_, priv_seed_, priv_counter_,
+                absl::MakeSpan(res.data<char>(), res.buf()->size()));
 
   return res;
 }
 
 NdArrayRef PrgState::genPubl(FieldType field, const Shape& shape) {
   NdArrayRef res(makeType<RingTy>(field), shape);
-  pub_counter_ = yacl::crypto::FillPRand(
-      kAesType, pub_seed_, 0, pub_counter_,
-      absl::MakeSpan(res.data<char>(), res.buf()->size()));
+  pub_counter_ =
+      fillPRand(pub_seed_, pub_counter_,
+                absl::MakeSpan(res.data<char>(), res.buf()->size()));
 
   return res;
 }
@@ -14,16 +14,61 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "absl/types/span.h"
 #include "yacl/crypto/rand/rand.h"
 #include "yacl/crypto/tools/prg.h"
 #include "yacl/link/context.h"
+#include "yacl/utils/parallel.h"
 
 #include "libspu/core/ndarray_ref.h"
 #include "libspu/core/object.h"
 
 namespace spu::mpc {
 
+// Computes the AES-CTR stream of one seed ahead of use on a background thread,
+// in a bounded ring buffer sized from recent demand.
+//
+// fill returns exactly what PrgState::fillPRand returns for the same seed and
+// counter, so whether a party prefetches is invisible to its peers. Any
+// counter other than the one the last fill returned, for example after the
+// counter was used directly, drops the buffered stream.
+class PrgPrefetcher {
+ public:
+  PrgPrefetcher(uint128_t seed, uint64_t count);
+  ~PrgPrefetcher();
+
+  uint64_t fill(uint64_t count, absl::Span<uint8_t> out);
+
+ private:
+  void produce();
+  void reset(uint64_t count);
+  int64_t targetBlocks() const;
+
+  const uint128_t seed_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+
+  // Blocks [head_, tail_) of the stream, block b at slot b % capacity.
+  std::vector<uint8_t> ring_;
+  uint64_t head_;
+  uint64_t tail_;
+  // Bumped whenever tail_ moves other than by the producer.
+  uint64_t epoch_ = 0;
+  // Decaying maximum of recent request sizes in bytes.
+  int64_t demand_ = 0;
+
+  std::thread thread_;
+};
+
 // The Pseudo-Random-Generator state.
 //
 // PRG could be used to generate random variable, for
@@ -45,13 +90,64 @@ class PrgState : public State {
   uint64_t r0_counter_ = 0;  // cnt for self_seed
   uint64_t r1_counter_ = 0;  // cnt for next_seed
 
+  // Background producers of the streams above, null unless enabled.
+  std::unique_ptr<PrgPrefetcher> priv_prefetcher_;
+  std::unique_ptr<PrgPrefetcher> r0_prefetcher_;
+  std::unique_ptr<PrgPrefetcher> r1_prefetcher_;
+
+  template <typename T>
+  static uint64_t fillPRand(const std::unique_ptr<PrgPrefetcher>& prefetcher,
+                            uint128_t seed, uint64_t count, absl::Span<T> out) {
+    if (prefetcher == nullptr) {
+      return fillPRand(seed, count, out);
+    }
+    return prefetcher->fill(
+        count, absl::MakeSpan(reinterpret_cast<uint8_t*>(out.data()),
+                              out.size() * sizeof(T)));
+  }
+
  public:
   static constexpr const char* kBindName() { return "PrgState"; }
   static constexpr auto kAesType =
       yacl::crypto::SymmetricCrypto::CryptoType::AES128_CTR;
 
+  // Same output and returned counter as a single yacl::crypto::FillPRand call.
+  // Large fills are cut at fixed offsets into chunks of whole AES blocks, and
+  // every chunk is filled from its own counter range on a worker thread, so
+  // the result does not depend on the number of threads. This relies on block
+  // i of a fill depending only on `count + i`.
+  template <typename T>
+  static uint64_t fillPRand(uint128_t seed, uint64_t count, absl::Span<T> out) {
+    // AES blocks, 256KiB per task.
+    constexpr int64_t kBlockSize = 16;
+    constexpr int64_t kChunkBlocks = 1 << 14;
+
+    const int64_t nbytes = out.size() * sizeof(T);
+    const int64_t nblock = (nbytes + kBlockSize - 1) / kBlockSize;
+    if (nblock <= kChunkBlocks) {
+      return yacl::crypto::FillPRand(kAesType, seed, 0, count, out);
+    }
+
+    auto* bytes = reinterpret_cast<uint8_t*>(out.data());
+    const int64_t nchunk = (nblock + kChunkBlocks - 1) / kChunkBlocks;
+    yacl::parallel_for(0, nchunk, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t chunk = begin; chunk < end; ++chunk) {
+        const int64_t offset = chunk * kChunkBlocks * kBlockSize;
+        const int64_t size =
+            std::min(kChunkBlocks * kBlockSize, nbytes - offset);
+        yacl::crypto::FillPRand(kAesType, seed, 0, count + chunk * kChunkBlocks,
+                                absl::MakeSpan(bytes + offset, size));
+      }
+    });
+    return count + nblock;
+  }
+
   PrgState();
-  explicit PrgState(const std::shared_ptr<yacl::link::Context>& lctx);
+  // With `enable_prefetch`, the private and PRSS streams are computed ahead on
+  // background threads. The output does not change, so parties need not agree
+  // on it. Forked states never prefetch.
+  explicit PrgState(const std::shared_ptr<yacl::link::Context>& lctx,
+                    bool enable_prefetch = false);
 
   bool hasLowCostFork() const override { return true; }
 
@@ -81,20 +177,20 @@ class PrgState : public State {
   void fillPrssPair(T* r0, T* r1, size_t numel, GenPrssCtrl ctrl) {
     switch (ctrl) {
       case GenPrssCtrl::First: {
-        r0_counter_ = yacl::crypto::FillPRand(
-            kAesType, self_seed_, 0, r0_counter_, absl::MakeSpan(r0, numel));
+        r0_counter_ = fillPRand(r0_prefetcher_, self_seed_, r0_counter_,
+                                absl::MakeSpan(r0, numel));
         return;
       }
       case GenPrssCtrl::Second: {
-        r1_counter_ = yacl::crypto::FillPRand(
-            kAesType, next_seed_, 0, r1_counter_, absl::MakeSpan(r1, numel));
+        r1_counter_ = fillPRand(r1_prefetcher_, next_seed_, r1_counter_,
+                                absl::MakeSpan(r1, numel));
         return;
       }
       case GenPrssCtrl::Both: {
-        r0_counter_ = yacl::crypto::FillPRand(
-            kAesType, self_seed_, 0, r0_counter_, absl::MakeSpan(r0, numel));
-        r1_counter_ = yacl::crypto::FillPRand(
-            kAesType, next_seed_, 0, r1_counter_, absl::MakeSpan(r1, numel));
+        r0_counter_ = fillPRand(r0_prefetcher_, self_seed_, r0_counter_,
+                                absl::MakeSpan(r0, numel));
+        r1_counter_ = fillPRand(r1_prefetcher_, next_seed_, r1_counter_,
+                                absl::MakeSpan(r1, numel));
         return;
       }
     }
@@ -102,14 +198,12 @@ class PrgState : public State {
 
   template <typename T>
   void fillPubl(absl::Span<T> r) {
-    pub_counter_ =
-        yacl::crypto::FillPRand(kAesType, pub_seed_, 0, pub_counter_, r);
+    pub_counter_ = fillPRand(pub_seed_, pub_counter_, r);
   }
 
   template <typename T>
   void fillPriv(absl::Span<T> r) {
-    priv_counter_ =
-        yacl::crypto::FillPRand(kAesType, priv_seed_, 0, priv_counter_, r);
+    priv_counter_ = fillPRand(priv_prefetcher_, priv_seed_, priv_counter_, r);
   }
 };
 
@@ -0,0 +1,66 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "yacl/utils/parallel.h"
+
+#include "libspu/mpc/common/prg_state.h"
+
+namespace spu::mpc {
+
+// AES-CTR throughput, `bytes_per_core` divides by the threads in use so the
+// two variants compare per core speed. The AES itself is yacl's, which picks
+// the AES-NI/VAES multi block code paths of the CPU.
+template <bool kParallel>
+static void BM_FillPRand(benchmark::State& state) {
+  const int64_t nbytes = state.range(0);
+  std::vector<uint8_t> out(nbytes);
+  const uint128_t seed = 1;
+  uint64_t count = 0;
+
+  for (auto _ : state) {
+    if constexpr (kParallel) {
+      count = PrgState::fillPRand(seed, count, absl::MakeSpan(out));
+    } else {
+      count = yacl::crypto::FillPRand(PrgState::kAesType, seed, 0, count,
+                                      absl::MakeSpan(out));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  const int64_t threads = kParallel ? yacl::get_num_threads() : 1;
+  state.SetBytesProcessed(state.iterations() * nbytes);
+  state.counters["threads"] = static_cast<double>(threads);
+  state.counters["bytes_per_core"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * nbytes) / threads,
+      benchmark::Counter::kIsRate, benchmark::Counter::kIs1024);
+}
+
+static void makeFillArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"bytes"})
+      ->Arg(int64_t(1) << 20)
+      ->Arg(int64_t(1) << 26)
+      ->Arg(int64_t(1) << 30)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+BENCHMARK(BM_FillPRand<false>)->Apply(makeFillArgs);
+BENCHMARK(BM_FillPRand<true>)->Apply(makeFillArgs);
+
+}  // namespace spu::mpc
+
+BENCHMARK_MAIN();
@@ -14,6 +14,11 @@
 
 #include "libspu/mpc/common/prg_state.h"
 
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "yacl/link/algorithm/barrier.h"
 #include "yacl/link/context.h"
@@ -62,4 +67,67 @@ TEST(PrgStateTest, Fork) {
   });
 }
 
+TEST(PrgStateTest, PrefetchKeepsPrssCorrelation) {
+  const size_t npc = 3;
+
+  const std::vector<std::pair<FieldType, Shape>> cases = {
+      {FM64, {3}},         {FM32, {7}},       {FM128, {100, 10}},
+      {FM32, {1 << 20}},   {FM64, {1}},       {FM64, {1 << 20}},
+      {FM32, {1000, 333}}, {FM128, {12345}},
+  };
+  std::array<std::vector<NdArrayRef>, 3> r0s;
+  std::array<std::vector<NdArrayRef>, 3> r1s;
+
+  utils::simulate(npc, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+    const size_t rank = lctx->Rank();
+    // Only rank 0 prefetches, which must not be visible to the others.
+    PrgState state(lctx, rank == 0);
+
+    for (size_t idx = 0; idx < cases.size(); idx++) {
+      // Give the producers time to run ahead.
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      const auto& [field, shape] = cases[idx];
+      auto [r0, r1] =
+          state.genPrssPair(field, shape, PrgState::GenPrssCtrl::Both);
+      r0s[rank].push_back(r0);
+      r1s[rank].push_back(r1);
+      state.genPriv(field, shape);
+      if (idx == 3) {
+        // Draws from the PRSS counters without the prefetchers.
+        state.genPrssPermPair(17);
+      }
+    }
+  });
+
+  for (size_t idx = 0; idx < cases.size(); idx++) {
+    for (size_t rank = 0; rank < npc; rank++) {
+      const auto& r1 = r1s[rank][idx];
+      const auto& r0 = r0s[(rank + 1) % npc][idx];
+      EXPECT_EQ(std::memcmp(r1.data(), r0.data(), r1.buf()->size()), 0)
+          << idx << " " << rank;
+    }
+  }
+}
+
+TEST(PrgStateTest, ParallelFillMatchesSerial) {
+  const uint128_t seed = yacl::MakeUint128(0x1234, 0x5678);
+  const uint64_t count = 42;
+
+  // Below, at and across the per task chunk of 1 << 14 blocks, with a
+  // trailing partial block.
+  for (size_t nbytes : {size_t(1), size_t(17), size_t(16) << 14,
+                        (size_t(16) << 14) * 3 + 5}) {
+    std::vector<uint8_t> serial(nbytes);
+    std::vector<uint8_t> parallel(nbytes);
+
+    const auto serial_count = yacl::crypto::FillPRand(
+        PrgState::kAesType, seed, 0, count, absl::MakeSpan(serial));
+    const auto parallel_count =
+        PrgState::fillPRand(seed, count, absl::MakeSpan(parallel));
+
+    EXPECT_EQ(serial_count, parallel_count) << nbytes;
+    EXPECT_EQ(serial, parallel) << nbytes;
+  }
+}
+
 }  // namespace spu::mpc
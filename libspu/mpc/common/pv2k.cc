@@ -69,22 +69,17 @@ class V2P : public UnaryKernel {
     const auto field = ctx->getState<Z2kState>()->getDefaultField();
     size_t owner = in.eltype().as<Priv2kTy>()->owner();
 
-    NdArrayRef out(makeType<Pub2kTy>(field), in.shape());
-
     auto numel = in.numel();
 
-    DISPATCH_ALL_FIELDS(field, [&]() {
+    return DISPATCH_ALL_FIELDS(field, [&]() {
       std::vector<ring2k_t> priv(numel);
       NdArrayView<ring2k_t> _in(in);
 
       pforeach(0, numel, [&](int64_t idx) { priv[idx] = _in[idx]; });
 
-      std::vector<ring2k_t> publ = comm->bcast<ring2k_t>(priv, owner, "v2p");
-
-      NdArrayView<ring2k_t> _out(out);
-      pforeach(0, numel, [&](int64_t idx) { _out[idx] = publ[idx]; });
+      auto publ = comm->bcastBuffer<ring2k_t>(priv, owner, "v2p");
+      return publ.asNdArray(makeType<Pub2kTy>(field), in.shape());
     });
-    return out;
   }
 };
 
@@ -127,6 +127,8 @@ class PermKernel : public Kernel {
                           const NdArrayRef& perm) const = 0;
 };
 
+// Builds one onehot of length s per element of the 1-D target, the result is
+// of shape {target.numel(), s}.
 class OramOneHotKernel : public Kernel {
   void evaluate(KernelEvalContext* ctx) const override;
 
@@ -475,6 +475,8 @@ void regRef2kProtocol(SPUContext* ctx,
 
   // add communicator
   ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->getState<Communicator>()->setRecorder(
+      openCommTranscript(ctx->config(), *lctx));
 
   // add Z2k state.
   ctx->prot()->addState<Z2kState>(ctx->config().field());
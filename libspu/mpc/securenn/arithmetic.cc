@@ -42,15 +42,15 @@ NdArrayRef A2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
     NdArrayView<ring2k_t> _in(in);
     pforeach(0, numel, [&](int64_t idx) { share[idx] = _in[idx]; });
 
-    std::vector<std::vector<ring2k_t>> shares =
-        comm->gather<ring2k_t>(share, rank, "a2v");  // comm => 1, k
+    auto shares =
+        comm->gatherBuffers<ring2k_t>(share, rank, "a2v");  // comm => 1, k
     if (comm->getRank() == rank) {
       SPU_ENFORCE(shares.size() == comm->getWorldSize());
       NdArrayRef out(out_ty, in.shape());
       NdArrayView<ring2k_t> _out(out);
       pforeach(0, numel, [&](int64_t idx) {
         ring2k_t s = 0;
-        for (auto& share : shares) {
+        for (const auto& share : shares) {
           s += share[idx];
         }
         _out[idx] = s;
@@ -78,15 +78,15 @@ NdArrayRef A2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
     NdArrayView<ring2k_t> _in(in);
     pforeach(0, numel, [&](int64_t idx) { share[idx] = _in[idx]; });
 
-    std::vector<std::vector<ring2k_t>> shares =
-        comm->gather<ring2k_t>(share, rank, "a2v");  // comm => 1, k
+    auto shares =
+        comm->gatherBuffers<ring2k_t>(share, rank, "a2v");  // comm => 1, k
     if (comm->getRank() == rank) {
       SPU_ENFORCE(shares.size() == comm->getWorldSize());
       NdArrayRef out(out_ty, in.shape());
       NdArrayView<ring2k_t> _out(out);
       pforeach(0, numel, [&](int64_t idx) {
         ring2k_t s = 0;
-        for (auto& share : shares) {
+        for (const auto& share : shares) {
           s += share[idx];
         }
         _out[idx] = s;
@@ -163,6 +163,45 @@ NdArrayRef UnflattenBuffer(yacl::Buffer&& buf, const NdArrayRef& x) {
                     x.shape());
 }
 
+// Opens all shares with one point to point exchange. Every party sends all
+// its shares to every peer before it waits for theirs, so with coalescing the
+// shares to one peer leave as a single message.
+std::vector<NdArrayRef> OpenBurst(Communicator* comm,
+                                  const std::vector<NdArrayRef>& xs,
+                                  std::string_view tag) {
+  const size_t rank = comm->getRank();
+  const size_t world_size = comm->getWorldSize();
+  {
+    Communicator::Epoch epoch(comm);
+    for (size_t peer = 0; peer < world_size; ++peer) {
+      if (peer == rank) {
+        continue;
+      }
+      for (const auto& x : xs) {
+        comm->sendAsync(peer, x, tag);
+      }
+    }
+  }
+
+  std::vector<NdArrayRef> ret;
+  size_t bytes = 0;
+  for (const auto& x : xs) {
+    ret.push_back(x.clone());
+    bytes += x.numel() * x.elsize();
+  }
+  for (size_t peer = 0; peer < world_size; ++peer) {
+    if (peer == rank) {
+      continue;
+    }
+    for (size_t idx = 0; idx < xs.size(); ++idx) {
+      ring_add_(ret[idx], comm->recv(peer, xs[idx].eltype(), tag)
+                              .reshape(xs[idx].shape()));
+    }
+  }
+  comm->addCommStatsManually(1, bytes * (world_size - 1));
+  return ret;
+}
+
 std::tuple<NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef> MulOpen(
     KernelEvalContext* ctx, const NdArrayRef& x, const NdArrayRef& y,
     bool mmul) {
@@ -227,8 +266,13 @@ std::tuple<NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef> MulOpen(
   auto x_hit_cache = x_cache.replay_desc.status != Beaver::Init;
   auto y_hit_cache = y_cache.replay_desc.status != Beaver::Init;
 
-  if (ctx->sctx()->config().experimental_disable_vectorization() ||
-      x_hit_cache || y_hit_cache) {
+  if (comm->isCoalescing() && !x_hit_cache && !y_hit_cache) {
+    auto res =
+        OpenBurst(comm, {ring_sub(x, a), ring_sub(y, b)}, "open(x-a,y-b)");
+    x_a = std::move(res[0]);
+    y_b = std::move(res[1]);
+  } else if (ctx->sctx()->config().experimental_disable_vectorization() ||
+             x_hit_cache || y_hit_cache) {
     if (x_hit_cache) {
       x_a = std::move(x_cache.open_cache);
     } else {
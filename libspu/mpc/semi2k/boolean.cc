@@ -189,17 +189,27 @@ NdArrayRef AndBB::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
         mask[numel + idx] = _rhs[idx] ^ _b[idx];
       });
 
-      mask = comm->allReduce<V, std::bit_xor>(mask, "open(x^a,y^b)");
+      // Only the low out_nbits of the masked values are valid.
+      const size_t wire_nbits = out_nbits == 0 ? sizeof(V) * 8 : out_nbits;
+      mask = comm->allReduce<V, std::bit_xor>(mask, wire_nbits,
+                                              "open(x^a,y^b)");
+
+      // The triples are random above out_nbits, clear those bits so the
+      // share stays zero there when it meets wider shares.
+      const V out_mask = wire_nbits == sizeof(V) * 8
+                             ? ~V(0)
+                             : (V(1) << wire_nbits) - 1;
 
       // Zi = Ci ^ ((X ^ A) & Bi) ^ ((Y ^ B) & Ai) ^ <(X ^ A) & (Y ^ B)>
       NdArrayView<T> _z(out);
       pforeach(0, numel, [&](int64_t idx) {
-        _z[idx] = _c[idx];
-        _z[idx] ^= mask[idx] & _b[idx];
-        _z[idx] ^= mask[numel + idx] & _a[idx];
+        V z = _c[idx];
+        z ^= mask[idx] & _b[idx];
+        z ^= mask[numel + idx] & _a[idx];
         if (comm->getRank() == 0) {
-          _z[idx] ^= mask[idx] & mask[numel + idx];
+          z ^= mask[idx] & mask[numel + idx];
         }
+        _z[idx] = z & out_mask;
       });
     });
   });
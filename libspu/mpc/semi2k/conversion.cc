@@ -360,8 +360,11 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
     int64_t cur_bits = round_out.eltype().as<BShare>()->nbits();
     while (cur_bits != 1) {
       cur_bits /= 2;
-      round_out = wrap_and_bb(ctx->sctx(), round_out,
-                              ring_rshift(round_out, {cur_bits}));
+      // Later rounds only read the low cur_bits, which narrows the wire.
+      const auto round_ty = makeType<BShrTy>(field, cur_bits);
+      round_out =
+          wrap_and_bb(ctx->sctx(), round_out.as(round_ty),
+                      ring_rshift(round_out, {cur_bits}).as(round_ty));
     }
 
     // 1 bit info in lsb
@@ -373,6 +376,23 @@ NdArrayRef eqz(KernelEvalContext* ctx, const NdArrayRef& in) {
   return out;
 }
 
+NdArrayRef RingCastS::proc(KernelEvalContext*, const NdArrayRef& in,
+                           const Type& to_type) const {
+  const auto field = in.eltype().as<Ring2k>()->field();
+  const auto to_field = to_type.as<Ring2k>()->field();
+
+  if (in.eltype().isa<BShrTy>()) {
+    const size_t nbits = std::min(in.eltype().as<BShrTy>()->nbits(),
+                                  SizeOf(to_field) * 8);
+    return ring_cast(in, to_field).as(makeType<BShrTy>(to_field, nbits));
+  }
+
+  SPU_ENFORCE(SizeOf(to_field) <= SizeOf(field),
+              "arithmetic share could only be narrowed, from={}, to={}", field,
+              to_field);
+  return ring_cast(in, to_field).as(makeType<AShrTy>(to_field));
+}
+
 NdArrayRef EqualAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                          const NdArrayRef& rhs) const {
   const auto* lhs_ty = lhs.eltype().as<AShrTy>();
@@ -100,13 +100,25 @@ class MsbA2B : public UnaryKernel {
 
   ce::CExpr comm() const override {
     // 1 * and_bb: 2 * k * (N-1)
-    // 1 * carrya2b: k + k/2 + k/4 + ... + 8 (8) + 8 (4) + 8 (2) + 8 (1)
-    return 2 * ce::K() * (ce::N() - 1) + 2 * (ce::N() - 1) * (2 * ce::K() + 32);
+    // 1 * carrya2b: 2 * 2 * (k/2 + k/4 + ... + 1) * (N-1)
+    return 2 * ce::K() * (ce::N() - 1) + 4 * (ce::K() - 1) * (ce::N() - 1);
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& in) const override;
 };
 
+class RingCastS : public CastTypeKernel {
+ public:
+  static constexpr const char* kBindName() { return "ring_cast_s"; }
+
+  ce::CExpr latency() const override { return ce::Const(0); }
+
+  ce::CExpr comm() const override { return ce::Const(0); }
+
+  NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& in,
+                  const Type& to_type) const override;
+};
+
 class EqualAA : public BinaryKernel {
  public:
   static constexpr const char* kBindName() { return "equal_aa"; }
@@ -117,7 +129,9 @@ class EqualAA : public BinaryKernel {
   }
 
   ce::CExpr comm() const override {
-    return (2 * Log(ce::K()) + 1) * ce::K() * (ce::N() - 1);
+    // reveal: k * (N-1)
+    // log(k) * and_bb: 2 * (k/2 + k/4 + ... + 1) * (N-1)
+    return (3 * ce::K() - 2) * (ce::N() - 1);
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
@@ -134,7 +148,9 @@ class EqualAP : public BinaryKernel {
   }
 
   ce::CExpr comm() const override {
-    return (2 * Log(ce::K()) + 1) * ce::K() * (ce::N() - 1);
+    // reveal: k * (N-1)
+    // log(k) * and_bb: 2 * (k/2 + k/4 + ... + 1) * (N-1)
+    return (3 * ce::K() - 2) * (ce::N() - 1);
   }
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
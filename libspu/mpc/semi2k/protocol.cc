@@ -34,10 +34,14 @@ void regSemi2kProtocol(SPUContext* ctx,
   semi2k::registerTypes();
 
   // add communicator
-  ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->addState<Communicator>(
+      lctx, ctx->config().experimental_enable_comm_coalescing());
+  ctx->prot()->getState<Communicator>()->setRecorder(
+      openCommTranscript(ctx->config(), *lctx));
 
   // register random states & kernels.
-  ctx->prot()->addState<PrgState>(lctx);
+  ctx->prot()->addState<PrgState>(
+      lctx, ctx->config().experimental_enable_prg_prefetch());
 
   // add Z2k state.
   ctx->prot()->addState<Z2kState>(ctx->config().field());
@@ -69,7 +73,7 @@ void regSemi2kProtocol(SPUContext* ctx,
           semi2k::RandA, semi2k::RandB,                                 //
           semi2k::RandPermM, semi2k::PermAM, semi2k::PermAP,            //
           semi2k::InvPermAM, semi2k::InvPermAP, semi2k::InvPermAV,      //
-          semi2k::EqualAA, semi2k::EqualAP,                             //
+          semi2k::EqualAA, semi2k::EqualAP, semi2k::RingCastS,          //
           semi2k::BeaverCacheKernel>();
 
   if (ctx->config().trunc_allow_msb_error()) {
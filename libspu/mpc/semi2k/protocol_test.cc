@@ -118,6 +118,20 @@ INSTANTIATE_TEST_SUITE_P(
       ;
     });
 
+// The same suite over emulated LAN links.
+INSTANTIATE_TEST_SUITE_P(
+    Semi2kLan, ArithmeticTest,
+    testing::Combine(
+        testing::Values(withNetwork(CreateObjectFn(makeSemi2kProtocol, "tfp"),
+                                    utils::NetworkProfile::parse("lan"),
+                                    "lan")),
+        testing::Values(makeConfig(FieldType::FM64)),  //
+        testing::Values(3)),                           //
+    [](const testing::TestParamInfo<ArithmeticTest::ParamType>& p) {
+      return fmt::format("{}x{}x{}", std::get<0>(p.param).name(),
+                         std::get<1>(p.param).field(), std::get<2>(p.param));
+    });
+
 INSTANTIATE_TEST_SUITE_P(
     Semi2k, BooleanTest,
     testing::Combine(testing::Values(CreateObjectFn(makeSemi2kProtocol, "tfp"),
@@ -580,6 +594,62 @@ TEST_P(BeaverCacheTest, ExpA) {
   });
 }
 
+TEST(Semi2kCommTest, MulAACoalescesOpens) {
+  RuntimeConfig conf = makeConfig(FieldType::FM64);
+  conf.set_experimental_enable_comm_coalescing(true);
+  const size_t npc = 3;
+  const Shape shape = {7, 11};
+
+  utils::simulate(npc, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+    auto obj = makeSemi2kProtocol(conf, lctx);
+    auto* comm = obj->prot()->getState<Communicator>();
+
+    auto p0 = rand_p(obj.get(), shape);
+    auto p1 = rand_p(obj.get(), shape);
+    auto a0 = p2a(obj.get(), p0);
+    auto a1 = p2a(obj.get(), p1);
+
+    auto prev = comm->getStats();
+    auto r = mul_aa(obj.get(), a0, a1);
+    auto cost = comm->getStats() - prev;
+
+    // x-a and y-b go to every peer in one message.
+    EXPECT_EQ(cost.latency, 1U);
+    EXPECT_EQ(cost.logical_msgs, 2 * (npc - 1));
+    EXPECT_EQ(cost.physical_msgs, npc - 1);
+    EXPECT_LT(cost.physical_msgs, cost.logical_msgs);
+
+    auto got = a2p(obj.get(), r);
+    auto expected = mul_pp(obj.get(), p0, p1);
+    EXPECT_TRUE(ring_all_equal(got.data(), expected.data()));
+  });
+}
+
+TEST(Semi2kBooleanTest, NarrowAndThenWideXor) {
+  const RuntimeConfig conf = makeConfig(FieldType::FM64);
+  const Shape shape = {10, 11};
+
+  utils::simulate(2, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+    auto obj = makeSemi2kProtocol(conf, lctx);
+
+    auto p0 = rand_p(obj.get(), shape);
+    auto p1 = rand_p(obj.get(), shape);
+    auto p2 = rand_p(obj.get(), shape);
+
+    // 20 bit shares, which do not fill their uint32 backtype.
+    auto b0 = rshift_b(obj.get(), p2b(obj.get(), p0), {44});
+    auto b1 = rshift_b(obj.get(), p2b(obj.get(), p1), {44});
+    auto narrow = and_bb(obj.get(), b0, b1);
+    auto r = xor_bb(obj.get(), narrow, p2b(obj.get(), p2));
+
+    auto expected = xor_pp(obj.get(),
+                           and_pp(obj.get(), rshift_p(obj.get(), p0, {44}),
+                                  rshift_p(obj.get(), p1, {44})),
+                           p2);
+    EXPECT_TRUE(ring_all_equal(b2p(obj.get(), r).data(), expected.data()));
+  });
+}
+
 using LowMCTestParams =
     std::tuple<CreateObjectFn, RuntimeConfig, FieldType, size_t>;
 
@@ -33,6 +33,8 @@ void regSpdz2kProtocol(SPUContext* ctx,
 
   // add communicator
   ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->getState<Communicator>()->setRecorder(
+      openCommTranscript(ctx->config(), *lctx));
 
   // register random states & kernels.
   ctx->prot()->addState<PrgState>(lctx);
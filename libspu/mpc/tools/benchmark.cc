@@ -62,6 +62,11 @@ llvm::cl::opt<uint32_t> cli_shiftbit(
 llvm::cl::opt<uint32_t> cli_iteration(
     "iteration", llvm::cl::init(10),
     llvm::cl::desc("benchmark iteration, default: 10"));
+llvm::cl::opt<std::string> cli_network(
+    "network", llvm::cl::init(""),
+    llvm::cl::desc("emulated network of standalone mode: lan / wan, or "
+                   "latency_ms=20,bandwidth_mbps=300,jitter_ms=1,overhead=64, "
+                   "default: none"));
 llvm::cl::opt<std::string> cli_mode(
     "mode", llvm::cl::init("standalone"),
     llvm::cl::desc(
@@ -285,6 +290,15 @@ void SetUpMode() {
   }
   BenchInteral::bench_mode = mode;
   benchmark::AddCustomContext("Benchmark Mode", BenchInteral::bench_mode);
+
+  if (!cli_network.getValue().empty()) {
+    SPU_ENFORCE(mode == "standalone",
+                "network emulation only works in standalone mode");
+    BenchInteral::bench_network =
+        spu::mpc::utils::NetworkProfile::parse(cli_network.getValue());
+    benchmark::AddCustomContext("Benchmark Network",
+                                BenchInteral::bench_network.toString());
+  }
 }
 
 void PrepareBenchmark() {
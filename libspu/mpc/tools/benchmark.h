@@ -24,6 +24,7 @@
 #include "libspu/mpc/ab_api.h"
 #include "libspu/mpc/api.h"
 #include "libspu/mpc/common/communicator.h"
+#include "libspu/mpc/utils/network_emulator.h"
 #include "libspu/mpc/utils/ring_ops.h"
 #include "libspu/mpc/utils/simulate.h"
 
@@ -47,6 +48,8 @@ class BenchConfig {
   inline static uint32_t bench_npc = 0;
   inline static std::string bench_mode = "standalone";
   inline static std::string bench_parties = {};
+  // Emulated links between the in process parties of standalone mode.
+  inline static utils::NetworkProfile bench_network = {};
   inline static std::vector<int64_t> bench_numel_range = {1U << 10, 1U << 20};
   inline static std::vector<int64_t> bench_shift_range = {2};
   inline static std::vector<int64_t> bench_matrix_range = {10, 100};
@@ -112,7 +115,7 @@ void MPCBenchMark(benchmark::State& state) {
     };
 
     if (BenchConfig::bench_mode == "standalone") {
-      utils::simulate(npc, func);
+      utils::simulate(npc, BenchConfig::bench_network, func);
     } else {
       func(BenchConfig::bench_lctx);
     }
@@ -0,0 +1,197 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/utils/comm_transcript.h"
+
+#include <cstring>
+#include <iterator>
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::utils {
+namespace {
+
+constexpr char kMagic[] = "SPUCOMM";
+constexpr uint8_t kVersion = 1;
+
+template <typename T>
+void writePod(std::ofstream& out, T v) {
+  out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+T readPod(const char*& pos, const char* end) {
+  SPU_ENFORCE(pos + sizeof(T) <= end, "truncated transcript");
+  T v;
+  std::memcpy(&v, pos, sizeof(T));
+  pos += sizeof(T);
+  return v;
+}
+
+std::string_view readBytes(const char*& pos, const char* end, size_t size) {
+  SPU_ENFORCE(pos + size <= end, "truncated transcript");
+  std::string_view res(pos, size);
+  pos += size;
+  return res;
+}
+
+std::string_view eventName(CommEvent event) {
+  switch (event) {
+    case CommEvent::kChannel:
+      return "channel";
+    case CommEvent::kSend:
+      return "send";
+    case CommEvent::kRecv:
+      return "recv";
+    case CommEvent::kCollective:
+      return "collective";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+CommTranscriptWriter::CommTranscriptWriter(const std::string& path,
+                                           size_t rank, size_t world_size,
+                                           bool with_payload)
+    : out_(path, std::ios::binary | std::ios::trunc),
+      with_payload_(with_payload) {
+  SPU_ENFORCE(out_.is_open(), "can not open transcript {}", path);
+  out_.write(kMagic, sizeof(kMagic) - 1);
+  writePod<uint8_t>(out_, kVersion);
+  writePod<uint32_t>(out_, rank);
+  writePod<uint32_t>(out_, world_size);
+  writePod<uint8_t>(out_, with_payload);
+}
+
+void CommTranscriptWriter::append(
+    std::string_view channel, CommEvent event, size_t peer,
+    std::string_view tag, absl::Span<const yacl::ByteContainerView> bufs) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto itr = channels_.find(channel);
+  if (itr == channels_.end()) {
+    const uint32_t id = channels_.size();
+    itr = channels_.emplace(std::string(channel), id).first;
+    writePod<uint8_t>(out_, static_cast<uint8_t>(CommEvent::kChannel));
+    writePod<uint32_t>(out_, id);
+    writePod<uint32_t>(out_, kNoPeer);
+    writePod<uint32_t>(out_, channel.size());
+    out_.write(channel.data(), channel.size());
+    writePod<uint32_t>(out_, 0);
+  }
+
+  writePod<uint8_t>(out_, static_cast<uint8_t>(event));
+  writePod<uint32_t>(out_, itr->second);
+  writePod<uint32_t>(out_, peer);
+  writePod<uint32_t>(out_, tag.size());
+  out_.write(tag.data(), tag.size());
+  writePod<uint32_t>(out_, bufs.size());
+  for (const auto& buf : bufs) {
+    writePod<uint64_t>(out_, buf.size());
+    if (with_payload_) {
+      out_.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+    }
+  }
+  SPU_ENFORCE(out_.good(), "failed to write transcript");
+}
+
+CommTranscriptReader::CommTranscriptReader(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  SPU_ENFORCE(in.is_open(), "can not open transcript {}", path);
+  const std::string content((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+
+  const char* pos = content.data();
+  const char* end = pos + content.size();
+  SPU_ENFORCE(readBytes(pos, end, sizeof(kMagic) - 1) == kMagic,
+              "{} is not a transcript", path);
+  const auto version = readPod<uint8_t>(pos, end);
+  SPU_ENFORCE(version == kVersion, "unsupported transcript version {}",
+              version);
+  rank_ = readPod<uint32_t>(pos, end);
+  world_size_ = readPod<uint32_t>(pos, end);
+  has_payload_ = readPod<uint8_t>(pos, end) != 0;
+
+  std::vector<std::deque<Record>*> channels;
+  while (pos < end) {
+    const auto event = static_cast<CommEvent>(readPod<uint8_t>(pos, end));
+    const auto channel = readPod<uint32_t>(pos, end);
+    Record record;
+    record.event = event;
+    record.peer = readPod<uint32_t>(pos, end);
+    record.tag = readBytes(pos, end, readPod<uint32_t>(pos, end));
+    const auto count = readPod<uint32_t>(pos, end);
+    for (uint32_t idx = 0; idx < count; idx++) {
+      const auto size = readPod<uint64_t>(pos, end);
+      record.sizes.push_back(size);
+      if (has_payload_) {
+        const auto payload = readBytes(pos, end, size);
+        record.bufs.emplace_back(payload.data(), payload.size());
+      }
+    }
+
+    if (event == CommEvent::kChannel) {
+      SPU_ENFORCE(channel == channels.size(), "corrupted transcript");
+      channels.push_back(&channels_[record.tag]);
+    } else {
+      SPU_ENFORCE(channel < channels.size(), "corrupted transcript");
+      channels[channel]->push_back(std::move(record));
+    }
+  }
+}
+
+std::vector<yacl::Buffer> CommTranscriptReader::next(std::string_view channel,
+                                                     CommEvent event,
+                                                     size_t peer,
+                                                     std::string_view tag) {
+  Record record;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto itr = channels_.find(channel);
+    SPU_ENFORCE(itr != channels_.end() && !itr->second.empty(),
+                "transcript of channel '{}' ends before {} tag={}", channel,
+                eventName(event), tag);
+    record = std::move(itr->second.front());
+    itr->second.pop_front();
+  }
+
+  SPU_ENFORCE(record.event == event && record.peer == peer && record.tag == tag,
+              "transcript diverged on channel '{}', expect {} peer={} tag={}, "
+              "got {} peer={} tag={}",
+              channel, eventName(record.event), record.peer, record.tag,
+              eventName(event), peer, tag);
+
+  if (has_payload_) {
+    return std::move(record.bufs);
+  }
+  std::vector<yacl::Buffer> res;
+  for (const auto size : record.sizes) {
+    yacl::Buffer buf(size);
+    std::memset(buf.data(), 0, size);
+    res.push_back(std::move(buf));
+  }
+  return res;
+}
+
+size_t CommTranscriptReader::remaining() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  size_t res = 0;
+  for (const auto& [_, records] : channels_) {
+    res += records.size();
+  }
+  return res;
+}
+
+}  // namespace spu::mpc::utils
@@ -0,0 +1,105 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "yacl/base/buffer.h"
+#include "yacl/base/byte_container_view.h"
+
+namespace spu::mpc::utils {
+
+// A transcript is every message one party put on or took off the link, in the
+// order of each channel. A channel is one Communicator, forks get their own.
+//
+// File layout, integers little endian:
+//   header := "SPUCOMM" u8(version) u32(rank) u32(world_size) u8(has_payload)
+//   record := u8(event) u32(channel) u32(peer) u32(tag size) tag
+//             u32(count) { u64(size) [payload] }*count
+// A kChannel record names its channel id in the tag before the id is used.
+// Without payloads only the sizes are kept, replay then yields zero bytes.
+enum class CommEvent : uint8_t {
+  kChannel = 0,
+  kSend = 1,
+  kRecv = 2,
+  kCollective = 3,
+};
+
+// Peer of all-to-all collectives.
+inline constexpr size_t kNoPeer = std::numeric_limits<uint32_t>::max();
+
+class CommTranscriptWriter {
+ public:
+  CommTranscriptWriter(const std::string& path, size_t rank, size_t world_size,
+                       bool with_payload = true);
+
+  // Thread safe, a Communicator and its forks may share one writer.
+  void append(std::string_view channel, CommEvent event, size_t peer,
+              std::string_view tag,
+              absl::Span<const yacl::ByteContainerView> bufs);
+
+ private:
+  std::mutex mutex_;
+  std::ofstream out_;
+  const bool with_payload_;
+  std::map<std::string, uint32_t, std::less<>> channels_;
+};
+
+// Loads a whole transcript, so replay does no file io.
+class CommTranscriptReader {
+ public:
+  explicit CommTranscriptReader(const std::string& path);
+
+  size_t rank() const { return rank_; }
+  size_t worldSize() const { return world_size_; }
+  bool hasPayload() const { return has_payload_; }
+
+  // Pops the next record of `channel`, which must be the same event with the
+  // same peer and tag, and returns its buffers. Thread safe.
+  std::vector<yacl::Buffer> next(std::string_view channel, CommEvent event,
+                                 size_t peer, std::string_view tag);
+
+  // Records not replayed yet.
+  size_t remaining() const;
+
+ private:
+  struct Record {
+    CommEvent event;
+    size_t peer;
+    std::string tag;
+    std::vector<int64_t> sizes;
+    // Empty without payloads.
+    std::vector<yacl::Buffer> bufs;
+  };
+
+  size_t rank_ = 0;
+  size_t world_size_ = 0;
+  bool has_payload_ = false;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::deque<Record>, std::less<>> channels_;
+};
+
+}  // namespace spu::mpc::utils
@@ -0,0 +1,88 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/utils/comm_transcript.h"
+
+#include "gtest/gtest.h"
+
+namespace spu::mpc::utils {
+
+namespace {
+
+std::string toString(const yacl::Buffer& buf) {
+  return std::string(buf.data<char>(), buf.size());
+}
+
+void writeTranscript(const std::string& path, bool with_payload) {
+  CommTranscriptWriter writer(path, 1, 3, with_payload);
+  const std::string hello = "hello";
+  const std::string world = "world!";
+  writer.append("", CommEvent::kSend, 0, "a", {hello});
+  writer.append("/0", CommEvent::kRecv, 2, "b", {world});
+  writer.append("", CommEvent::kCollective, kNoPeer, "c", {hello, world});
+}
+
+}  // namespace
+
+TEST(CommTranscript, RoundTrip) {
+  const auto path = ::testing::TempDir() + "comm_transcript_round_trip";
+  writeTranscript(path, true);
+
+  CommTranscriptReader reader(path);
+  EXPECT_EQ(reader.rank(), 1U);
+  EXPECT_EQ(reader.worldSize(), 3U);
+  EXPECT_TRUE(reader.hasPayload());
+  EXPECT_EQ(reader.remaining(), 3U);
+
+  // Channels replay independently.
+  auto recv = reader.next("/0", CommEvent::kRecv, 2, "b");
+  ASSERT_EQ(recv.size(), 1U);
+  EXPECT_EQ(toString(recv[0]), "world!");
+
+  auto send = reader.next("", CommEvent::kSend, 0, "a");
+  ASSERT_EQ(send.size(), 1U);
+  EXPECT_EQ(toString(send[0]), "hello");
+
+  auto all = reader.next("", CommEvent::kCollective, kNoPeer, "c");
+  ASSERT_EQ(all.size(), 2U);
+  EXPECT_EQ(toString(all[0]), "hello");
+  EXPECT_EQ(toString(all[1]), "world!");
+
+  EXPECT_EQ(reader.remaining(), 0U);
+  EXPECT_ANY_THROW(reader.next("", CommEvent::kSend, 0, "a"));
+}
+
+TEST(CommTranscript, SizeOnly) {
+  const auto path = ::testing::TempDir() + "comm_transcript_size_only";
+  writeTranscript(path, false);
+
+  CommTranscriptReader reader(path);
+  EXPECT_FALSE(reader.hasPayload());
+
+  auto send = reader.next("", CommEvent::kSend, 0, "a");
+  ASSERT_EQ(send.size(), 1U);
+  EXPECT_EQ(toString(send[0]), std::string(5, '\0'));
+}
+
+TEST(CommTranscript, Diverged) {
+  const auto path = ::testing::TempDir() + "comm_transcript_diverged";
+  writeTranscript(path, true);
+
+  CommTranscriptReader reader(path);
+  EXPECT_ANY_THROW(reader.next("", CommEvent::kSend, 0, "b"));
+  EXPECT_ANY_THROW(reader.next("", CommEvent::kRecv, 0, "c"));
+  EXPECT_ANY_THROW(reader.next("/1", CommEvent::kRecv, 2, "b"));
+}
+
+}  // namespace spu::mpc::utils
@@ -14,4 +14,268 @@
 
 #include "libspu/mpc/utils/linalg.h"
 
-namespace spu::mpc::linalg::detail {}  // namespace spu::mpc::linalg::detail
+#include <algorithm>
+#include <memory>
+
+#include "yacl/utils/parallel.h"
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace spu::mpc::linalg::detail {
+
+namespace {
+
+// Register tile of the micro kernels, kNR is one 512 bit vector of uint64.
+constexpr int64_t kMR = 4;
+constexpr int64_t kNR = 8;
+
+// Cache blocks, a packed (kMC, kKC) block of A stays in L2 while the kernels
+// stream over a packed (kKC, kNC) panel of B.
+constexpr int64_t kMC = 64;
+constexpr int64_t kKC = 256;
+constexpr int64_t kNC = 512;
+
+int64_t roundUp(int64_t x, int64_t multiple) {
+  return (x + multiple - 1) / multiple * multiple;
+}
+
+// Packs rows [0, mc) and depth [0, kc) of A into slivers of kMR rows, a sliver
+// stores its kMR elements of each depth together. Missing rows are zero.
+template <typename T>
+void packA(int64_t mc, int64_t kc, const T* A, int64_t LDA, int64_t IDA,
+           T* buf) {
+  for (int64_t i = 0; i < mc; i += kMR) {
+    for (int64_t p = 0; p < kc; ++p) {
+      for (int64_t r = 0; r < kMR; ++r) {
+        *buf++ = i + r < mc ? A[(i + r) * LDA + p * IDA] : T(0);
+      }
+    }
+  }
+}
+
+// Packs depth [0, kc) and columns [0, nc) of B into slivers of kNR columns.
+template <typename T>
+void packB(int64_t kc, int64_t nc, const T* B, int64_t LDB, int64_t IDB,
+           T* buf) {
+  for (int64_t j = 0; j < nc; j += kNR) {
+    for (int64_t p = 0; p < kc; ++p) {
+      for (int64_t c = 0; c < kNR; ++c) {
+        *buf++ = j + c < nc ? B[p * LDB + (j + c) * IDB] : T(0);
+      }
+    }
+  }
+}
+
+// acc := a * b on one pair of packed slivers, acc is a row major kMR x kNR
+// tile.
+template <typename T>
+void kernelGeneric(int64_t kc, const T* a, const T* b, T* acc) {
+  T c[kMR][kNR] = {};
+  for (int64_t p = 0; p < kc; ++p, a += kMR, b += kNR) {
+    for (int64_t r = 0; r < kMR; ++r) {
+      for (int64_t col = 0; col < kNR; ++col) {
+        c[r][col] += a[r] * b[col];
+      }
+    }
+  }
+  std::copy(&c[0][0], &c[0][0] + kMR * kNR, acc);
+}
+
+#ifdef __x86_64__
+
+// Same loops as kernelGeneric, compiled for AVX2 so 32 bit lanes vectorize.
+__attribute__((target("avx2"))) void kernelU32Avx2(int64_t kc,
+                                                   const uint32_t* a,
+                                                   const uint32_t* b,
+                                                   uint32_t* acc) {
+  kernelGeneric(kc, a, b, acc);
+}
+
+// There is no cheap 64 bit lane multiply, vpmullq is several uops on AVX-512
+// and missing on AVX2. With 32 bit halves x = xh * 2^32 + xl, modulo 2^64
+//   a * b = al * bl + (ah * bl + al * bh) * 2^32
+// the cross terms accumulate unshifted and take one shift per tile, which
+// leaves three vpmuludq and three adds per lane product.
+// The zero masked forms, the plain ones trip -Wmaybe-uninitialized on their
+// undefined pass-through operand with gcc 12.
+constexpr __mmask8 kAllLanes = 0xFF;
+
+__attribute__((target("avx512f"))) void kernelU64Avx512(int64_t kc,
+                                                        const uint64_t* a,
+                                                        const uint64_t* b,
+                                                        uint64_t* acc) {
+  __m512i low[kMR];
+  __m512i cross[kMR];
+  for (int64_t r = 0; r < kMR; ++r) {
+    low[r] = _mm512_setzero_si512();
+    cross[r] = _mm512_setzero_si512();
+  }
+  for (int64_t p = 0; p < kc; ++p, a += kMR, b += kNR) {
+    const __m512i bl = _mm512_loadu_si512(b);
+    const __m512i bh = _mm512_maskz_srli_epi64(kAllLanes, bl, 32);
+    for (int64_t r = 0; r < kMR; ++r) {
+      const __m512i al = _mm512_set1_epi64(static_cast<int64_t>(a[r]));
+      const __m512i ah = _mm512_set1_epi64(static_cast<int64_t>(a[r] >> 32));
+      low[r] = _mm512_add_epi64(low[r],
+                                _mm512_maskz_mul_epu32(kAllLanes, al, bl));
+      cross[r] = _mm512_add_epi64(
+          cross[r],
+          _mm512_add_epi64(_mm512_maskz_mul_epu32(kAllLanes, ah, bl),
+                           _mm512_maskz_mul_epu32(kAllLanes, al, bh)));
+    }
+  }
+  for (int64_t r = 0; r < kMR; ++r) {
+    _mm512_storeu_si512(
+        acc + r * kNR,
+        _mm512_add_epi64(low[r],
+                         _mm512_maskz_slli_epi64(kAllLanes, cross[r], 32)));
+  }
+}
+
+// Same as kernelU64Avx512 on two 256 bit halves of the kNR columns.
+__attribute__((target("avx2"))) void kernelU64Avx2(int64_t kc,
+                                                   const uint64_t* a,
+                                                   const uint64_t* b,
+                                                   uint64_t* acc) {
+  __m256i low[kMR][2];
+  __m256i cross[kMR][2];
+  for (int64_t r = 0; r < kMR; ++r) {
+    for (int64_t h = 0; h < 2; ++h) {
+      low[r][h] = _mm256_setzero_si256();
+      cross[r][h] = _mm256_setzero_si256();
+    }
+  }
+  for (int64_t p = 0; p < kc; ++p, a += kMR, b += kNR) {
+    __m256i bl[2];
+    __m256i bh[2];
+    for (int64_t h = 0; h < 2; ++h) {
+      bl[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 4 * h));
+      bh[h] = _mm256_srli_epi64(bl[h], 32);
+    }
+    for (int64_t r = 0; r < kMR; ++r) {
+      const __m256i al = _mm256_set1_epi64x(static_cast<int64_t>(a[r]));
+      const __m256i ah = _mm256_set1_epi64x(static_cast<int64_t>(a[r] >> 32));
+      for (int64_t h = 0; h < 2; ++h) {
+        low[r][h] = _mm256_add_epi64(low[r][h], _mm256_mul_epu32(al, bl[h]));
+        cross[r][h] = _mm256_add_epi64(
+            cross[r][h], _mm256_add_epi64(_mm256_mul_epu32(ah, bl[h]),
+                                          _mm256_mul_epu32(al, bh[h])));
+      }
+    }
+  }
+  for (int64_t r = 0; r < kMR; ++r) {
+    for (int64_t h = 0; h < 2; ++h) {
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(acc + r * kNR + 4 * h),
+          _mm256_add_epi64(low[r][h], _mm256_slli_epi64(cross[r][h], 32)));
+    }
+  }
+}
+
+#endif
+
+template <typename T>
+using KernelFn = void (*)(int64_t, const T*, const T*, T*);
+
+KernelFn<uint32_t> selectKernel(const uint32_t*) {
+#ifdef __x86_64__
+  if (__builtin_cpu_supports("avx2")) {
+    return kernelU32Avx2;
+  }
+#endif
+  return kernelGeneric<uint32_t>;
+}
+
+KernelFn<uint64_t> selectKernel(const uint64_t*) {
+#ifdef __x86_64__
+  if (__builtin_cpu_supports("avx512f")) {
+    return kernelU64Avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return kernelU64Avx2;
+  }
+#endif
+  return kernelGeneric<uint64_t>;
+}
+
+template <typename T>
+void gemm(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+          int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+          int64_t LDC, int64_t IDC) {
+  if (M == 0 || N == 0) {
+    return;
+  }
+  if (K == 0) {
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t j = 0; j < N; ++j) {
+        C[i * LDC + j * IDC] = T(0);
+      }
+    }
+    return;
+  }
+
+  static const KernelFn<T> kernel = selectKernel(static_cast<const T*>(nullptr));
+
+  const int64_t m_tiles = (M + kMC - 1) / kMC;
+  const int64_t n_tiles = (N + kNC - 1) / kNC;
+
+  // Packed blocks are no larger than the operands, rounded up to whole
+  // slivers. Packing writes every element, so the buffers are not zeroed.
+  const int64_t a_size = roundUp(std::min(M, kMC), kMR) * std::min(K, kKC);
+  const int64_t b_size = roundUp(std::min(N, kNC), kNR) * std::min(K, kKC);
+
+  // Every task owns whole (kMC, kNC) tiles of C, so no two tasks write the
+  // same element.
+  yacl::parallel_for(0, m_tiles * n_tiles, 1, [&](int64_t begin, int64_t end) {
+    std::unique_ptr<T[]> a_buf(new T[a_size]);
+    std::unique_ptr<T[]> b_buf(new T[b_size]);
+    T acc[kMR * kNR];
+
+    for (int64_t tile = begin; tile < end; ++tile) {
+      const int64_t i0 = (tile / n_tiles) * kMC;
+      const int64_t j0 = (tile % n_tiles) * kNC;
+      const int64_t mc = std::min(kMC, M - i0);
+      const int64_t nc = std::min(kNC, N - j0);
+
+      for (int64_t p0 = 0; p0 < K; p0 += kKC) {
+        const int64_t kc = std::min(kKC, K - p0);
+        packA(mc, kc, A + i0 * LDA + p0 * IDA, LDA, IDA, a_buf.get());
+        packB(kc, nc, B + p0 * LDB + j0 * IDB, LDB, IDB, b_buf.get());
+
+        for (int64_t j = 0; j < nc; j += kNR) {
+          for (int64_t i = 0; i < mc; i += kMR) {
+            kernel(kc, a_buf.get() + i * kc, b_buf.get() + j * kc, acc);
+
+            const int64_t rows = std::min(kMR, mc - i);
+            const int64_t cols = std::min(kNR, nc - j);
+            for (int64_t r = 0; r < rows; ++r) {
+              T* dst = C + (i0 + i + r) * LDC + (j0 + j) * IDC;
+              for (int64_t col = 0; col < cols; ++col) {
+                dst[col * IDC] = p0 == 0 ? acc[r * kNR + col]
+                                         : dst[col * IDC] + acc[r * kNR + col];
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+void matmul_ring(int64_t M, int64_t N, int64_t K, const uint32_t* A,
+                 int64_t LDA, int64_t IDA, const uint32_t* B, int64_t LDB,
+                 int64_t IDB, uint32_t* C, int64_t LDC, int64_t IDC) {
+  gemm(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+}
+
+void matmul_ring(int64_t M, int64_t N, int64_t K, const uint64_t* A,
+                 int64_t LDA, int64_t IDA, const uint64_t* B, int64_t LDB,
+                 int64_t IDB, uint64_t* C, int64_t LDC, int64_t IDC) {
+  gemm(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+}
+
+}  // namespace spu::mpc::linalg::detail
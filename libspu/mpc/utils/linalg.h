@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cstddef>
+#include <type_traits>
 
 #define EIGEN_HAS_OPENMP
 
@@ -22,27 +23,12 @@
 
 namespace spu::mpc::linalg {
 
-/**
- * @brief C := op( A )*op( B )
- *
- * @tparam T Type of A, B, C
- * @param M   Number of rows in A
- * @param N   Number of columns in B
- * @param K   Number of columns in A and number of rows in B
- * @param A   Pointer to A
- * @param LDA Leading dimension stride of A
- * @param IDA Inner dimension stride of A
- * @param B   Pointer to B
- * @param LDB Leading dimension stride of B
- * @param IDB Inner dimension stride of B
- * @param C   Pointer to C
- * @param LDC Leading dimension stride of C
- * @param IDC Inner dimension stride of C
- */
+namespace detail {
+
 template <typename T>
-void matmul(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
-            int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
-            int64_t LDC, int64_t IDC) {
+void matmul_eigen(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+                  int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+                  int64_t LDC, int64_t IDC) {
   using StrideT = Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>;
   using MapMatrixConstT = Eigen::Map<
       const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
@@ -91,4 +77,45 @@ void matmul(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
   c.noalias() = a * b;
 }
 
+// Packed and cache blocked GEMM on 2^k rings, products and sums wrap around.
+// Tiles of C are computed in parallel and use AVX-512 or AVX2 when the cpu has
+// them. 128 bit rings stay on Eigen, whose scalar kernel is already faster
+// than a limb decomposition.
+void matmul_ring(int64_t M, int64_t N, int64_t K, const uint32_t* A,
+                 int64_t LDA, int64_t IDA, const uint32_t* B, int64_t LDB,
+                 int64_t IDB, uint32_t* C, int64_t LDC, int64_t IDC);
+void matmul_ring(int64_t M, int64_t N, int64_t K, const uint64_t* A,
+                 int64_t LDA, int64_t IDA, const uint64_t* B, int64_t LDB,
+                 int64_t IDB, uint64_t* C, int64_t LDC, int64_t IDC);
+
+}  // namespace detail
+
+/**
+ * @brief C := op( A )*op( B )
+ *
+ * @tparam T Type of A, B, C
+ * @param M   Number of rows in A
+ * @param N   Number of columns in B
+ * @param K   Number of columns in A and number of rows in B
+ * @param A   Pointer to A
+ * @param LDA Leading dimension stride of A
+ * @param IDA Inner dimension stride of A
+ * @param B   Pointer to B
+ * @param LDB Leading dimension stride of B
+ * @param IDB Inner dimension stride of B
+ * @param C   Pointer to C
+ * @param LDC Leading dimension stride of C
+ * @param IDC Inner dimension stride of C
+ */
+template <typename T>
+void matmul(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+            int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+            int64_t LDC, int64_t IDC) {
+  if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
+    detail::matmul_ring(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+  } else {
+    detail::matmul_eigen(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+  }
+}
+
 }  // namespace spu::mpc::linalg
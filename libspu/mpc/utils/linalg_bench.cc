@@ -0,0 +1,75 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "libspu/mpc/utils/linalg.h"
+
+namespace spu::mpc::linalg {
+
+template <typename T>
+static std::vector<T> makeRandomMatrix(int64_t numel) {
+  std::mt19937_64 rng(numel);
+  std::vector<T> ret(numel);
+  for (auto& v : ret) {
+    v = static_cast<T>(rng());
+  }
+  return ret;
+}
+
+template <typename T, bool kRing>
+static void BM_MatMul(benchmark::State& state) {
+  const int64_t m = state.range(0);
+  const int64_t n = state.range(1);
+  const int64_t k = state.range(2);
+
+  const auto a = makeRandomMatrix<T>(m * k);
+  const auto b = makeRandomMatrix<T>(k * n);
+  std::vector<T> c(m * n);
+
+  for (auto _ : state) {
+    if constexpr (kRing) {
+      detail::matmul_ring(m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(),
+                          n, 1);
+    } else {
+      detail::matmul_eigen(m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(),
+                           n, 1);
+    }
+    benchmark::DoNotOptimize(c.data());
+  }
+}
+
+static void makeMatMulArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"m", "n", "k"});
+  // square
+  b->Args({256, 256, 256})->Args({1024, 1024, 1024});
+  // small, smaller than one cache block
+  b->Args({4, 4, 4})->Args({16, 16, 16})->Args({64, 64, 64});
+  // skinny, e.g. matrix vector products and narrow layers
+  b->Args({1024, 1, 1024})->Args({1, 1024, 1024})->Args({4096, 16, 64});
+  b->Args({16, 4096, 64})->Args({64, 64, 16384});
+  b->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_MatMul<uint32_t, true>)->Apply(makeMatMulArgs);
+BENCHMARK(BM_MatMul<uint32_t, false>)->Apply(makeMatMulArgs);
+BENCHMARK(BM_MatMul<uint64_t, true>)->Apply(makeMatMulArgs);
+BENCHMARK(BM_MatMul<uint64_t, false>)->Apply(makeMatMulArgs);
+
+}  // namespace spu::mpc::linalg
+
+BENCHMARK_MAIN();
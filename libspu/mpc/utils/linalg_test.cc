@@ -14,6 +14,9 @@
 
 #include "libspu/mpc/utils/linalg.h"
 
+#include <cstdint>
+#include <random>
+#include <tuple>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -52,4 +55,46 @@ TEST(LinalgTest, MatMulStrides) {
   EXPECT_EQ(C, expected);
 }
 
+template <typename T>
+class LinalgRingTest : public ::testing::Test {};
+
+using RingTypes = ::testing::Types<uint32_t, uint64_t>;
+TYPED_TEST_SUITE(LinalgRingTest, RingTypes);
+
+TYPED_TEST(LinalgRingTest, MatMulWrapAround) {
+  using T = TypeParam;
+  std::mt19937_64 rng(42);
+
+  // Sizes straddle the register and cache blocks of the ring kernel.
+  const std::vector<std::tuple<int64_t, int64_t, int64_t>> shapes = {
+      {1, 1, 1}, {3, 7, 5}, {65, 9, 257}, {70, 520, 300}, {5, 4, 0}};
+  for (const auto& [M, N, K] : shapes) {
+    for (int64_t s : {1, 2}) {
+      std::vector<T> A(M * K * s);
+      std::vector<T> B(K * N * s);
+      for (auto& v : A) {
+        v = static_cast<T>(rng());
+      }
+      for (auto& v : B) {
+        v = static_cast<T>(rng());
+      }
+      std::vector<T> C(M * N * s, T(1));
+
+      matmul(M, N, K, A.data(), K * s, s, B.data(), N * s, s, C.data(), N * s,
+             s);
+
+      for (int64_t i = 0; i < M; ++i) {
+        for (int64_t j = 0; j < N; ++j) {
+          T expected = 0;
+          for (int64_t p = 0; p < K; ++p) {
+            expected += A[(i * K + p) * s] * B[(p * N + j) * s];
+          }
+          ASSERT_EQ(C[(i * N + j) * s], expected)
+              << "M=" << M << " N=" << N << " K=" << K << " s=" << s;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace spu::mpc::linalg
@@ -0,0 +1,198 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/utils/network_emulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "fmt/format.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::utils {
+namespace {
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double parseDouble(std::string_view key, std::string_view value) {
+  double res = 0;
+  SPU_ENFORCE(absl::SimpleAtod(value, &res) && res >= 0,
+              "invalid network profile {}={}", key, value);
+  return res;
+}
+
+thread_local std::shared_ptr<EmulatedNetwork> tls_network;
+
+}  // namespace
+
+NetworkProfile NetworkProfile::parse(std::string_view spec) {
+  NetworkProfile res;
+  if (spec.empty() || spec == "none") {
+    return res;
+  }
+
+  for (std::string_view item : absl::StrSplit(spec, ',', absl::SkipEmpty())) {
+    std::vector<std::string_view> kv = absl::StrSplit(item, '=');
+    if (kv.size() == 1) {
+      // wan mirrors the tc example of libspu/mpc/tools/README.md.
+      if (kv[0] == "lan") {
+        res.latency_ms = 0.1;
+        res.bandwidth_mbps = 10000;
+      } else if (kv[0] == "wan") {
+        res.latency_ms = 20;
+        res.bandwidth_mbps = 300;
+      } else {
+        SPU_THROW("unknown network preset {}, supported = lan/wan", kv[0]);
+      }
+      continue;
+    }
+
+    SPU_ENFORCE(kv.size() == 2, "invalid network profile item {}", item);
+    const auto key = kv[0];
+    const auto value = kv[1];
+    if (key == "latency_ms") {
+      res.latency_ms = parseDouble(key, value);
+    } else if (key == "jitter_ms") {
+      res.jitter_ms = parseDouble(key, value);
+    } else if (key == "bandwidth_mbps") {
+      res.bandwidth_mbps = parseDouble(key, value);
+    } else if (key == "overhead") {
+      SPU_ENFORCE(absl::SimpleAtoi(value, &res.per_message_overhead) &&
+                      res.per_message_overhead >= 0,
+                  "invalid network profile {}={}", key, value);
+    } else if (key == "seed") {
+      SPU_ENFORCE(absl::SimpleAtoi(value, &res.seed),
+                  "invalid network profile {}={}", key, value);
+    } else {
+      SPU_THROW("unknown network profile key {}", key);
+    }
+  }
+  return res;
+}
+
+std::string NetworkProfile::toString() const {
+  return fmt::format(
+      "latency_ms={},jitter_ms={},bandwidth_mbps={},overhead={},seed={}",
+      latency_ms, jitter_ms, bandwidth_mbps, per_message_overhead, seed);
+}
+
+NetworkEmulator::NetworkEmulator(const NetworkProfile& profile, size_t rank)
+    : profile_(profile), jitter_rng_(profile.seed ^ rank) {}
+
+int64_t NetworkEmulator::transferTimeNs(int64_t bytes) const {
+  if (profile_.bandwidth_mbps <= 0) {
+    return 0;
+  }
+  // bits / (Mbit/s) gives microseconds.
+  return static_cast<int64_t>(static_cast<double>(bytes) * 8 * 1000 /
+                              profile_.bandwidth_mbps);
+}
+
+int64_t NetworkEmulator::latencyNs() {
+  double ms = profile_.latency_ms;
+  if (profile_.jitter_ms > 0) {
+    ms += std::uniform_real_distribution<double>(0, profile_.jitter_ms)(
+        jitter_rng_);
+  }
+  return static_cast<int64_t>(ms * 1000 * 1000);
+}
+
+int64_t NetworkEmulator::send(size_t dst_rank, int64_t bytes) {
+  auto& link_free = link_free_ns_[dst_rank];
+  link_free = std::max(link_free, nowNs()) +
+              transferTimeNs(bytes + profile_.per_message_overhead);
+
+  // Jitter must not let a message overtake an earlier one on the same link.
+  auto& deadline = last_deadline_ns_[dst_rank];
+  deadline = std::max(deadline, link_free + latencyNs());
+  return deadline;
+}
+
+void NetworkEmulator::waitUntil(int64_t deadline_ns) {
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+      std::chrono::nanoseconds(deadline_ns)));
+}
+
+int64_t NetworkEmulator::collective(int64_t bytes) {
+  return nowNs() + transferTimeNs(bytes + profile_.per_message_overhead) +
+         latencyNs();
+}
+
+EmulatedNetwork::EmulatedNetwork(const NetworkProfile& profile,
+                                 size_t world_size)
+    : profile_(profile) {
+  parties_.reserve(world_size);
+  for (size_t rank = 0; rank < world_size; rank++) {
+    parties_.emplace_back(profile, rank);
+  }
+}
+
+void EmulatedNetwork::send(std::string_view link_id, size_t src_rank,
+                           size_t dst_rank, std::string_view tag,
+                           int64_t bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  const int64_t deadline = parties_.at(src_rank).send(dst_rank, bytes);
+  deadlines_[{std::string(link_id), src_rank, dst_rank, std::string(tag)}]
+      .push_back(deadline);
+}
+
+void EmulatedNetwork::recv(std::string_view link_id, size_t src_rank,
+                           size_t dst_rank, std::string_view tag) {
+  int64_t deadline = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = deadlines_.find(
+        {std::string(link_id), src_rank, dst_rank, std::string(tag)});
+    SPU_ENFORCE(iter != deadlines_.end(),
+                "no emulated message from {} to {} with tag {} on link {}",
+                src_rank, dst_rank, tag, link_id);
+    deadline = iter->second.front();
+    iter->second.pop_front();
+    if (iter->second.empty()) {
+      deadlines_.erase(iter);
+    }
+  }
+  NetworkEmulator::waitUntil(deadline);
+}
+
+void EmulatedNetwork::delay(size_t rank, int64_t bytes) {
+  int64_t deadline = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    deadline = parties_.at(rank).collective(bytes);
+  }
+  NetworkEmulator::waitUntil(deadline);
+}
+
+std::shared_ptr<EmulatedNetwork> EmulatedNetwork::current() {
+  return tls_network;
+}
+
+EmulatedNetwork::Scope::Scope(std::shared_ptr<EmulatedNetwork> network)
+    : prev_(std::move(tls_network)) {
+  tls_network = std::move(network);
+}
+
+EmulatedNetwork::Scope::~Scope() { tls_network = std::move(prev_); }
+
+}  // namespace spu::mpc::utils
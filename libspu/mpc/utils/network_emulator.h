@@ -0,0 +1,151 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace spu::mpc::utils {
+
+// Shape of an emulated network link, the same in both directions.
+struct NetworkProfile {
+  // One way delay of every message.
+  double latency_ms = 0;
+
+  // Extra one way delay, uniform in [0, jitter_ms).
+  double jitter_ms = 0;
+
+  // Capacity of every directed link, 0 means unlimited.
+  double bandwidth_mbps = 0;
+
+  // Bytes of headers and framing charged to every message.
+  int64_t per_message_overhead = 0;
+
+  // Seeds the jitter, runs with the same seed see the same delays.
+  uint64_t seed = 0;
+
+  bool enabled() const {
+    return latency_ms > 0 || jitter_ms > 0 || bandwidth_mbps > 0 ||
+           per_message_overhead > 0;
+  }
+
+  // Accepts a preset, "lan" or "wan", optionally followed by overrides, or a
+  // list of overrides alone, e.g.
+  //   "wan"
+  //   "latency_ms=20,bandwidth_mbps=300,jitter_ms=2,overhead=64,seed=1"
+  //   "lan,latency_ms=1"
+  // An empty spec or "none" disables the emulation.
+  static NetworkProfile parse(std::string_view spec);
+
+  std::string toString() const;
+};
+
+// Emulates the links of one party in process. Every party shares the steady
+// clock with its peers, so the sender computes when a message would be fully
+// delivered and the receiver sleeps until then. Messages on one directed link
+// are serialized by its bandwidth and never overtake each other.
+class NetworkEmulator {
+ public:
+  NetworkEmulator(const NetworkProfile& profile, size_t rank);
+
+  const NetworkProfile& profile() const { return profile_; }
+
+  // Books `bytes` on the link to `dst_rank`, returns the delivery deadline in
+  // nanoseconds of the steady clock.
+  int64_t send(size_t dst_rank, int64_t bytes);
+
+  // Blocks until a deadline returned by send.
+  static void waitUntil(int64_t deadline_ns);
+
+  // Returns when `bytes` would have passed this party's link if the transfer
+  // started now, used for collectives that bypass send.
+  int64_t collective(int64_t bytes);
+
+  // Blocks until collective(bytes).
+  void delay(int64_t bytes) { waitUntil(collective(bytes)); }
+
+ private:
+  int64_t transferTimeNs(int64_t bytes) const;
+  int64_t latencyNs();
+
+  const NetworkProfile profile_;
+  std::mt19937_64 jitter_rng_;
+
+  // Per destination, when its link finishes the last booked message, and the
+  // last delivery deadline.
+  std::map<size_t, int64_t> link_free_ns_;
+  std::map<size_t, int64_t> last_deadline_ns_;
+};
+
+// The emulated links of one in process world, shared by all its parties. The
+// delivery deadline of every message is kept here beside the message rather
+// than on the wire, so emulated and real parties speak the same format.
+//
+// A world is only emulated when asked for explicitly, see utils::simulate.
+// Communicators created on a thread of such a party pick the network up, their
+// forks inherit it.
+class EmulatedNetwork {
+ public:
+  EmulatedNetwork(const NetworkProfile& profile, size_t world_size);
+
+  const NetworkProfile& profile() const { return profile_; }
+
+  // Books a message of `bytes` from `src_rank` to `dst_rank`, sent with `tag`
+  // on the link context `link_id`.
+  void send(std::string_view link_id, size_t src_rank, size_t dst_rank,
+            std::string_view tag, int64_t bytes);
+
+  // Blocks until the oldest message booked with the same key is delivered,
+  // called after the message itself has been received.
+  void recv(std::string_view link_id, size_t src_rank, size_t dst_rank,
+            std::string_view tag);
+
+  // See NetworkEmulator::delay.
+  void delay(size_t rank, int64_t bytes);
+
+  // The network of the party running on this thread, null if not emulated.
+  static std::shared_ptr<EmulatedNetwork> current();
+
+  // Sets the network of the current thread for its lifetime.
+  class Scope {
+   public:
+    explicit Scope(std::shared_ptr<EmulatedNetwork> network);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    std::shared_ptr<EmulatedNetwork> prev_;
+  };
+
+ private:
+  const NetworkProfile profile_;
+
+  std::mutex mutex_;
+  std::vector<NetworkEmulator> parties_;
+  using Key = std::tuple<std::string, size_t, size_t, std::string>;
+  std::map<Key, std::deque<int64_t>> deadlines_;
+};
+
+}  // namespace spu::mpc::utils
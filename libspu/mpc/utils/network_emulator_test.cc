@@ -0,0 +1,127 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/utils/network_emulator.h"
+
+#include <chrono>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace spu::mpc::utils {
+
+namespace {
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+TEST(NetworkProfile, Parse) {
+  EXPECT_FALSE(NetworkProfile::parse("").enabled());
+  EXPECT_FALSE(NetworkProfile::parse("none").enabled());
+
+  auto wan = NetworkProfile::parse("wan");
+  EXPECT_DOUBLE_EQ(wan.latency_ms, 20);
+  EXPECT_DOUBLE_EQ(wan.bandwidth_mbps, 300);
+
+  auto p = NetworkProfile::parse(
+      "lan,latency_ms=1.5,jitter_ms=2,overhead=64,seed=7");
+  EXPECT_DOUBLE_EQ(p.latency_ms, 1.5);
+  EXPECT_DOUBLE_EQ(p.jitter_ms, 2);
+  EXPECT_DOUBLE_EQ(p.bandwidth_mbps, 10000);
+  EXPECT_EQ(p.per_message_overhead, 64);
+  EXPECT_EQ(p.seed, 7U);
+  EXPECT_EQ(NetworkProfile::parse(p.toString()).toString(), p.toString());
+
+  EXPECT_ANY_THROW(NetworkProfile::parse("moon"));
+  EXPECT_ANY_THROW(NetworkProfile::parse("latency_ms=-1"));
+  EXPECT_ANY_THROW(NetworkProfile::parse("mtu=1500"));
+}
+
+TEST(NetworkEmulator, Bandwidth) {
+  NetworkProfile profile;
+  profile.latency_ms = 10;
+  // 1 byte per microsecond.
+  profile.bandwidth_mbps = 8;
+  profile.per_message_overhead = 1000;
+  NetworkEmulator emulator(profile, 0);
+
+  const int64_t start = nowNs();
+  const int64_t first = emulator.send(1, 9000);
+  const int64_t second = emulator.send(1, 9000);
+  const int64_t other = emulator.send(2, 9000);
+
+  // 10ms on the wire plus 10ms latency.
+  EXPECT_GE(first - start, 20 * 1000 * 1000);
+  // The second message queues behind the first one on the same link.
+  EXPECT_GE(second - first, 10 * 1000 * 1000);
+  // Other links are independent.
+  EXPECT_LT(other, second);
+}
+
+TEST(NetworkEmulator, JitterKeepsOrder) {
+  NetworkProfile profile;
+  profile.latency_ms = 1;
+  profile.jitter_ms = 50;
+  profile.seed = 42;
+  NetworkEmulator emulator(profile, 1);
+
+  int64_t last = 0;
+  for (int i = 0; i < 100; i++) {
+    const int64_t deadline = emulator.send(0, 1);
+    EXPECT_GE(deadline, last);
+    last = deadline;
+  }
+}
+
+TEST(NetworkEmulator, WaitUntil) {
+  NetworkProfile profile;
+  profile.latency_ms = 20;
+  NetworkEmulator emulator(profile, 0);
+
+  const int64_t start = nowNs();
+  NetworkEmulator::waitUntil(emulator.send(1, 1));
+  EXPECT_GE(nowNs() - start, 20 * 1000 * 1000);
+
+  const int64_t before_delay = nowNs();
+  emulator.delay(1);
+  EXPECT_GE(nowNs() - before_delay, 20 * 1000 * 1000);
+}
+
+TEST(EmulatedNetwork, Scope) {
+  NetworkProfile profile;
+  profile.latency_ms = 20;
+  auto network = std::make_shared<EmulatedNetwork>(profile, 2);
+
+  EXPECT_EQ(EmulatedNetwork::current(), nullptr);
+  {
+    EmulatedNetwork::Scope scope(network);
+    EXPECT_EQ(EmulatedNetwork::current(), network);
+
+    // Deadlines are matched by link, direction and tag.
+    network->send("link", 0, 1, "a", 1);
+    const int64_t start = nowNs();
+    EXPECT_ANY_THROW(network->recv("link", 1, 0, "a"));
+    EXPECT_ANY_THROW(network->recv("link", 0, 1, "b"));
+    network->recv("link", 0, 1, "a");
+    EXPECT_GE(nowNs() - start, 10 * 1000 * 1000);
+  }
+  EXPECT_EQ(EmulatedNetwork::current(), nullptr);
+}
+
+}  // namespace spu::mpc::utils
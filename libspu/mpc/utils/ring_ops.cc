@@ -559,6 +559,24 @@ std::vector<uint8_t> ring_cast_boolean(const NdArrayRef& x) {
   return res;
 }
 
+NdArrayRef ring_cast(const NdArrayRef& x, FieldType to_field) {
+  const auto field = x.eltype().as<Ring2k>()->field();
+  NdArrayRef ret(makeType<RingTy>(to_field), x.shape());
+
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    using from_t = ring2k_t;
+    NdArrayView<from_t> _x(x);
+    DISPATCH_ALL_FIELDS(to_field, [&]() {
+      NdArrayView<ring2k_t> _ret(ret);
+      pforeach(0, x.numel(), [&](int64_t idx) {
+        _ret[idx] = static_cast<ring2k_t>(_x[idx]);
+      });
+    });
+  });
+
+  return ret;
+}
+
 NdArrayRef ring_select(const std::vector<uint8_t>& c, const NdArrayRef& x,
                        const NdArrayRef& y) {
   ENFORCE_EQ_ELSIZE_AND_SHAPE(x, y);
@@ -87,6 +87,10 @@ bool ring_all_equal(const NdArrayRef& x, const NdArrayRef& y,
 // boolean will participate in arithmetic computation in the future.
 std::vector<uint8_t> ring_cast_boolean(const NdArrayRef& x);
 
+// Cast x to another field, keeps the low bits when narrowing and zero-extends
+// when widening.
+NdArrayRef ring_cast(const NdArrayRef& x, FieldType to_field);
+
 // x & bits[low, high)
 NdArrayRef ring_bitmask(const NdArrayRef& x, size_t low, size_t high);
 void ring_bitmask_(NdArrayRef& x, size_t low, size_t high);
@@ -15,10 +15,13 @@
 #pragma once
 
 #include <future>
+#include <memory>
 #include <vector>
 
 #include "yacl/link/test_util.h"
 
+#include "libspu/mpc/utils/network_emulator.h"
+
 namespace spu::mpc::utils {
 
 /// This helper macro simulate a secret function with given number of parties.
@@ -73,4 +76,21 @@ void simulate(size_t npc, Fn&& fn, Args&&... args) {
   }
 }
 
+// Same as above, with the links between the parties emulated by `network`.
+// Only communicators created by `fn` on the party's own thread, and their
+// forks, see the emulation, e.g.
+//   simulate(3, NetworkProfile::parse("wan"), fn);
+template <typename Fn>
+auto simulate(size_t npc, const NetworkProfile& network, Fn&& fn) {
+  std::shared_ptr<EmulatedNetwork> world;
+  if (network.enabled()) {
+    world = std::make_shared<EmulatedNetwork>(network, npc);
+  }
+  return simulate(npc,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    EmulatedNetwork::Scope scope(world);
+                    return fn(lctx);
+                  });
+}
+
 }  // namespace spu::mpc::utils
@@ -14,8 +14,10 @@
 
 
 import os
+import tempfile
 import unittest
 
+import jax.numpy as jnp
 import numpy as np
 import numpy.testing as npt
 
@@ -23,6 +25,26 @@
 import spu.utils.frontend as spu_fe
 
 
+def _compile_sample(copts):
+    def sample(x, y):
+        z = jnp.dot(x, y)
+        return jnp.sort(z, axis=1), jnp.max(z, axis=0), jnp.tanh(z) + x
+
+    x = np.random.rand(4, 4).astype(np.float32)
+    y = np.random.rand(4, 4).astype(np.float32)
+    result, *_ = spu_fe.compile(
+        spu_fe.Kind.JAX,
+        sample,
+        [x, y],
+        dict(),
+        ["x", "y"],
+        [spu_pb2.Visibility.VIS_SECRET, spu_pb2.Visibility.VIS_PUBLIC],
+        lambda outs: [f"out{idx}" for idx in range(len(outs))],
+        copts=copts,
+    )
+    return result.code.decode("utf-8")
+
+
 class UnitTests(unittest.TestCase):
     def test_compile_pb(self):
         def test():
@@ -43,6 +65,34 @@ def test():
         self.assertIn("@main", ir)
         self.assertIn("pphlo", ir)
 
+    def test_compiler_threads(self):
+        single = spu_pb2.CompilerOptions()
+        single.compiler_threads = 1
+        multi = spu_pb2.CompilerOptions()
+        multi.compiler_threads = 4
+
+        # Passes running on a thread pool must not change the output.
+        self.assertEqual(_compile_sample(single), _compile_sample(multi))
+
+    def test_pass_timing(self):
+        copts = spu_pb2.CompilerOptions()
+        copts.enable_pass_timing = True
+
+        # The report goes to the native stderr when compilation ends.
+        with tempfile.TemporaryFile() as f:
+            stderr_fd = os.dup(2)
+            os.dup2(f.fileno(), 2)
+            try:
+                _compile_sample(copts)
+            finally:
+                os.dup2(stderr_fd, 2)
+                os.close(stderr_fd)
+            f.seek(0)
+            report = f.read().decode("utf-8", errors="replace")
+
+        self.assertIn("Execution time report", report)
+        self.assertIn("Canonicalizer", report)
+
 
 if __name__ == '__main__':
     unittest.main()